@@ -0,0 +1,127 @@
+// Compares loading many small assets from loose files against one mapped
+// asset pack. On Linux the page cache is dropped for the files before each
+// run (posix_fadvise) to approximate a cold start; elsewhere runs are warm.
+// Usage: AssetPackBenchmark [assetCount] [assetSizeKB]
+
+#include "AssetPack.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static double MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void DropFromCache(const fs::path& path) {
+#ifdef __linux__
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+// Sums the bytes so neither loader can skip touching the data
+static uint64_t Checksum(const uint8_t* data, size_t size) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+int main(int argc, char** argv) {
+    int assetCount = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int assetSize = (argc > 2 ? std::atoi(argv[2]) : 16) * 1024;
+
+    fs::path root = fs::temp_directory_path() / "9gravity_pack_benchmark";
+    fs::remove_all(root);
+    fs::create_directories(root / "assets" / "textures");
+
+    std::vector<std::string> names;
+    std::vector<uint8_t> data(assetSize);
+    for (int i = 0; i < assetCount; ++i) {
+        for (int b = 0; b < assetSize; ++b) {
+            data[b] = (uint8_t)(i * 31 + b);
+        }
+        std::string name = "assets/textures/sprite_" + std::to_string(i) + ".png";
+        std::ofstream file(root / name, std::ios::binary);
+        file.write((const char*)data.data(), assetSize);
+        names.push_back(name);
+    }
+
+    AssetPackWriter writer;
+    for (const auto& name : names) {
+        writer.AddFile(name, (root / name).string());
+    }
+    fs::path packPath = root / "assets.pak";
+    writer.Write(packPath.string());
+
+    std::cout << assetCount << " assets of " << assetSize / 1024 << " KB" << std::endl;
+    std::cout << "     run   loose (ms)   pack (ms)   speedup" << std::endl;
+
+    for (int run = 0; run < 3; ++run) {
+        for (const auto& name : names) {
+            DropFromCache(root / name);
+        }
+        DropFromCache(packPath);
+
+        // Loose files: open, size and read every asset
+        auto start = Clock::now();
+        uint64_t looseSum = 0;
+        std::vector<uint8_t> buffer;
+        for (const auto& name : names) {
+            std::ifstream file(root / name, std::ios::binary | std::ios::ate);
+            buffer.resize((size_t)file.tellg());
+            file.seekg(0);
+            file.read((char*)buffer.data(), (std::streamsize)buffer.size());
+            looseSum += Checksum(buffer.data(), buffer.size());
+        }
+        double looseMs = MillisecondsSince(start);
+
+        // Pack: one open and map, then lookups and zero-copy spans
+        start = Clock::now();
+        uint64_t packSum = 0;
+        AssetPack pack;
+        pack.Open(packPath.string());
+        for (const auto& name : names) {
+            const AssetPack::Entry* entry = pack.Find(name);
+            if (entry) {
+                AssetPack::Span span = pack.GetData(*entry);
+                packSum += Checksum(span.data, span.size);
+            }
+        }
+        pack.Close();
+        double packMs = MillisecondsSince(start);
+
+        if (looseSum != packSum) {
+            std::cerr << "Checksum mismatch between loose files and pack!" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setw(8) << run
+                  << std::setw(13) << std::fixed << std::setprecision(2) << looseMs
+                  << std::setw(12) << packMs
+                  << std::setw(9) << looseMs / packMs << "x" << std::endl;
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Mixes kMaxVoices looping voices, half mono and half stereo, the way the
+// audio callback does: cost per callback against the audio time it
+// produces, and how often the 16-bit output saturated. With a voice budget
+// below the voice count, the rest play virtual.
+// Usage: AudioMixerBenchmark [voices] [callbackFrames] [voiceBudget]
+
+#include "AudioMixer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int kSampleRate = 48000;
+static const int kCallbacks = 2000;
+
+// One second of a sine at the given pitch
+static std::shared_ptr<AudioBuffer> MakeTone(float hz, int channels) {
+    auto buffer = std::make_shared<AudioBuffer>();
+    buffer->channels = channels;
+    buffer->frames = kSampleRate;
+    buffer->samples.resize((size_t)buffer->frames * channels);
+    for (int i = 0; i < buffer->frames; ++i) {
+        float value = 0.5f * std::sin(6.2831853f * hz * i / kSampleRate);
+        for (int c = 0; c < channels; ++c) {
+            buffer->samples[(size_t)i * channels + c] = value;
+        }
+    }
+    return buffer;
+}
+
+int main(int argc, char** argv) {
+    int voices = argc > 1 ? std::atoi(argv[1]) : AudioMixer::kMaxVoices;
+    int callbackFrames = argc > 2 ? std::atoi(argv[2]) : 1024;
+    int voiceBudget = argc > 3 ? std::atoi(argv[3]) : AudioMixer::kMaxVoices;
+
+#if defined(__AVX__)
+    const char* isa = "AVX";
+#elif defined(__SSE2__) || defined(_M_X64)
+    const char* isa = "SSE2";
+#else
+    const char* isa = "scalar";
+#endif
+
+    AudioMixer mixer(kSampleRate);
+    mixer.SetVoiceBudget(voiceBudget);
+    std::vector<std::shared_ptr<AudioBuffer>> tones;
+    for (int i = 0; i < 16; ++i) {
+        tones.push_back(MakeTone(110.0f * (i + 1), i % 2 == 0 ? 1 : 2));
+    }
+
+    // Quiet enough per voice that a full mix mostly stays in range. Spread
+    // over a few priorities so the budget has something to choose on.
+    std::vector<AudioMixer::VoiceId> ids;
+    for (int i = 0; i < voices; ++i) {
+        float pan = (i % 9) / 4.0f - 1.0f;
+        ids.push_back(mixer.Play(tones[i % tones.size()], AudioMixer::SoundBus, 4.0f / voices, pan, -1,
+                                 AudioMixer::kDefaultPriority + i % 4));
+    }
+
+    std::vector<int16_t> output((size_t)callbackFrames * 2);
+    size_t saturated = 0;
+    double worstMs = 0.0;
+    auto start = Clock::now();
+    for (int call = 0; call < kCallbacks; ++call) {
+        // A volume change per callback, as a game would send
+        mixer.SetVolume(ids[call % ids.size()], (call % 7 + 1) / (2.0f * voices));
+
+        auto callStart = Clock::now();
+        mixer.Mix(output.data(), callbackFrames);
+        worstMs = std::max(worstMs, std::chrono::duration<double, std::milli>(Clock::now() - callStart).count());
+
+        for (int16_t sample : output) {
+            saturated += sample == 32767 || sample == -32768;
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    mixer.Update();
+
+    AudioMixer::Stats stats = mixer.GetStats();
+    double budgetMs = callbackFrames * 1000.0 / kSampleRate;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << stats.mixedVoices << " voices mixed, " << stats.virtualVoices << " virtual, " << callbackFrames
+              << " frames per callback at " << kSampleRate << " Hz, kernel: " << isa << std::endl;
+    std::cout << "Mix per callback: " << stats.averageMixMs << " ms avg, " << worstMs << " ms worst, budget "
+              << budgetMs << " ms (" << std::setprecision(1) << stats.load * 100.0 << "% load)" << std::endl;
+    std::cout << "Throughput:       " << std::setprecision(1)
+              << (double)stats.framesMixed * stats.mixedVoices / (ms / 1000.0) / 1e6 << " M voice-frames/s, "
+              << saturated << " saturated samples, " << stats.droppedCommands << " dropped commands" << std::endl;
+    return 0;
+}
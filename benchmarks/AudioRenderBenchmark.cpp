@@ -0,0 +1,117 @@
+// Renders the mix offline, as fast as it goes, across voice counts, output
+// sample rates and pitch ratios (1 mixes straight from the buffer, others
+// go through the interpolating path). Reports voice samples mixed per
+// second and how many times faster than real time the mix runs. With a
+// path, one 64-voice mix of mixed pitches is also written as a WAV file.
+// Usage: AudioRenderBenchmark [seconds] [output.wav]
+
+#include "AudioMixer.h"
+#include "WavWriter.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int kRenderFrames = 1024;
+
+// One second of a sine at the given pitch, with a few harmonics
+static std::shared_ptr<AudioBuffer> MakeTone(float hz, int channels, int sampleRate) {
+    auto buffer = std::make_shared<AudioBuffer>();
+    buffer->channels = channels;
+    buffer->frames = sampleRate;
+    buffer->samples.resize((size_t)buffer->frames * channels);
+    for (int i = 0; i < buffer->frames; ++i) {
+        float t = 6.2831853f * hz * i / sampleRate;
+        float value = 0.4f * std::sin(t) + 0.1f * std::sin(2.0f * t) + 0.05f * std::sin(3.0f * t);
+        for (int c = 0; c < channels; ++c) {
+            buffer->samples[(size_t)i * channels + c] = value;
+        }
+    }
+    return buffer;
+}
+
+// Looping voices, half mono and half stereo; pitch 0 spreads the voices
+// over 0.5-2
+static void StartVoices(AudioMixer& mixer, const std::vector<std::shared_ptr<AudioBuffer>>& tones, int voices,
+                        float pitch) {
+    for (int i = 0; i < voices; ++i) {
+        float pan = (i % 9) / 4.0f - 1.0f;
+        AudioMixer::VoiceId voice = mixer.Play(tones[i % tones.size()], AudioMixer::SoundBus, 4.0f / voices, pan, -1);
+        mixer.SetPitch(voice, pitch > 0.0f ? pitch : std::pow(2.0f, (i % 25) / 12.0f - 1.0f));
+    }
+}
+
+static double Render(int voices, int sampleRate, float pitch, double seconds) {
+    std::vector<std::shared_ptr<AudioBuffer>> tones;
+    for (int i = 0; i < 16; ++i) {
+        tones.push_back(MakeTone(110.0f * (i + 1), i % 2 == 0 ? 1 : 2, sampleRate));
+    }
+    AudioMixer mixer(sampleRate);
+    StartVoices(mixer, tones, voices, pitch);
+
+    std::vector<int16_t> output((size_t)kRenderFrames * 2);
+    int frames = (int)(seconds * sampleRate);
+    auto start = Clock::now();
+    for (int done = 0; done < frames; done += kRenderFrames) {
+        mixer.Mix(output.data(), kRenderFrames);
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+    const char* path = argc > 2 ? argv[2] : nullptr;
+
+#if defined(__AVX__)
+    const char* isa = "AVX";
+#elif defined(__SSE2__) || defined(_M_X64)
+    const char* isa = "SSE2";
+#else
+    const char* isa = "scalar";
+#endif
+
+    const int voiceCounts[] = { 16, 64, 256 };
+    const int sampleRates[] = { 22050, 48000, 96000 };
+    const float pitches[] = { 1.0f, 0.75f, 1.5f, 2.0f };
+
+    std::cout << seconds << " s of audio per run, kernel: " << isa << std::endl;
+    std::cout << "voices    rate  pitch   M voice-samples/s   x real time" << std::endl;
+    std::cout << std::fixed;
+    for (int voices : voiceCounts) {
+        for (int sampleRate : sampleRates) {
+            for (float pitch : pitches) {
+                double elapsed = Render(voices, sampleRate, pitch, seconds);
+                double samples = seconds * sampleRate * voices;
+                std::cout << std::setw(6) << voices << std::setw(8) << sampleRate << std::setprecision(2)
+                          << std::setw(7) << pitch << std::setprecision(1) << std::setw(20)
+                          << samples / elapsed / 1e6 << std::setw(14) << seconds / elapsed << std::endl;
+            }
+        }
+    }
+
+    if (path) {
+        const int sampleRate = 48000;
+        std::vector<std::shared_ptr<AudioBuffer>> tones;
+        for (int i = 0; i < 16; ++i) {
+            tones.push_back(MakeTone(110.0f * (i + 1), i % 2 == 0 ? 1 : 2, sampleRate));
+        }
+        AudioMixer mixer(sampleRate);
+        StartVoices(mixer, tones, 64, 0.0f);
+
+        WavWriter writer;
+        if (!writer.Open(path, 2, sampleRate)) return 1;
+        std::vector<int16_t> output((size_t)kRenderFrames * 2);
+        for (int done = 0; done < (int)(seconds * sampleRate); done += kRenderFrames) {
+            mixer.Mix(output.data(), kRenderFrames);
+            writer.Write(output.data(), kRenderFrames);
+        }
+        if (!writer.Close()) return 1;
+        std::cout << "Wrote " << writer.GetFrames() << " frames of 64 voices to " << path << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Compares the SpatialHash broadphase against the brute-force pair loop.
+// Usage: BroadphaseBenchmark [maxBodies]
+
+#include "Broadphase.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static size_t BruteForcePairs(const std::vector<Physics::AABB>& boxes) {
+    size_t pairs = 0;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        for (size_t j = i + 1; j < boxes.size(); ++j) {
+            if (Physics::CheckCollision(boxes[i], boxes[j])) {
+                pairs++;
+            }
+        }
+    }
+    return pairs;
+}
+
+static void RunBenchmark(int bodyCount) {
+    std::mt19937 rng(1234);
+    // Keep density constant so pair counts scale linearly with body count
+    float worldSize = std::sqrt((float)bodyCount) * 40.0f;
+    std::uniform_real_distribution<float> posDist(0.0f, worldSize);
+    std::uniform_real_distribution<float> sizeDist(4.0f, 16.0f);
+    std::uniform_real_distribution<float> velDist(-60.0f, 60.0f);
+
+    std::vector<Physics::Body> bodies(bodyCount);
+    std::vector<Vector2> sizes(bodyCount);
+    std::vector<Physics::AABB> boxes(bodyCount);
+    for (int i = 0; i < bodyCount; ++i) {
+        bodies[i].position = Vector2(posDist(rng), posDist(rng));
+        bodies[i].velocity = Vector2(velDist(rng), velDist(rng));
+        sizes[i] = Vector2(sizeDist(rng), sizeDist(rng));
+        boxes[i] = Physics::AABB(bodies[i].position, sizes[i].x, sizes[i].y);
+    }
+
+    SpatialHash hash(32.0f);
+
+    auto start = Clock::now();
+    hash.Update(boxes);
+    size_t hashPairs = hash.FindPairs().size();
+    double buildMs = MillisecondsSince(start);
+
+    // Simulate frames: move every body, then re-sync and query
+    const int frames = 10;
+    double frameMs = 0.0;
+    int reinserts = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int i = 0; i < bodyCount; ++i) {
+            Physics::UpdateBody(bodies[i], 1.0f / 60.0f);
+            boxes[i] = Physics::AABB(bodies[i].position, sizes[i].x, sizes[i].y);
+        }
+
+        start = Clock::now();
+        hash.Update(boxes);
+        reinserts += hash.GetReinsertCount();
+        hashPairs = hash.FindPairs().size();
+        frameMs += MillisecondsSince(start);
+    }
+    frameMs /= frames;
+
+    start = Clock::now();
+    size_t brutePairs = BruteForcePairs(boxes);
+    double bruteMs = MillisecondsSince(start);
+
+    std::cout << std::setw(8) << bodyCount
+              << std::setw(12) << hashPairs
+              << std::setw(14) << std::fixed << std::setprecision(3) << buildMs
+              << std::setw(14) << frameMs
+              << std::setw(12) << reinserts / frames
+              << std::setw(14) << bruteMs
+              << std::setw(10) << std::setprecision(1) << bruteMs / frameMs << "x"
+              << (hashPairs == brutePairs ? "" : "  PAIR COUNT MISMATCH")
+              << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int maxBodies = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    std::cout << "  bodies       pairs    build (ms)    frame (ms)  reinserts    brute (ms)   speedup" << std::endl;
+    for (int count = 1000; count <= maxBodies; count *= 10) {
+        RunBenchmark(count);
+    }
+    return 0;
+}
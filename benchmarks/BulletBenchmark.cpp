@@ -0,0 +1,137 @@
+// Fast bullets fired at a fence of thin posts while box stacks rest on the
+// ground. Compares ContactSolver with plain steps, with every step split
+// into substeps, and with the bullets flagged isBullet: cost per step, and
+// how many bullets ended up on the wrong side of the fence compared with
+// their exact straight-line paths.
+// Usage: BulletBenchmark [bullets (at most one per post)] [stacks]
+
+#include "ContactSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const float kBoxSize = 16.0f;
+static const float kBulletSize = 4.0f;
+static const float kPostWidth = 4.0f;
+static const float kPostHeight = 12.0f;
+static const float kPostGap = 12.0f;
+static const int kPosts = 200;
+static const float kFenceX = 2000.0f;
+static const Vector2 kGravity(0.0f, 500.0f);
+static const float kDeltaTime = 1.0f / 60.0f;
+static const int kSteps = 60;
+
+struct Scene {
+    std::vector<Physics::Body> bodies;
+    int firstBullet;
+    std::vector<bool> shouldPass; // Straight path clears every post
+};
+
+// Ground is body 0, then the posts, the stacks and the bullets. Each bullet
+// flies in its own lane, one post high, well above the stacks, at a slight
+// angle so some graze a post corner.
+static Scene BuildScene(int bullets, int stacks, bool flagBullets) {
+    Scene scene;
+    std::vector<Physics::Body>& bodies = scene.bodies;
+
+    Physics::Body ground;
+    ground.isStatic = true;
+    ground.size = Vector2(stacks * kBoxSize * 2.0f + 100.0f, kBoxSize);
+    ground.position = Vector2(ground.size.x / 2.0f - 50.0f, kBoxSize / 2.0f);
+    bodies.push_back(ground);
+
+    float fenceTop = -1000.0f - kPosts * (kPostHeight + kPostGap);
+    for (int p = 0; p < kPosts; ++p) {
+        Physics::Body post;
+        post.isStatic = true;
+        post.size = Vector2(kPostWidth, kPostHeight);
+        post.position = Vector2(kFenceX, fenceTop + p * (kPostHeight + kPostGap));
+        bodies.push_back(post);
+    }
+
+    for (int s = 0; s < stacks; ++s) {
+        for (int level = 0; level < 8; ++level) {
+            Physics::Body box;
+            box.size = Vector2(kBoxSize, kBoxSize);
+            box.position = Vector2(s * kBoxSize * 2.0f, -kBoxSize / 2.0f - level * kBoxSize);
+            box.restitution = 0.0f;
+            bodies.push_back(box);
+        }
+    }
+
+    scene.firstBullet = (int)bodies.size();
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> offset(0.0f, kPostHeight + kPostGap);
+    std::uniform_real_distribution<float> speed(15000.0f, 40000.0f);
+    std::uniform_real_distribution<float> slope(-0.003f, 0.003f);
+    for (int i = 0; i < bullets; ++i) {
+        Physics::Body bullet;
+        bullet.size = Vector2(kBulletSize, kBulletSize);
+        bullet.position = Vector2(kFenceX - 1500.0f, fenceTop + (i % kPosts) * (kPostHeight + kPostGap) + offset(rng));
+        float vx = speed(rng);
+        bullet.velocity = Vector2(vx, vx * slope(rng));
+        bullet.mass = 0.1f;
+        bullet.isBullet = flagBullets;
+        bodies.push_back(bullet);
+
+        // Far enough to be well past the fence by the last step
+        Vector2 path = bullet.velocity * (kSteps * kDeltaTime);
+        bool blocked = false;
+        for (int p = 1; p <= kPosts && !blocked; ++p) {
+            float time;
+            Vector2 normal;
+            blocked = Physics::SweepAABB(bullet.GetBounds(), path, bodies[p].GetBounds(), time, normal);
+        }
+        scene.shouldPass.push_back(!blocked);
+    }
+    return scene;
+}
+
+static void Run(const char* label, int bullets, int stacks, bool flagBullets, int substeps) {
+    Scene scene = BuildScene(bullets, stacks, flagBullets);
+    std::vector<Physics::Body>& bodies = scene.bodies;
+    ContactSolver solver;
+    solver.SetSleepingEnabled(false); // Stacks stay in the solve, as busy scenes do
+
+    size_t swept = 0;
+    auto start = Clock::now();
+    for (int step = 0; step < kSteps; ++step) {
+        for (int sub = 0; sub < substeps; ++sub) {
+            // Bullets fly straight, so their exact paths are known up front
+            for (size_t i = scene.firstBullet; i < bodies.size(); ++i) {
+                bodies[i].acceleration = Vector2(-kGravity.x, -kGravity.y);
+            }
+            solver.Step(bodies, kDeltaTime / substeps, kGravity);
+            swept += solver.GetStepStats().bulletsSwept;
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    int wrong = 0;
+    for (int i = 0; i < bullets; ++i) {
+        bool passed = bodies[scene.firstBullet + i].position.x > kFenceX;
+        wrong += passed != scene.shouldPass[i];
+    }
+    std::cout << label << std::fixed << std::setprecision(3) << std::setw(8) << ms / kSteps << " ms/step, "
+              << std::setw(4) << wrong << " bullets on the wrong side, " << std::setw(6) << swept << " sweeps"
+              << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int bullets = argc > 1 ? std::min(std::atoi(argv[1]), kPosts) : kPosts; // One per lane
+    int stacks = argc > 2 ? std::atoi(argv[2]) : 250;
+
+    std::cout << bullets << " bullets at 15000-40000 px/s, " << kPosts << " posts, " << stacks
+              << " stacks of 8 boxes, " << kSteps << " steps at 60 Hz" << std::endl;
+    Run("Plain steps:          ", bullets, stacks, false, 1);
+    Run("4 substeps per step:  ", bullets, stacks, false, 4);
+    Run("16 substeps per step: ", bullets, stacks, false, 16);
+    Run("Bullets swept:        ", bullets, stacks, true, 1);
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Box stacks resting on the ground under gravity. Compares ContactSolver
+// with and without warm starting, and cold solving with substeps: cost per
+// step, how far the top boxes sank, and the fastest body still moving after
+// the stacks should have settled.
+// Usage: ContactSolverBenchmark [stacks] [stackHeight]
+
+#include "ContactSolver.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const float kBoxSize = 20.0f;
+static const float kGroundY = 0.0f;
+static const Vector2 kGravity(0.0f, 500.0f);
+static const float kDeltaTime = 1.0f / 60.0f;
+static const int kSteps = 600;
+
+struct RunResult {
+    double msPerStep;
+    float topSink;  // How far the top boxes sank below their resting height
+    float maxSpeed; // Fastest body after the last step
+};
+
+// Ground is body 0; every stack is a column of boxes standing on it, y down
+static std::vector<Physics::Body> BuildStacks(int stacks, int height) {
+    std::vector<Physics::Body> bodies;
+
+    Physics::Body ground;
+    ground.isStatic = true;
+    ground.restitution = 0.0f;
+    ground.size = Vector2(stacks * kBoxSize * 2.0f + 100.0f, kBoxSize);
+    ground.position = Vector2(ground.size.x / 2.0f - 50.0f, kGroundY + kBoxSize / 2.0f);
+    bodies.push_back(ground);
+
+    for (int s = 0; s < stacks; ++s) {
+        for (int level = 0; level < height; ++level) {
+            Physics::Body box;
+            box.size = Vector2(kBoxSize, kBoxSize);
+            box.position = Vector2(s * kBoxSize * 2.0f, kGroundY - kBoxSize / 2.0f - level * kBoxSize);
+            box.restitution = 0.0f;
+            bodies.push_back(box);
+        }
+    }
+    return bodies;
+}
+
+static RunResult Measure(const std::vector<Physics::Body>& bodies, int stacks, int height, double ms) {
+    RunResult result = { ms / kSteps, 0.0f, 0.0f };
+    float restingY = kGroundY - kBoxSize / 2.0f - (height - 1) * kBoxSize;
+    for (int s = 0; s < stacks; ++s) {
+        const Physics::Body& top = bodies[1 + s * height + height - 1];
+        result.topSink = std::max(result.topSink, top.position.y - restingY);
+    }
+    for (const Physics::Body& body : bodies) {
+        float speed = std::sqrt(body.velocity.x * body.velocity.x + body.velocity.y * body.velocity.y);
+        result.maxSpeed = std::max(result.maxSpeed, speed);
+    }
+    return result;
+}
+
+static RunResult RunSolver(int stacks, int height, int iterations, bool warmStarting, int substeps = 1) {
+    std::vector<Physics::Body> bodies = BuildStacks(stacks, height);
+    ContactSolver solver;
+    solver.SetIterations(iterations);
+    solver.SetWarmStarting(warmStarting);
+    solver.SetSleepingEnabled(false); // Measure the solve, not resting stacks skipping it
+
+    auto start = Clock::now();
+    for (int step = 0; step < kSteps; ++step) {
+        for (int sub = 0; sub < substeps; ++sub) {
+            solver.Step(bodies, kDeltaTime / substeps, kGravity);
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return Measure(bodies, stacks, height, ms);
+}
+
+static void Print(const char* label, const RunResult& result) {
+    std::cout << label << std::fixed << std::setprecision(3) << std::setw(8) << result.msPerStep << " ms/step, top sank "
+              << std::setprecision(1) << std::setw(7) << result.topSink << " px, max speed "
+              << std::setw(7) << result.maxSpeed << " px/s" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int stacks = argc > 1 ? std::atoi(argv[1]) : 100;
+    int height = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    std::cout << stacks << " stacks of " << height << " boxes, " << kSteps << " steps at 60 Hz" << std::endl;
+    Print("Cold, 4 iterations:              ", RunSolver(stacks, height, 4, false));
+    Print("Cold, 16 iterations:             ", RunSolver(stacks, height, 16, false));
+    Print("Cold, 4 iterations x 4 substeps: ", RunSolver(stacks, height, 4, false, 4));
+    Print("Warm, 4 iterations:              ", RunSolver(stacks, height, 4, true));
+    Print("Warm, 8 iterations:              ", RunSolver(stacks, height, 8, true));
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Query latency of DynamicAABBTree against a linear scan, plus a moving
+// broadphase frame against SpatialHash.
+// Usage: DynamicAABBTreeBenchmark [boxCount]
+
+#include "DynamicAABBTree.h"
+#include "Broadphase.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double MicrosecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int queries = 1000;
+
+    std::mt19937 rng(1234);
+    float worldSize = std::sqrt((float)count) * 40.0f;
+    std::uniform_real_distribution<float> posDist(0.0f, worldSize);
+    std::uniform_real_distribution<float> sizeDist(4.0f, 16.0f);
+    std::uniform_real_distribution<float> velDist(-1.0f, 1.0f);
+
+    std::vector<Physics::AABB> boxes(count);
+    std::vector<Vector2> velocities(count);
+    for (int i = 0; i < count; ++i) {
+        boxes[i] = Physics::AABB(Vector2(posDist(rng), posDist(rng)), sizeDist(rng), sizeDist(rng));
+        velocities[i] = Vector2(velDist(rng), velDist(rng));
+    }
+
+    DynamicAABBTree tree;
+    auto start = Clock::now();
+    for (int i = 0; i < count; ++i) {
+        tree.AddProxy(boxes[i]);
+    }
+    double buildMs = MicrosecondsSince(start) / 1000.0;
+
+    std::vector<Vector2> points(queries);
+    std::vector<Physics::AABB> rects(queries);
+    std::vector<Vector2> rayEnds(queries);
+    for (int q = 0; q < queries; ++q) {
+        points[q] = Vector2(posDist(rng), posDist(rng));
+        rects[q] = Physics::AABB(points[q], 200.0f, 200.0f);
+        rayEnds[q] = points[q] + Vector2(velDist(rng), velDist(rng)) * 500.0f;
+    }
+
+    std::vector<int> hits;
+    size_t treeHits = 0, scanHits = 0;
+
+    start = Clock::now();
+    for (int q = 0; q < queries; ++q) {
+        hits.clear();
+        tree.QueryPoint(points[q], hits);
+        treeHits += hits.size();
+    }
+    double pointUs = MicrosecondsSince(start) / queries;
+
+    start = Clock::now();
+    for (int q = 0; q < queries; ++q) {
+        const Vector2& p = points[q];
+        for (const Physics::AABB& box : boxes) {
+            if (p.x >= box.min.x && p.x <= box.max.x && p.y >= box.min.y && p.y <= box.max.y) {
+                scanHits++;
+            }
+        }
+    }
+    double scanPointUs = MicrosecondsSince(start) / queries;
+
+    start = Clock::now();
+    size_t rectHits = 0;
+    for (int q = 0; q < queries; ++q) {
+        hits.clear();
+        tree.QueryRect(rects[q], hits);
+        rectHits += hits.size();
+    }
+    double rectUs = MicrosecondsSince(start) / queries;
+
+    start = Clock::now();
+    int rayHits = 0;
+    for (int q = 0; q < queries; ++q) {
+        DynamicAABBTree::RayHit hit;
+        rayHits += tree.RayCast(points[q], rayEnds[q], hit) ? 1 : 0;
+    }
+    double rayUs = MicrosecondsSince(start) / queries;
+
+    // Broadphase frames with every box drifting
+    SpatialHash hash(32.0f);
+    hash.Update(boxes);
+    hash.FindPairs();
+    DynamicAABBTree broadphase;
+    broadphase.Update(boxes);
+    broadphase.FindPairs();
+
+    const int frames = 10;
+    double hashMs = 0.0, treeMs = 0.0;
+    size_t hashPairs = 0, treePairs = 0;
+    int treeReinserts = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int i = 0; i < count; ++i) {
+            boxes[i].min = boxes[i].min + velocities[i];
+            boxes[i].max = boxes[i].max + velocities[i];
+        }
+
+        start = Clock::now();
+        hash.Update(boxes);
+        hashPairs = hash.FindPairs().size();
+        hashMs += MicrosecondsSince(start) / 1000.0;
+
+        start = Clock::now();
+        broadphase.Update(boxes);
+        treeReinserts += broadphase.GetReinsertCount();
+        treePairs = broadphase.FindPairs().size();
+        treeMs += MicrosecondsSince(start) / 1000.0;
+    }
+
+    std::cout << count << " boxes, " << queries << " queries each" << std::endl
+              << std::fixed << std::setprecision(3)
+              << "Build (insert one by one): " << std::setw(9) << buildMs << " ms, height " << tree.GetHeight()
+              << ", area ratio " << std::setprecision(1) << tree.GetAreaRatio() << std::endl
+              << std::setprecision(3)
+              << "Point query:               " << std::setw(9) << pointUs << " us (linear scan "
+              << scanPointUs << " us)" << (treeHits == scanHits ? "" : "  HIT COUNT MISMATCH") << std::endl
+              << "Rect query (200x200):      " << std::setw(9) << rectUs << " us (" << rectHits / queries << " hits avg)" << std::endl
+              << "Ray cast (closest):        " << std::setw(9) << rayUs << " us (" << rayHits << " hits)" << std::endl
+              << "Broadphase frame, tree:    " << std::setw(9) << treeMs / frames << " ms (" << treePairs << " pairs, "
+              << treeReinserts / frames << " reinserts)" << std::endl
+              << "Broadphase frame, hash:    " << std::setw(9) << hashMs / frames << " ms (" << hashPairs << " pairs)"
+              << (hashPairs == treePairs ? "" : "  PAIR COUNT MISMATCH") << std::endl;
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Updates the same movement logic for N objects through Scene/GameObject
+// (virtual Update on shared_ptrs) and through World queries over archetype
+// chunks, serially and on the job system.
+// Usage: ECSBenchmark [entityCount]
+
+#include "Scene.h"
+#include "ECS.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using Clock = std::chrono::steady_clock;
+
+static double MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct SpinComponent {
+    float speed;
+};
+
+class MovingObject : public GameObject {
+public:
+    float spin;
+
+    void Update(float deltaTime) override {
+        position = position + velocity * deltaTime;
+        rotation += spin * deltaTime;
+    }
+};
+
+class BenchmarkScene : public Scene {
+public:
+    size_t GetObjectCount() const { return m_gameObjects.size(); }
+};
+
+template<typename F>
+static double Best(int runs, F&& function) {
+    double best = 1e9;
+    for (int run = 0; run < runs; ++run) {
+        auto start = Clock::now();
+        function();
+        best = std::min(best, MillisecondsSince(start));
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const float dt = 1.0f / 60.0f;
+    const int runs = 20;
+
+    BenchmarkScene scene;
+    World world;
+    JobSystem jobs;
+
+    for (int i = 0; i < count; ++i) {
+        auto object = std::make_shared<MovingObject>();
+        object->position = Vector2((float)(i % 1000), (float)(i / 1000));
+        object->velocity = Vector2(1.0f + (i % 7), 2.0f - (i % 5));
+        object->spin = 0.5f + (i % 3);
+        scene.AddGameObject(object);
+
+        SpinComponent spin = { object->spin };
+        world.CreateEntity(object->GetTransform(), spin);
+    }
+
+    auto moveSystem = [dt](TransformComponent& transform, SpinComponent& spin) {
+        transform.position = transform.position + transform.velocity * dt;
+        transform.rotation += spin.speed * dt;
+    };
+
+    double objectMs = Best(runs, [&]() { scene.Update(dt); });
+    double ecsMs = Best(runs, [&]() { world.Each<TransformComponent, SpinComponent>(moveSystem); });
+
+    world.SetJobSystem(&jobs);
+    double parallelMs = Best(runs, [&]() { world.ParallelEach<TransformComponent, SpinComponent>(moveSystem); });
+
+    std::cout << count << " objects, best of " << runs << " updates" << std::endl
+              << std::fixed << std::setprecision(3)
+              << "Scene/GameObject:      " << std::setw(8) << objectMs << " ms" << std::endl
+              << "World::Each:           " << std::setw(8) << ecsMs << " ms ("
+              << std::setprecision(1) << objectMs / ecsMs << "x)" << std::endl
+              << std::setprecision(3)
+              << "World::ParallelEach:   " << std::setw(8) << parallelMs << " ms ("
+              << std::setprecision(1) << objectMs / parallelMs << "x, "
+              << jobs.GetThreadCount() << " threads)" << std::endl;
+    std::cout << "Archetypes: " << world.GetArchetypeCount() << ", entities: " << world.GetEntityCount()
+              << ", scene objects: " << scene.GetObjectCount() << std::endl;
+    return 0;
+}
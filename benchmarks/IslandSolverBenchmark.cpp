@@ -0,0 +1,101 @@
+// Thousands of separate box stacks on one ground, each its own island.
+// Steps ContactSolver serially and with a JobSystem of increasing size:
+// cost per step, speedup, and whether every body ended up bit for bit where
+// the serial run put it.
+// Usage: IslandSolverBenchmark [stacks] [maxHeight] [maxThreads]
+
+#include "ContactSolver.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const float kBoxSize = 16.0f;
+static const Vector2 kGravity(0.0f, 500.0f);
+static const float kDeltaTime = 1.0f / 60.0f;
+static const int kSteps = 300;
+
+// Ground is body 0. Stack heights cycle from 1 to maxHeight, so island
+// sizes vary the way they do in a real scene.
+static std::vector<Physics::Body> BuildStacks(int stacks, int maxHeight) {
+    std::vector<Physics::Body> bodies;
+
+    Physics::Body ground;
+    ground.isStatic = true;
+    ground.size = Vector2(stacks * kBoxSize * 2.0f + 100.0f, kBoxSize);
+    ground.position = Vector2(ground.size.x / 2.0f - 50.0f, kBoxSize / 2.0f);
+    bodies.push_back(ground);
+
+    for (int s = 0; s < stacks; ++s) {
+        int height = 1 + (s * 7) % maxHeight;
+        for (int level = 0; level < height; ++level) {
+            Physics::Body box;
+            box.size = Vector2(kBoxSize, kBoxSize);
+            box.position = Vector2(s * kBoxSize * 2.0f, -kBoxSize / 2.0f - level * (kBoxSize + 1.0f));
+            box.restitution = 0.0f;
+            bodies.push_back(box);
+        }
+    }
+    return bodies;
+}
+
+static double Run(std::vector<Physics::Body>& bodies, JobSystem* jobs, ContactSolver::StepStats& stats) {
+    ContactSolver solver;
+    solver.SetSleepingEnabled(false); // Keep every island in the solve
+
+    auto start = Clock::now();
+    for (int step = 0; step < kSteps; ++step) {
+        solver.Step(bodies, kDeltaTime, kGravity, jobs);
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    stats = solver.GetStepStats();
+    return ms / kSteps;
+}
+
+static bool SameState(const std::vector<Physics::Body>& a, const std::vector<Physics::Body>& b) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::memcmp(&a[i].position, &b[i].position, sizeof(Vector2)) != 0 ||
+            std::memcmp(&a[i].velocity, &b[i].velocity, sizeof(Vector2)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int stacks = argc > 1 ? std::atoi(argv[1]) : 4000;
+    int maxHeight = argc > 2 ? std::atoi(argv[2]) : 12;
+    int maxThreads = argc > 3 ? std::atoi(argv[3]) : std::max(2, (int)std::thread::hardware_concurrency());
+
+    std::vector<Physics::Body> serial = BuildStacks(stacks, maxHeight);
+    ContactSolver::StepStats stats;
+    double serialMs = Run(serial, nullptr, stats);
+
+    std::cout << stacks << " stacks, " << serial.size() - 1 << " boxes, " << stats.islands << " islands (largest "
+              << stats.largestIsland << "), " << stats.contactsSolved << " contacts, " << kSteps << " steps"
+              << std::endl;
+    std::cout << "Serial:     " << std::fixed << std::setprecision(3) << std::setw(8) << serialMs << " ms/step"
+              << std::endl;
+
+    // Powers of two, then the maximum itself
+    for (int threads = 2; threads <= maxThreads; threads *= 2) {
+        if (threads * 2 > maxThreads && threads < maxThreads) {
+            threads = maxThreads;
+        }
+        JobSystem jobs(threads - 1);
+        std::vector<Physics::Body> bodies = BuildStacks(stacks, maxHeight);
+        double ms = Run(bodies, &jobs, stats);
+
+        std::cout << std::setw(2) << threads << " threads: " << std::setprecision(3) << std::setw(8) << ms
+                  << " ms/step, " << std::setprecision(2) << serialMs / ms << "x, "
+                  << (SameState(serial, bodies) ? "identical" : "DIFFERENT") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Measures JobSystem scheduling overhead per job and ParallelFor scaling
+// from 1 thread up to every hardware thread.
+// Usage: JobSystemBenchmark [maxThreads]
+
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void MeasureOverhead(JobSystem& jobs) {
+    const int jobCount = 200000;
+    std::atomic<int> executed(0);
+
+    auto start = Clock::now();
+    JobCounter counter;
+    for (int i = 0; i < jobCount; ++i) {
+        jobs.Schedule([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); }, &counter);
+    }
+    jobs.Wait(counter);
+    double scheduleMs = MillisecondsSince(start);
+
+    // Dependency chains: each job waits on the previous counter
+    const int chainLength = 20000;
+    std::vector<std::unique_ptr<JobCounter>> chain;
+    for (int i = 0; i < chainLength; ++i) {
+        chain.push_back(std::make_unique<JobCounter>());
+    }
+    start = Clock::now();
+    for (int i = 0; i < chainLength; ++i) {
+        jobs.Schedule([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); },
+                      chain[i].get(), i > 0 ? chain[i - 1].get() : nullptr);
+    }
+    jobs.Wait(*chain.back());
+    double chainMs = MillisecondsSince(start);
+    for (auto& counter : chain) {
+        jobs.Wait(*counter);
+    }
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "Empty jobs:      " << jobCount << " in " << scheduleMs << " ms, "
+              << scheduleMs * 1e6 / jobCount << " ns/job" << std::endl
+              << "Dependent chain: " << chainLength << " in " << chainMs << " ms, "
+              << chainMs * 1e6 / chainLength << " ns/job" << std::endl;
+}
+
+static double RunWorkload(JobSystem& jobs, std::vector<float>& data) {
+    auto start = Clock::now();
+    jobs.ParallelFor(data.size(), 4096, [&data](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            float v = data[i];
+            for (int k = 0; k < 32; ++k) {
+                v = std::sin(v) * 0.5f + std::cos(v) * 0.5f;
+            }
+            data[i] = v;
+        }
+    });
+    return MillisecondsSince(start);
+}
+
+int main(int argc, char** argv) {
+    int hardwareThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : hardwareThreads;
+
+    {
+        JobSystem jobs;
+        std::cout << "Scheduling overhead (" << jobs.GetThreadCount() << " threads)" << std::endl;
+        MeasureOverhead(jobs);
+    }
+
+    std::cout << std::endl << "ParallelFor scaling (1M elements, grain 4096)" << std::endl;
+    std::cout << " threads   time (ms)   speedup" << std::endl;
+
+    std::vector<float> data(1 << 20);
+    double baseline = 0.0;
+    for (int threads = 1; threads <= maxThreads; ++threads) {
+        JobSystem jobs(threads - 1);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = (float)i * 0.001f;
+        }
+
+        RunWorkload(jobs, data); // warm-up
+        double best = 1e9;
+        for (int run = 0; run < 5; ++run) {
+            best = std::min(best, RunWorkload(jobs, data));
+        }
+        if (threads == 1) baseline = best;
+
+        std::cout << std::setw(8) << threads
+                  << std::setw(12) << std::fixed << std::setprecision(3) << best
+                  << std::setw(9) << std::setprecision(2) << baseline / best << "x" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Streams long WAV tracks (16-bit stereo at 44.1 kHz, so every play is
+// also resampled to 48 kHz) through AudioMixer, calling Mix the way the
+// audio callback does but speedup times faster than real time. Reports
+// underruns, reader throughput and resident memory per track against
+// decoding the whole track up front.
+// Usage: MusicStreamBenchmark [seconds] [tracks] [speedup]
+
+#include "AudioMixer.h"
+#include "MusicStream.h"
+#include "WavWriter.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int kSampleRate = 48000;
+static const int kFileRate = 44100;
+static const int kCallbackFrames = 1024;
+static const char* kPath = "MusicStreamBenchmark.wav";
+
+// Two chords, one per channel
+static bool WriteTrack(int seconds) {
+    WavWriter writer;
+    if (!writer.Open(kPath, 2, kFileRate)) return false;
+
+    std::vector<int16_t> block;
+    int frames = seconds * kFileRate;
+    for (int i = 0; i < frames; ++i) {
+        float t = (float)i / kFileRate;
+        float left = 0.3f * std::sin(6.2831853f * 220.0f * t) + 0.2f * std::sin(6.2831853f * 277.2f * t);
+        float right = 0.3f * std::sin(6.2831853f * 329.6f * t) + 0.2f * std::sin(6.2831853f * 0.5f * t);
+        block.push_back((int16_t)(left * 32767.0f));
+        block.push_back((int16_t)(right * 32767.0f));
+        if (block.size() == 8192 || i + 1 == frames) {
+            writer.Write(block.data(), (int)block.size() / 2);
+            block.clear();
+        }
+    }
+    return writer.Close();
+}
+
+int main(int argc, char** argv) {
+    int seconds = argc > 1 ? std::atoi(argv[1]) : 120;
+    int tracks = argc > 2 ? std::atoi(argv[2]) : 4;
+    double speedup = argc > 3 ? std::atof(argv[3]) : 8.0;
+
+    if (!WriteTrack(seconds)) {
+        std::cerr << "Failed to write " << kPath << std::endl;
+        return 1;
+    }
+
+    AudioMixer mixer(kSampleRate);
+    std::vector<std::shared_ptr<MusicStream>> streams;
+    for (int i = 0; i < tracks; ++i) {
+        auto stream = std::make_shared<MusicStream>(kSampleRate);
+        if (!stream->Open(kPath)) return 1;
+        stream->Start(0);
+        mixer.PlayStream(stream, AudioMixer::MusicBus, 1.0f / tracks);
+        streams.push_back(stream);
+    }
+
+    // Paced like a device pulling callbacks, speedup times too fast
+    std::vector<int16_t> output((size_t)kCallbackFrames * 2);
+    auto interval = std::chrono::duration<double>(kCallbackFrames / (kSampleRate * speedup));
+    auto start = Clock::now();
+    auto next = start;
+    int callbacks = 0;
+    while (mixer.GetStats().playingVoices > 0) {
+        next += std::chrono::duration_cast<Clock::duration>(interval);
+        std::this_thread::sleep_until(next);
+        mixer.Mix(output.data(), kCallbackFrames);
+        mixer.Update();
+        callbacks++;
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::remove(kPath);
+
+    uint64_t underruns = 0;
+    uint64_t underrunFrames = 0;
+    uint64_t bytesRead = 0;
+    size_t resident = 0;
+    for (const auto& stream : streams) {
+        MusicStream::Stats stats = stream->GetStats();
+        underruns += stats.underruns;
+        underrunFrames += stats.underrunFrames;
+        bytesRead += stats.bytesRead;
+        resident = stats.residentBytes;
+    }
+    double wholeTrackMb = (double)seconds * kSampleRate * 2 * sizeof(float) / (1024.0 * 1024.0);
+    AudioMixer::Stats mixStats = mixer.GetStats();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << tracks << " tracks of " << seconds << " s (" << kFileRate << " Hz 16-bit stereo, resampled to "
+              << kSampleRate << " Hz), " << speedup << "x real time, " << callbacks << " callbacks" << std::endl;
+    std::cout << "Played in:      " << ms / 1000.0 << " s, mix " << mixStats.averageMixMs << " ms avg per callback"
+              << std::endl;
+    std::cout << "Reader:         " << bytesRead / (ms / 1000.0) / (1024.0 * 1024.0) << " MB/s across all tracks"
+              << std::endl;
+    std::cout << "Underruns:      " << underruns << " (" << underrunFrames << " frames of silence)" << std::endl;
+    std::cout << "Memory / track: " << resident / 1024 << " KB streamed, " << wholeTrackMb
+              << " MB decoded up front" << std::endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+// Bullet-hell style churn: every frame spawns a burst of short-lived objects
+// and lets the oldest expire. Compares pooled Scene::Spawn with
+// make_shared + AddGameObject, and counts heap allocations per frame once
+// the pools have warmed up.
+// Usage: ObjectPoolBenchmark [spawnsPerFrame] [lifetimeFrames]
+
+#include "Scene.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static std::atomic<uint64_t> g_heapAllocations(0);
+
+void* operator new(std::size_t size) {
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// Pool slabs use the aligned forms
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    size_t align = (size_t)alignment;
+#ifdef _WIN32
+    void* memory = _aligned_malloc(size ? size : 1, align);
+#else
+    void* memory = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+    if (memory) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+static void FreeAligned(void* memory) {
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+    FreeAligned(memory);
+}
+
+class Bullet : public GameObject {
+public:
+    explicit Bullet(int lifetime) : m_framesLeft(lifetime) {
+        velocity = Vector2(0.0f, -400.0f);
+    }
+
+    void Update(float deltaTime) override {
+        position = position + velocity * deltaTime;
+        if (--m_framesLeft <= 0) {
+            active = false;
+        }
+    }
+
+private:
+    int m_framesLeft;
+};
+
+struct RunResult {
+    double msPerFrame;
+    double allocationsPerFrame;
+};
+
+template<typename SpawnFunction>
+static RunResult Run(Scene& scene, int spawnsPerFrame, SpawnFunction spawn) {
+    const float dt = 1.0f / 60.0f;
+    const int warmupFrames = 300;
+    const int measuredFrames = 600;
+
+    for (int frame = 0; frame < warmupFrames; ++frame) {
+        for (int i = 0; i < spawnsPerFrame; ++i) spawn();
+        scene.Update(dt);
+    }
+
+    uint64_t allocationsBefore = g_heapAllocations.load();
+    auto start = Clock::now();
+    for (int frame = 0; frame < measuredFrames; ++frame) {
+        for (int i = 0; i < spawnsPerFrame; ++i) spawn();
+        scene.Update(dt);
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    uint64_t allocations = g_heapAllocations.load() - allocationsBefore;
+
+    return { ms / measuredFrames, (double)allocations / measuredFrames };
+}
+
+int main(int argc, char** argv) {
+    int spawnsPerFrame = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int lifetime = argc > 2 ? std::atoi(argv[2]) : 60;
+
+    Scene pooledScene;
+    RunResult pooled = Run(pooledScene, spawnsPerFrame, [&]() {
+        pooledScene.Spawn<Bullet>(lifetime);
+    });
+    Scene::AllocationStats stats = pooledScene.GetAllocationStats();
+
+    Scene sharedScene;
+    RunResult shared = Run(sharedScene, spawnsPerFrame, [&]() {
+        sharedScene.AddGameObject(std::make_shared<Bullet>(lifetime));
+    });
+
+    std::cout << spawnsPerFrame << " spawns/frame, " << lifetime << " frame lifetime, ~"
+              << pooledScene.GetGameObjectCount() << " live objects" << std::endl
+              << std::fixed << std::setprecision(3)
+              << "make_shared + AddGameObject: " << std::setw(8) << shared.msPerFrame << " ms/frame, "
+              << std::setprecision(1) << shared.allocationsPerFrame << " heap allocations/frame" << std::endl
+              << std::setprecision(3)
+              << "Scene::Spawn (pooled):       " << std::setw(8) << pooled.msPerFrame << " ms/frame, "
+              << std::setprecision(1) << pooled.allocationsPerFrame << " heap allocations/frame" << std::endl
+              << "Pool slabs: " << stats.poolSlabAllocations << ", list growths: " << stats.containerGrowths
+              << ", spawned: " << stats.spawned << ", destroyed: " << stats.destroyed << std::endl;
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Updates N thread-safe objects with a moderately expensive Update (steering
+// towards a moving target plus a few transcendental calls) serially and with
+// Scene::SetParallelUpdate at increasing thread counts.
+// Usage: ParallelSceneBenchmark [objectCount]
+
+#include "Scene.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+class Boid : public GameObject {
+public:
+    Boid(float x, float y, float phase) : m_phase(phase) {
+        position = Vector2(x, y);
+        threadSafe = true;
+    }
+
+    void Update(float deltaTime) override {
+        m_phase += deltaTime;
+        for (int i = 0; i < 8; ++i) {
+            float angle = m_phase * 0.7f + i * 0.785f;
+            Vector2 target(std::cos(angle) * 400.0f, std::sin(angle) * 300.0f);
+            Vector2 toTarget = target - position;
+            float length = std::sqrt(toTarget.x * toTarget.x + toTarget.y * toTarget.y) + 0.001f;
+            velocity = velocity + toTarget * (deltaTime * 0.125f / length);
+        }
+        position = position + velocity * deltaTime;
+        rotation = std::atan2(velocity.y, velocity.x);
+    }
+
+private:
+    float m_phase;
+};
+
+static double MeasureUpdate(Scene& scene, int frames) {
+    const float dt = 1.0f / 60.0f;
+    scene.Update(dt);
+
+    double best = 1e9;
+    for (int frame = 0; frame < frames; ++frame) {
+        auto start = Clock::now();
+        scene.Update(dt);
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 50000;
+    const int frames = 20;
+    int maxThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+
+    Scene scene;
+    for (int i = 0; i < count; ++i) {
+        scene.Spawn<Boid>((float)(i % 500), (float)(i / 500), i * 0.01f);
+    }
+
+    double serialMs = MeasureUpdate(scene, frames);
+    std::cout << count << " objects, best of " << frames << " updates" << std::endl
+              << std::fixed << std::setprecision(3)
+              << "Serial:     " << std::setw(8) << serialMs << " ms" << std::endl;
+
+    scene.SetParallelUpdate(true);
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        std::unique_ptr<JobSystem> jobs(new JobSystem(threads - 1));
+        scene.SetJobSystem(jobs.get());
+        double parallelMs = MeasureUpdate(scene, frames);
+        scene.SetJobSystem(nullptr);
+
+        std::cout << std::setprecision(3)
+                  << std::setw(2) << threads << " threads: " << std::setw(8) << parallelMs << " ms ("
+                  << std::setprecision(2) << serialMs / parallelMs << "x)" << std::endl;
+    }
+    return 0;
+}
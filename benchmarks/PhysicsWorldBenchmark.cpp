@@ -0,0 +1,84 @@
+// Compares per-Body integration (Physics::ApplyGravity + Physics::UpdateBody)
+// with the structure-of-arrays PhysicsWorld::Step.
+// Usage: PhysicsWorldBenchmark [bodyCount]
+
+#include "PhysicsWorld.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int bodyCount = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const int iterations = 50;
+    const float dt = 1.0f / 60.0f;
+    const Vector2 gravity(0, 500);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+
+    std::vector<Physics::Body> bodies(bodyCount);
+    PhysicsWorld world;
+    world.Reserve(bodyCount);
+    for (int i = 0; i < bodyCount; ++i) {
+        bodies[i].position = Vector2(dist(rng), dist(rng));
+        bodies[i].velocity = Vector2(dist(rng), dist(rng));
+        bodies[i].isStatic = (i % 16) == 0;
+        world.AddBody(bodies[i]);
+    }
+
+    double legacyBest = 1e9, legacyTotal = 0.0;
+    for (int it = 0; it < iterations; ++it) {
+        auto start = Clock::now();
+        for (auto& body : bodies) {
+            Physics::ApplyGravity(body, gravity);
+            Physics::UpdateBody(body, dt);
+        }
+        double ms = MillisecondsSince(start);
+        legacyBest = std::min(legacyBest, ms);
+        legacyTotal += ms;
+    }
+
+    double worldBest = 1e9, worldTotal = 0.0;
+    for (int it = 0; it < iterations; ++it) {
+        auto start = Clock::now();
+        world.Step(dt, gravity);
+        double ms = MillisecondsSince(start);
+        worldBest = std::min(worldBest, ms);
+        worldTotal += ms;
+    }
+
+    // Both paths must agree
+    float maxError = 0.0f;
+    for (int i = 0; i < bodyCount; ++i) {
+        Vector2 p = world.GetPosition((PhysicsWorld::BodyId)i);
+        maxError = std::max(maxError, std::fabs(p.x - bodies[i].position.x));
+        maxError = std::max(maxError, std::fabs(p.y - bodies[i].position.y));
+    }
+
+#if defined(__AVX__)
+    const char* isa = "AVX";
+#elif defined(__SSE2__) || defined(_M_X64)
+    const char* isa = "SSE2";
+#else
+    const char* isa = "scalar";
+#endif
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Bodies: " << bodyCount << ", iterations: " << iterations << ", kernel: " << isa << std::endl;
+    std::cout << "Physics::UpdateBody  best " << legacyBest << " ms, avg " << legacyTotal / iterations << " ms" << std::endl;
+    std::cout << "PhysicsWorld::Step   best " << worldBest << " ms, avg " << worldTotal / iterations << " ms" << std::endl;
+    std::cout << "Speedup (best): " << std::setprecision(2) << legacyBest / worldBest << "x" << std::endl;
+    std::cout << "Max position difference: " << std::setprecision(6) << maxError << std::endl;
+    return 0;
+}
@@ -0,0 +1,177 @@
+// Loads a level's worth of sound effects (16-bit, 44.1 kHz, half mono and
+// half stereo) two ways: converted to the mixer's 48 kHz float format as
+// each one loads, and from a sound bank that stores them already
+// converted and contiguous. Also measures the resampler's quality on a
+// sweep of tones against the linear interpolation it replaces.
+// Usage: SoundBankBenchmark [sounds] [secondsPerSound]
+
+#include "AssetPack.h"
+#include "Resampler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static const int kSourceRate = 44100;
+static const int kMixerRate = 48000;
+static const double kPi = 3.14159265358979323846;
+
+static double MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct SourceSound {
+    std::vector<int16_t> samples;
+    int channels;
+};
+
+// A decaying chirp, so every sound has energy across the band
+static SourceSound MakeSound(int index, double seconds) {
+    SourceSound sound;
+    sound.channels = index % 2 == 0 ? 1 : 2;
+    int frames = (int)(seconds * kSourceRate);
+    sound.samples.resize((size_t)frames * sound.channels);
+    double phase = 0.0;
+    for (int i = 0; i < frames; ++i) {
+        double t = (double)i / frames;
+        phase += 2.0 * kPi * (200.0 + 8000.0 * t * (1 + index % 3)) / kSourceRate;
+        double value = 0.5 * std::sin(phase) * (1.0 - t);
+        for (int c = 0; c < sound.channels; ++c) {
+            sound.samples[(size_t)i * sound.channels + c] = (int16_t)(value * 32767.0);
+        }
+    }
+    return sound;
+}
+
+// What loading a WAV used to cost: sample format, then rate
+static std::vector<float> Convert(const SourceSound& sound) {
+    std::vector<float> source(sound.samples.size());
+    for (size_t i = 0; i < source.size(); ++i) {
+        source[i] = sound.samples[i] / 32768.0f;
+    }
+    std::vector<float> converted;
+    Resampler resampler(kSourceRate, kMixerRate);
+    resampler.Process(source.data(), (int)(source.size() / sound.channels), sound.channels, converted);
+    return converted;
+}
+
+static std::vector<float> ResampleLinear(const std::vector<float>& input, int inputRate, int outputRate) {
+    int frames = (int)((int64_t)input.size() * outputRate / inputRate);
+    std::vector<float> output(frames);
+    for (int i = 0; i < frames; ++i) {
+        double position = (double)i * inputRate / outputRate;
+        int index = (int)position;
+        float fraction = (float)(position - index);
+        float next = index + 1 < (int)input.size() ? input[index + 1] : 0.0f;
+        output[i] = input[index] + (next - input[index]) * fraction;
+    }
+    return output;
+}
+
+// Signal to error ratio against the ideal tone at the output rate, skipping
+// the filter's edges
+static double ToneSnr(const std::vector<float>& output, double hz, int outputRate) {
+    double signal = 0.0;
+    double error = 0.0;
+    for (size_t i = 256; i + 256 < output.size(); ++i) {
+        double expected = 0.5 * std::sin(2.0 * kPi * hz * i / outputRate);
+        signal += expected * expected;
+        error += (output[i] - expected) * (output[i] - expected);
+    }
+    return 10.0 * std::log10(signal / std::max(error, 1e-30));
+}
+
+static void PrintQuality(int inputRate, int outputRate) {
+    std::cout << std::setw(6) << inputRate << " -> " << std::setw(6) << outputRate;
+    Resampler resampler(inputRate, outputRate);
+    for (double hz : { 1000.0, 5000.0, 8000.0 }) {
+        std::vector<float> input(inputRate / 4);
+        for (size_t i = 0; i < input.size(); ++i) {
+            input[i] = (float)(0.5 * std::sin(2.0 * kPi * hz * i / inputRate));
+        }
+        std::vector<float> polyphase;
+        resampler.Process(input.data(), (int)input.size(), 1, polyphase);
+        std::vector<float> linear = ResampleLinear(input, inputRate, outputRate);
+        std::cout << std::setw(9) << ToneSnr(polyphase, hz, outputRate) << " / " << std::setw(5)
+                  << ToneSnr(linear, hz, outputRate);
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int soundCount = argc > 1 ? std::atoi(argv[1]) : 64;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 1.5;
+
+    std::vector<SourceSound> sounds;
+    size_t sourceBytes = 0;
+    for (int i = 0; i < soundCount; ++i) {
+        sounds.push_back(MakeSound(i, seconds));
+        sourceBytes += sounds.back().samples.size() * sizeof(int16_t);
+    }
+
+    // Converting as each sound loads
+    auto start = Clock::now();
+    std::vector<std::vector<float>> converted;
+    for (const SourceSound& sound : sounds) {
+        converted.push_back(Convert(sound));
+    }
+    double convertMs = MillisecondsSince(start);
+
+    fs::path path = fs::temp_directory_path() / "9gravity_sound_bank.pak";
+    AssetPackWriter writer;
+    for (int i = 0; i < soundCount; ++i) {
+        int channels = sounds[i].channels;
+        writer.AddAudio("assets/sfx/sound" + std::to_string(i) + ".wav", kMixerRate, channels, converted[i].data(),
+                        (int)(converted[i].size() / channels));
+    }
+    if (!writer.Write(path.string())) return 1;
+    size_t bankBytes = (size_t)fs::file_size(path);
+
+    // Loading the bank: open, then copy each sound into its buffer as
+    // Sound::LoadFromPCM does at a matching rate
+    start = Clock::now();
+    AssetPack pack;
+    if (!pack.Open(path.string())) return 1;
+    std::vector<std::vector<float>> loaded;
+    uint64_t lowest = UINT64_MAX;
+    uint64_t highest = 0;
+    size_t payload = 0;
+    for (size_t i = 0; i < pack.GetEntryCount(); ++i) {
+        const AssetPack::Entry& entry = pack.GetEntries()[i];
+        if (entry.type != (uint8_t)AssetPack::EntryType::AudioF32) continue;
+        AssetPack::Span span = pack.GetData(entry);
+        const float* samples = (const float*)span.data;
+        loaded.emplace_back(samples, samples + span.size / sizeof(float));
+        lowest = std::min(lowest, entry.offset);
+        highest = std::max(highest, entry.offset + entry.size);
+        payload += span.size;
+    }
+    double bankMs = MillisecondsSince(start);
+    pack.Close();
+    fs::remove(path);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << soundCount << " sounds of " << seconds << " s (" << kSourceRate << " Hz 16-bit, "
+              << sourceBytes / 1024 << " KB) for a " << kMixerRate << " Hz mixer" << std::endl;
+    std::cout << "Convert on load:  " << std::setw(9) << convertMs << " ms" << std::endl;
+    std::cout << "Sound bank:       " << std::setw(9) << bankMs << " ms (" << bankBytes / 1024 << " KB, "
+              << payload * 100.0 / (highest - lowest) << "% of the audio span is samples)" << std::endl;
+    std::cout << "Speedup:          " << std::setw(9) << convertMs / bankMs << "x" << std::endl;
+
+    std::cout << std::endl << "Resampling SNR in dB, polyphase / linear, at 1, 5 and 8 kHz" << std::endl;
+    std::cout << std::setprecision(1);
+    PrintQuality(44100, 48000);
+    PrintQuality(22050, 48000);
+    PrintQuality(48000, 44100);
+    PrintQuality(32000, 48000);
+    return 0;
+}
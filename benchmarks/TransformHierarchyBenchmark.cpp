@@ -0,0 +1,117 @@
+// Builds N small hierarchies (root -> 4 children -> 2 grandchildren each)
+// and times TransformHierarchy::Update when nothing moved, when 1% of the
+// roots moved and when every root moved, against recomputing every world
+// matrix recursively from the roots each frame.
+// Usage: TransformHierarchyBenchmark [hierarchyCount]
+
+#include "TransformHierarchy.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct PointerNode {
+    Vector2 position;
+    float rotation;
+    Vector2 scale;
+    Matrix2D world;
+    std::vector<PointerNode*> children;
+};
+
+static void UpdateRecursive(PointerNode* node, const Matrix2D& parentWorld) {
+    node->world = parentWorld * Matrix2D::FromTransform(node->position, node->rotation, node->scale);
+    for (PointerNode* child : node->children) {
+        UpdateRecursive(child, node->world);
+    }
+}
+
+template<typename F>
+static double Best(int runs, F&& function) {
+    double best = 1e9;
+    for (int run = 0; run < runs; ++run) {
+        auto start = Clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 10000;
+    const int runs = 20;
+
+    TransformHierarchy hierarchy;
+    std::vector<TransformId> roots;
+    std::vector<PointerNode> pointerNodes(count * 13);
+    std::vector<PointerNode*> pointerRoots;
+
+    size_t next = 0;
+    auto makePointerNode = [&](float x, float rotation) {
+        PointerNode* node = &pointerNodes[next++];
+        node->position = Vector2(x, 0);
+        node->rotation = rotation;
+        node->scale = Vector2(1, 1);
+        return node;
+    };
+
+    for (int i = 0; i < count; ++i) {
+        TransformId root = hierarchy.Create();
+        hierarchy.SetLocal(root, Vector2((float)(i % 100) * 10, (float)(i / 100) * 10), 0.0f, Vector2(1, 1));
+        roots.push_back(root);
+        PointerNode* pointerRoot = makePointerNode((float)(i % 100) * 10, 0.0f);
+        pointerRoots.push_back(pointerRoot);
+
+        for (int c = 0; c < 4; ++c) {
+            TransformId child = hierarchy.Create();
+            hierarchy.SetLocal(child, Vector2(5.0f, 0), c * 90.0f, Vector2(1, 1));
+            hierarchy.SetParent(child, root, false);
+            PointerNode* pointerChild = makePointerNode(5.0f, c * 90.0f);
+            pointerRoot->children.push_back(pointerChild);
+
+            for (int g = 0; g < 2; ++g) {
+                TransformId grandchild = hierarchy.Create();
+                hierarchy.SetLocal(grandchild, Vector2(2.0f, g * 1.0f), 0.0f, Vector2(0.5f, 0.5f));
+                hierarchy.SetParent(grandchild, child, false);
+                pointerChild->children.push_back(makePointerNode(2.0f, 0.0f));
+            }
+        }
+    }
+    hierarchy.Update();
+
+    float angle = 0.0f;
+    auto moveRoots = [&](int stride) {
+        angle += 1.0f;
+        for (size_t i = 0; i < roots.size(); i += stride) {
+            Vector2 position;
+            float rotation;
+            Vector2 scale;
+            hierarchy.GetLocal(roots[i], position, rotation, scale);
+            hierarchy.SetLocal(roots[i], position, angle, scale);
+        }
+    };
+
+    double staticMs = Best(runs, [&]() { hierarchy.Update(); });
+    size_t staticCount = hierarchy.GetLastUpdateCount();
+    double fewMs = Best(runs, [&]() { moveRoots(100); hierarchy.Update(); });
+    size_t fewCount = hierarchy.GetLastUpdateCount();
+    double allMs = Best(runs, [&]() { moveRoots(1); hierarchy.Update(); });
+    size_t allCount = hierarchy.GetLastUpdateCount();
+    double recursiveMs = Best(runs, [&]() {
+        for (PointerNode* root : pointerRoots) {
+            UpdateRecursive(root, Matrix2D());
+        }
+    });
+
+    std::cout << hierarchy.GetNodeCount() << " transforms in " << count << " hierarchies, best of "
+              << runs << " updates" << std::endl
+              << std::fixed << std::setprecision(3)
+              << "Static:              " << std::setw(8) << staticMs << " ms (" << staticCount << " recomputed)" << std::endl
+              << "1% of roots moved:   " << std::setw(8) << fewMs << " ms (" << fewCount << " recomputed)" << std::endl
+              << "All roots moved:     " << std::setw(8) << allMs << " ms (" << allCount << " recomputed)" << std::endl
+              << "Recursive, all:      " << std::setw(8) << recursiveMs << " ms" << std::endl;
+    return 0;
+}
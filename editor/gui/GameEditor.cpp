@@ -1,4 +1,5 @@
 #include "GameEditor.h"
+#include "DynamicAABBTree.h"
 
 #include <imgui.h>
 #include <filesystem>
@@ -21,11 +22,13 @@ GameEditor::GameEditor()
       cameraX(0.0f),
       cameraY(0.0f),
       selectedEntity(nullptr),
+      pickTree(std::make_unique<DynamicAABBTree>()),
       showImportDialog(false),
       importType(EntityType::CHARACTER),
       showEntityInspector(true),
       showFileBrowser(false),
-      currentBrowserPath(".")
+      currentBrowserPath("."),
+      decodeJobs(2) // A small fixed pool; a folder import queues up instead of starting a thread per image
 {
     newProjectBuffer[0] = '\0';
     importNameBuffer[0] = '\0';
@@ -110,6 +113,7 @@ void GameEditor::OpenProject(const std::filesystem::path &projectPath)
     // Clear existing entities
     CleanupTextures();
     entities.clear();
+    pickTree->Clear();
     selectedEntity = nullptr;
 }
 
@@ -208,6 +212,8 @@ bool GameEditor::RenderLauncher(bool &requestOpenFileDialog, std::string &outPro
 
 void GameEditor::RenderEditor()
 {
+    ProcessPendingTextureLoads();
+
     ImGui::SetNextWindowBgAlpha(0.0f);
     ImGui::Begin("Editor (Dockspace)", nullptr, ImGuiWindowFlags_MenuBar);
 
@@ -364,22 +370,98 @@ SDL_Texture* GameEditor::LoadTexture(const std::string& imagePath) {
 #endif
 }
 
+void GameEditor::LoadTextureAsync(GameEntity* entity, const std::string& imagePath) {
+#ifdef HAVE_SDL3_IMAGE
+    // Decoding is the slow part and needs no renderer, so it runs off the UI thread
+    auto load = std::make_unique<PendingTextureLoad>();
+    load->entity = entity;
+    load->imagePath = imagePath;
+    PendingTextureLoad* target = load.get();
+    decodeJobs.Schedule([target]() {
+        target->surface = IMG_Load(target->imagePath.c_str());
+        target->decoded.store(true, std::memory_order_release);
+    }, &textureDecodes);
+    pendingTextureLoads.push_back(std::move(load));
+#else
+    entity->texture = LoadTexture(imagePath);
+#endif
+}
+
+void GameEditor::ProcessPendingTextureLoads() {
+    if (pendingTextureLoads.empty()) return;
+    
+    // Keep uploads from eating the frame when a whole folder is imported
+    const Uint64 uploadBudgetNS = 2000000;
+    Uint64 start = SDL_GetTicksNS();
+    
+    for (auto it = pendingTextureLoads.begin(); it != pendingTextureLoads.end();) {
+        if (SDL_GetTicksNS() - start >= uploadBudgetNS) break;
+        
+        PendingTextureLoad& load = **it;
+        if (!load.decoded.load(std::memory_order_acquire)) {
+            ++it;
+            continue;
+        }
+        
+        SDL_Surface* surface = load.surface;
+        GameEntity* entity = load.entity;
+        
+        if (!surface) {
+#ifdef HAVE_SDL3_IMAGE
+            std::cerr << "Failed to load image: " << load.imagePath << " - " << IMG_GetError() << std::endl;
+#endif
+        } else if (entity && renderer) {
+            entity->texture = SDL_CreateTextureFromSurface(renderer, surface);
+            if (entity->texture) {
+                float w, h;
+                SDL_GetTextureSize(entity->texture, &w, &h);
+                entity->width = w;
+                entity->height = h;
+                UpdateEntityBounds(entity);
+            } else {
+                std::cerr << "Failed to create texture from: " << load.imagePath << " - " << SDL_GetError() << std::endl;
+            }
+        }
+        
+        if (surface) {
+            SDL_DestroySurface(surface);
+        }
+        it = pendingTextureLoads.erase(it);
+    }
+}
+
+void GameEditor::CancelPendingTextureLoads(GameEntity* entity) {
+    if (entity) {
+        // The decode still finishes; its result is just dropped
+        for (auto& load : pendingTextureLoads) {
+            if (load->entity == entity) {
+                load->entity = nullptr;
+            }
+        }
+        return;
+    }
+    
+    decodeJobs.Wait(textureDecodes);
+    for (auto& load : pendingTextureLoads) {
+        if (load->surface) {
+            SDL_DestroySurface(load->surface);
+        }
+    }
+    pendingTextureLoads.clear();
+}
+
 void GameEditor::AddEntity(const std::string& name, const std::string& imagePath, EntityType type) {
     auto entity = std::make_unique<GameEntity>();
     entity->name = name;
     entity->imagePath = imagePath;
     entity->type = type;
-    entity->texture = LoadTexture(imagePath);
     entity->x = 100.0f;
     entity->y = 100.0f;
     entity->zIndex = static_cast<int>(entities.size());
     
-    if (entity->texture) {
-        float w, h;
-        SDL_GetTextureSize(entity->texture, &w, &h);
-        entity->width = w;
-        entity->height = h;
-    }
+    // Texture and size are filled in once the image has decoded
+    LoadTextureAsync(entity.get(), imagePath);
+    UpdateEntityBounds(entity.get());
     
     entities.push_back(std::move(entity));
     SortEntitiesByZIndex();
@@ -394,9 +476,11 @@ void GameEditor::RemoveSelectedEntity() {
         });
     
     if (it != entities.end()) {
+        CancelPendingTextureLoads(it->get());
         if ((*it)->texture) {
             SDL_DestroyTexture((*it)->texture);
         }
+        pickTree->RemoveProxy((*it)->pickProxy);
         entities.erase(it);
         selectedEntity = nullptr;
     }
@@ -414,18 +498,37 @@ void GameEditor::SortEntitiesByZIndex() {
         [](const std::unique_ptr<GameEntity>& a, const std::unique_ptr<GameEntity>& b) {
             return a->zIndex < b->zIndex;
         });
+    
+    for (size_t i = 0; i < entities.size(); ++i) {
+        entities[i]->drawOrder = i;
+    }
 }
 
 GameEntity* GameEditor::GetEntityAtPosition(float x, float y) {
-    // Check entities in reverse z-order (highest z-index first)
-    for (auto it = entities.rbegin(); it != entities.rend(); ++it) {
-        GameEntity* entity = it->get();
-        if (x >= entity->x && x <= entity->x + entity->width &&
-            y >= entity->y && y <= entity->y + entity->height) {
-            return entity;
+    std::vector<int> hits;
+    pickTree->QueryPoint(Vector2(x, y), hits);
+    
+    // The topmost hit is the one drawn last
+    GameEntity* topmost = nullptr;
+    for (int proxy : hits) {
+        GameEntity* entity = static_cast<GameEntity*>(pickTree->GetUserData(proxy));
+        if (!topmost || entity->drawOrder > topmost->drawOrder) {
+            topmost = entity;
         }
     }
-    return nullptr;
+    return topmost;
+}
+
+void GameEditor::UpdateEntityBounds(GameEntity* entity) {
+    // Entities are positioned by their top-left corner
+    Physics::AABB bounds;
+    bounds.min = Vector2(entity->x, entity->y);
+    bounds.max = Vector2(entity->x + entity->width, entity->y + entity->height);
+    if (entity->pickProxy < 0) {
+        entity->pickProxy = pickTree->AddProxy(bounds, entity);
+    } else {
+        pickTree->MoveProxy(entity->pickProxy, bounds);
+    }
 }
 
 void GameEditor::RenderCanvas() {
@@ -567,10 +670,14 @@ void GameEditor::RenderInspector() {
             selectedEntity->type = static_cast<EntityType>(currentType);
         }
         
-        ImGui::DragFloat("X", &selectedEntity->x, 1.0f);
-        ImGui::DragFloat("Y", &selectedEntity->y, 1.0f);
-        ImGui::DragFloat("Width", &selectedEntity->width, 1.0f, 1.0f, 1000.0f);
-        ImGui::DragFloat("Height", &selectedEntity->height, 1.0f, 1.0f, 1000.0f);
+        bool boundsChanged = false;
+        boundsChanged |= ImGui::DragFloat("X", &selectedEntity->x, 1.0f);
+        boundsChanged |= ImGui::DragFloat("Y", &selectedEntity->y, 1.0f);
+        boundsChanged |= ImGui::DragFloat("Width", &selectedEntity->width, 1.0f, 1.0f, 1000.0f);
+        boundsChanged |= ImGui::DragFloat("Height", &selectedEntity->height, 1.0f, 1.0f, 1000.0f);
+        if (boundsChanged) {
+            UpdateEntityBounds(selectedEntity);
+        }
         ImGui::DragInt("Z-Index", &selectedEntity->zIndex);
         
         if (ImGui::Button("Sort by Z-Index")) {
@@ -659,12 +766,15 @@ void GameEditor::HandleCanvasInput() {
             ImVec2 delta = ImGui::GetMouseDragDelta(ImGuiMouseButton_Left);
             selectedEntity->x += delta.x / canvasZoom;
             selectedEntity->y += delta.y / canvasZoom;
+            UpdateEntityBounds(selectedEntity);
             ImGui::ResetMouseDragDelta(ImGuiMouseButton_Left);
         }
     }
 }
 
 void GameEditor::CleanupTextures() {
+    CancelPendingTextureLoads();
+    
     for (const auto& entity : entities) {
         if (entity->texture) {
             SDL_DestroyTexture(entity->texture);
@@ -1,6 +1,9 @@
 #ifndef GAME_EDITOR_H
 #define GAME_EDITOR_H
 
+#include "JobSystem.h"
+
+#include <atomic>
 #include <string>
 #include <filesystem>
 #include <vector>
@@ -9,6 +12,8 @@
 struct SDL_Window;
 struct SDL_Texture;
 struct SDL_Renderer;
+struct SDL_Surface;
+class DynamicAABBTree;
 
 enum class EntityType {
     CHARACTER,
@@ -26,8 +31,11 @@ struct GameEntity {
     int zIndex;
     SDL_Texture* texture;
     bool isSelected;
+    int pickProxy;    // Proxy in the editor's pick tree, -1 if none
+    size_t drawOrder; // Position in the sorted entity list
     
-    GameEntity() : x(0), y(0), width(100), height(100), zIndex(0), texture(nullptr), isSelected(false) {}
+    GameEntity() : x(0), y(0), width(100), height(100), zIndex(0), texture(nullptr), isSelected(false),
+                   pickProxy(-1), drawOrder(0) {}
 };
 
 class GameEditor {
@@ -58,6 +66,7 @@ private:
     // Entity management
     std::vector<std::unique_ptr<GameEntity>> entities;
     GameEntity* selectedEntity;
+    std::unique_ptr<DynamicAABBTree> pickTree;
     bool showImportDialog;
     char importNameBuffer[256];
     char importPathBuffer[512];
@@ -72,14 +81,35 @@ private:
     std::string currentBrowserPath;
     std::vector<std::filesystem::directory_entry> browserEntries;
     std::string selectedFilePath;
+    
+    // Images decoding in the background, uploaded a few per frame. The
+    // decode job writes surface and then sets decoded; it never touches the
+    // load after that, so the load can be dropped as soon as decoded is set.
+    struct PendingTextureLoad {
+        GameEntity* entity;
+        std::string imagePath;
+        SDL_Surface* surface;
+        std::atomic<bool> decoded;
+
+        PendingTextureLoad() : entity(nullptr), surface(nullptr), decoded(false) {}
+    };
+    std::vector<std::unique_ptr<PendingTextureLoad>> pendingTextureLoads;
+    // Declared last so the workers are joined before the counter goes away
+    JobCounter textureDecodes;
+    JobSystem decodeJobs;
 
     bool createNewProjectOnDisk(const std::filesystem::path& projectPath);
     SDL_Texture* LoadTexture(const std::string& imagePath);
+    void LoadTextureAsync(GameEntity* entity, const std::string& imagePath);
+    void ProcessPendingTextureLoads();
+    void CancelPendingTextureLoads(GameEntity* entity = nullptr);
     void AddEntity(const std::string& name, const std::string& imagePath, EntityType type);
     void RemoveSelectedEntity();
     void MoveEntityZIndex(GameEntity* entity, int direction);
     void SortEntitiesByZIndex();
     GameEntity* GetEntityAtPosition(float x, float y);
+    // Call after changing an entity's position or size
+    void UpdateEntityBounds(GameEntity* entity);
     void RenderCanvas();
     void RenderInspector();
     void RenderImportDialog();
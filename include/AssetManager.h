@@ -1,24 +1,151 @@
 #pragma once
 
 #include "Renderer.h"
+#include "TextureAtlas.h"
+#include "AssetPack.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <deque>
+#include <list>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <vector>
+
+// Future-like handle for LoadTextureAsync. It becomes ready once the decoded
+// image has been uploaded on the main thread by AssetManager::ProcessUploads.
+class TextureRequest {
+public:
+    enum class State {
+        Pending,
+        Ready,
+        Failed
+    };
+    
+    TextureRequest(const std::string& name, const std::string& path)
+        : m_name(name), m_path(path), m_state(State::Pending) {}
+    
+    State GetState() const { return m_state.load(); }
+    bool IsReady() const { return GetState() == State::Ready; }
+    bool IsDone() const { return GetState() != State::Pending; }
+    
+    // Null until the request is ready
+    std::shared_ptr<Texture> GetTexture() const { return IsReady() ? m_texture : nullptr; }
+    const std::string& GetName() const { return m_name; }
+    const std::string& GetPath() const { return m_path; }
+    
+private:
+    friend class AssetManager;
+    
+    std::string m_name;
+    std::string m_path;
+    std::shared_ptr<Texture> m_texture;
+    std::atomic<State> m_state;
+};
 
 class AssetManager {
 public:
+    struct CacheStats {
+        Uint64 hits;
+        Uint64 misses;
+        Uint64 evictions;
+        size_t bytes;
+        size_t budget;
+        int textureCount;
+    };
+    
     AssetManager();
     ~AssetManager();
     
     void SetRenderer(Renderer* renderer) { m_renderer = renderer; }
+    // Decodes async loads on worker threads; without one they decode inline
+    void SetJobSystem(JobSystem* jobSystem) { m_jobSystem = jobSystem; }
     
     std::shared_ptr<Texture> LoadTexture(const std::string& name, const std::string& path);
     std::shared_ptr<Texture> GetTexture(const std::string& name);
     
+    // Reads and decodes on a worker, then queues the surface for upload
+    std::shared_ptr<TextureRequest> LoadTextureAsync(const std::string& name, const std::string& path);
+    // Main thread, once per frame: creates textures for decoded images until
+    // the time budget or the upload cap is reached (at least one per call)
+    int ProcessUploads();
+    void SetUploadBudget(Uint64 nanoseconds, int maxUploadsPerFrame);
+    // Blocks until every pending decode finished; call before the job system goes away
+    void WaitForAsyncLoads();
+    int GetPendingLoadCount() const { return (int)m_pendingRequests.size(); }
+    
     void UnloadTexture(const std::string& name);
     void UnloadAllTextures();
     
+    // Texture cache: once the estimated size goes over the budget, least
+    // recently used textures that nobody else holds a shared_ptr to are
+    // evicted. Textures of their own count width * height * 4; atlas pages
+    // count whole, since that is what they occupy. Evicting atlased textures
+    // only frees memory once their page empties or is repacked, which the
+    // cache does as part of eviction. 0 disables eviction.
+    void SetCacheBudget(size_t bytes);
+    size_t GetCacheBudget() const { return m_cacheBudget; }
+    CacheStats GetCacheStats() const;
+    void ResetCacheStats();
+    void PrintCacheStats() const;
+    
+    // Textures whose path is found in a mounted pack are read from it instead
+    // of the file system. Packs mounted later take precedence.
+    bool MountPack(const std::string& packPath);
+    void UnmountPacks();
+    
+    // Images no larger than this (in either dimension) are packed into
+    // shared atlas pages; 0 gives every texture its own SDL_Texture
+    void SetAtlasMaxSpriteSize(int size) { m_atlasMaxSpriteSize = size; }
+    int GetAtlasMaxSpriteSize() const { return m_atlasMaxSpriteSize; }
+    TextureAtlas::Stats GetAtlasStats() const { return m_atlas.GetStats(); }
+    void PrintAtlasStats() const;
+    // Releases empty atlas pages and repacks the rest if that shrinks them,
+    // e.g. between levels. Returns the bytes freed.
+    size_t CompactAtlas();
+    
 private:
+    struct DecodedTexture {
+        std::shared_ptr<TextureRequest> request;
+        SDL_Surface* surface;
+    };
+    
+    struct CachedTexture {
+        std::shared_ptr<Texture> texture;
+        size_t bytes;               // 0 when atlased; pages are charged as a whole
+        std::list<std::string>::iterator recency;
+    };
+    
+    std::shared_ptr<Texture> CreateTexture(SDL_Surface* surface);
+    // Cache bookkeeping: Touch counts a hit and marks the entry most recently used
+    std::shared_ptr<Texture> Touch(CachedTexture& entry);
+    void AddToCache(const std::string& name, const std::shared_ptr<Texture>& texture);
+    void EvictToBudget();
+    size_t GetCacheBytes() const;
+    // From a mounted pack if possible, else from disk. Safe on worker threads.
+    SDL_Surface* LoadSurface(const std::string& path) const;
+    int UploadDecoded(Uint64 budgetNS, int maxUploads);
+    void QueueUpload(const std::shared_ptr<TextureRequest>& request, SDL_Surface* surface);
+    
     Renderer* m_renderer;
-    std::unordered_map<std::string, std::shared_ptr<Texture>> m_textures;
+    JobSystem* m_jobSystem;
+    std::unordered_map<std::string, CachedTexture> m_textures;
+    std::list<std::string> m_recency; // Most recently used first
+    size_t m_cacheBudget;
+    size_t m_cacheBytes;                // Textures of their own only
+    Uint64 m_cacheHits;
+    Uint64 m_cacheMisses;
+    Uint64 m_cacheEvictions;
+    std::vector<std::unique_ptr<AssetPack>> m_packs;
+    
+    // Async loads: requests are main-thread only, the upload queue is shared with workers
+    std::unordered_map<std::string, std::shared_ptr<TextureRequest>> m_pendingRequests;
+    std::mutex m_uploadMutex;
+    std::deque<DecodedTexture> m_uploadQueue;
+    JobCounter m_decodeJobs;
+    Uint64 m_uploadBudgetNS;
+    int m_maxUploadsPerFrame;
+    TextureAtlas m_atlas;
+    int m_atlasMaxSpriteSize;
 };
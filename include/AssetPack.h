@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only archive of many assets in one file. The whole file is memory
+// mapped and loaders get spans pointing straight into the mapping.
+//
+// Layout (little-endian):
+//   Header
+//   blobs, each aligned to AssetPack::kBlobAlignment, grouped by type
+//   Entry table, sorted by name hash
+//   name strings
+//
+// A pack of AudioF32 entries is a sound bank: the sounds sit back to back,
+// ready for the mixer, so a level's SFX load in one sequential read.
+class AssetPack {
+public:
+    static const uint32_t kVersion = 1;
+    static const size_t kBlobAlignment = 64;
+
+    enum class EntryType : uint8_t {
+        Raw = 0,         // File bytes as found on disk
+        ImageRGBA32 = 1, // Pre-decoded pixels, width * 4 bytes per row
+        AudioF32 = 2     // Pre-converted interleaved float PCM; width is the
+                         // sample rate, height the channel count (1 or 2)
+    };
+
+    struct Header {
+        char magic[4]; // "9GPK"
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t tableOffset;
+        uint64_t namesOffset;
+    };
+
+    struct Entry {
+        uint64_t hash;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t nameOffset;
+        uint16_t nameLength;
+        uint8_t type;
+        uint8_t flags;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // Bytes inside the mapping; valid until the pack is closed
+    struct Span {
+        const uint8_t* data;
+        size_t size;
+    };
+
+    AssetPack();
+    ~AssetPack();
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_data != nullptr; }
+
+    // Null if the pack doesn't contain the asset
+    const Entry* Find(const std::string& name) const;
+    Span GetData(const Entry& entry) const;
+    std::string GetName(const Entry& entry) const;
+
+    size_t GetEntryCount() const { return m_entryCount; }
+    const Entry* GetEntries() const { return m_entries; }
+    const std::string& GetPath() const { return m_path; }
+
+    // Names use forward slashes and no leading "./"
+    static std::string NormalizeName(const std::string& name);
+    // FNV-1a 64 of the normalized name
+    static uint64_t HashName(const std::string& name);
+
+private:
+    bool Validate() const;
+
+    std::string m_path;
+    const uint8_t* m_data;
+    size_t m_size;
+    const Entry* m_entries;
+    size_t m_entryCount;
+    const char* m_names;
+
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#endif
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+};
+
+// Builds a pack in memory and writes it out in one go
+class AssetPackWriter {
+public:
+    void AddRaw(const std::string& name, std::vector<uint8_t> data);
+    bool AddFile(const std::string& name, const std::string& filePath);
+    // pixels: width * height tightly packed RGBA32 texels
+    void AddImage(const std::string& name, int width, int height, const void* pixels);
+    // samples: frames * channels interleaved floats
+    void AddAudio(const std::string& name, int sampleRate, int channels, const float* samples, int frames);
+
+    bool Write(const std::string& path) const;
+
+    size_t GetEntryCount() const { return m_items.size(); }
+
+private:
+    struct Item {
+        std::string name;
+        AssetPack::EntryType type;
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> data;
+    };
+
+    std::vector<Item> m_items;
+};
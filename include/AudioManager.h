@@ -1,61 +1,164 @@
 #pragma once
 
-//#include <SDL3/SDL_mixer.h>  // Commented out since not available
+#include "AssetPack.h"
+#include "AudioMixer.h"
+#include "MusicStream.h"
+#include "Renderer.h"
+#include <SDL3/SDL.h>
+#include <chrono>
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
+// A WAV file decoded once into the mixer's format (float, at most stereo,
+// resampled to the mixer's rate by Resampler), so voices never convert
+// while they play. Plays on the sound bus; every Play starts another voice,
+// except that plays closer together than the minimum interval are dropped,
+// so a burst of identical requests (ten explosions in one frame) costs one
+// voice.
 class Sound {
 public:
-    Sound();
+    static constexpr float kDefaultMinInterval = 0.05f; // Seconds
+    
+    explicit Sound(const std::shared_ptr<AudioMixer>& mixer = nullptr);
     ~Sound();
     
     bool LoadFromFile(const std::string& path);
-    void Play(int loops = 0);
+    // WAV data; decoded into the sound's own buffer, so data needn't outlive the call
+    bool LoadFromMemory(const void* data, size_t size);
+    // Interleaved float PCM, copied; resampled only if sampleRate isn't the mixer's
+    bool LoadFromPCM(const float* samples, int frames, int channels, int sampleRate);
+    // InvalidVoice if rate-limited or no voice was free
+    AudioMixer::VoiceId Play(int loops = 0, float volume = 1.0f, float pan = 0.0f,
+                             int priority = AudioMixer::kDefaultPriority);
+    // Stops every voice playing this sound
     void Stop();
     
+    void SetMinInterval(float seconds) { m_minInterval = seconds; }
+    // Plays dropped for coming too soon after the last one
+    uint64_t GetLimitedPlays() const { return m_limitedPlays; }
+    const std::shared_ptr<const AudioBuffer>& GetBuffer() const { return m_buffer; }
+    
 private:
-    // Mix_Chunk* m_chunk;  // Commented out
-    int m_channel;
+    bool Decode(SDL_IOStream* io, const std::string& source);
+    
+    std::weak_ptr<AudioMixer> m_mixer; // Gone once the AudioManager shuts down
+    std::shared_ptr<const AudioBuffer> m_buffer;
+    float m_minInterval;
+    std::chrono::steady_clock::time_point m_lastPlay;
+    uint64_t m_limitedPlays;
 };
 
+// A WAV file streamed from disk on the music bus; see MusicStream. Each
+// Play reopens the file, so memory stays bounded however long the track.
 class Music {
 public:
-    Music();
+    // Without a reader thread, decoding happens as the mixer reads (offline)
+    explicit Music(const std::shared_ptr<AudioMixer>& mixer = nullptr, bool readerThread = true);
     ~Music();
     
+    // Checks the file's header; the audio is read while it plays
     bool LoadFromFile(const std::string& path);
+    // Restarts from the beginning if already playing
     void Play(int loops = -1);
     void Stop();
     void Pause();
     void Resume();
     
     bool IsPlaying() const;
+    // Underruns, buffered and resident memory of the current play
+    MusicStream::Stats GetStreamStats() const;
     
 private:
-    // Mix_Music* m_music;  // Commented out
+    std::weak_ptr<AudioMixer> m_mixer;
+    std::string m_path;
+    std::shared_ptr<MusicStream> m_stream;
+    bool m_started;         // m_stream has been played; the next Play opens another
+    bool m_readerThread;
+    AudioMixer::VoiceId m_voice;
+    bool m_paused;
 };
 
 class AudioManager {
 public:
+    enum Backend {
+        DeviceBackend,      // The default playback device's callback mixes
+        OfflineBackend      // Nothing plays; Render mixes on demand, as fast as it can
+    };
+    
     AudioManager();
     ~AudioManager();
     
-    bool Initialize();
+    // The device backend opens the default playback device at its own
+    // sample rate; without a device the mixer still runs its API, but
+    // nothing is mixed. The offline backend mixes at sampleRate.
+    bool Initialize(Backend backend = DeviceBackend, int sampleRate = 48000);
     void Shutdown();
+    // Once per frame: releases voices that finished playing
+    void Update();
     
     std::shared_ptr<Sound> LoadSound(const std::string& name, const std::string& path);
     std::shared_ptr<Music> LoadMusic(const std::string& name, const std::string& path);
     
-    void PlaySound(const std::string& name, int loops = 0);
+    AudioMixer::VoiceId PlaySound(const std::string& name, int loops = 0,
+                                  int priority = AudioMixer::kDefaultPriority);
+    // Attenuated and panned by distance from the listener, and kept up to
+    // date as either moves. One-shots out of earshot aren't played; loops
+    // play virtual until the listener comes close.
+    AudioMixer::VoiceId PlaySoundAt(const std::string& name, const Vector2& position, int loops = 0,
+                                    int priority = AudioMixer::kDefaultPriority);
+    void SetVoicePosition(AudioMixer::VoiceId voice, const Vector2& position);
+    void SetListenerPosition(const Vector2& position) { m_listener = position; }
+    // Full volume inside minDistance, silent beyond maxDistance (world units)
+    void SetAttenuation(float minDistance, float maxDistance);
     void PlayMusic(const std::string& name, int loops = -1);
     void StopMusic();
     
     void SetSoundVolume(int volume); // 0-128
     void SetMusicVolume(int volume); // 0-128
     
+    // Sounds whose path is found in a mounted pack are read from it
+    bool MountPack(const std::string& packPath);
+    // Mounts a sound bank and loads every AudioF32 entry in it as a Sound
+    // named after the entry. Returns the number loaded, -1 if the pack
+    // didn't open.
+    int LoadSoundBank(const std::string& packPath);
+    // Sounds already loaded from the packs stay loaded
+    void UnmountPacks();
+    
+    // Offline backend only: mixes the next frames as interleaved stereo
+    bool Render(int16_t* output, int frames);
+    // Offline backend only: renders frames into a 16-bit stereo WAV file
+    bool RenderToFile(const std::string& path, int frames);
+    
+    AudioMixer* GetMixer() const { return m_mixer.get(); }
+    // Voice counts and time spent in the audio callback
+    AudioMixer::Stats GetMixerStats() const;
+    void PrintMixerStats() const;
+    
 private:
+    // A voice placed in the world
+    struct Emitter {
+        AudioMixer::VoiceId voice;
+        Vector2 position;
+        float volume;       // Last sent to the mixer
+        float pan;
+    };
+    
+    static void SDLCALL MixCallback(void* userdata, SDL_AudioStream* stream, int additionalAmount, int totalAmount);
+    void Attenuate(const Vector2& position, float& volume, float& pan) const;
+    
+    std::shared_ptr<AudioMixer> m_mixer;
+    SDL_AudioStream* m_stream;
+    std::vector<int16_t> m_mixBuffer; // Callback scratch, sized once
     std::unordered_map<std::string, std::shared_ptr<Sound>> m_sounds;
     std::unordered_map<std::string, std::shared_ptr<Music>> m_music;
+    std::vector<std::unique_ptr<AssetPack>> m_packs;
+    std::vector<Emitter> m_emitters;
+    Vector2 m_listener;
+    float m_minDistance;
+    float m_maxDistance;
+    Backend m_backend;
     bool m_initialized;
 };
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "SpscQueue.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Decoded PCM in the mixer's format: 32-bit float at the mixer's sample
+// rate, mono or interleaved stereo
+struct AudioBuffer {
+    std::vector<float> samples;
+    int channels;
+    int frames;
+
+    AudioBuffer() : channels(1), frames(0) {}
+};
+
+// PCM produced while it plays, e.g. music decoded by a background thread.
+// The mixer calls Read and IsFinished from the audio thread only.
+class AudioStreamSource {
+public:
+    virtual ~AudioStreamSource() {}
+
+    // Copies up to frames frames in the mixer's format; fewer means the
+    // source ran dry or ended
+    virtual int Read(float* output, int frames) = 0;
+    // Nothing more will come
+    virtual bool IsFinished() const = 0;
+    virtual int GetChannels() const = 0; // 1 or 2, fixed
+};
+
+// Software mixer for up to kMaxVoices voices into 16-bit stereo. The game
+// thread calls Play/Stop/Set*, which only post commands to a lock-free
+// queue; Mix runs on the audio thread, applies them at the start of each
+// call and mixes with SSE when available (scalar otherwise). Finished
+// voices are reported back through a second queue and their buffers are
+// released on the game thread in Update, so Mix never locks, allocates or
+// frees.
+//
+// Only the voice budget's worth of voices is mixed: highest priority
+// first, then loudest. The rest, and any voice too quiet to hear, are
+// virtual: they keep their place in time without being mixed and fade back
+// in when they make the cut again.
+class AudioMixer {
+public:
+    typedef uint32_t VoiceId;
+    static constexpr VoiceId InvalidVoice = 0;
+    static constexpr int kMaxVoices = 256;
+    // Frames mixed per pass; volume changes ramp over one block
+    static constexpr int kBlockFrames = 256;
+    // Higher wins a place in the voice budget
+    static constexpr int kDefaultPriority = 128;
+    static constexpr int kMaxPriority = 255;
+    // Quieter than this (-60 dB) is never mixed
+    static constexpr float kInaudibleGain = 0.001f;
+    static constexpr float kMaxPitch = 8.0f;
+
+    enum Bus {
+        SoundBus,
+        MusicBus,
+        BusCount
+    };
+
+    struct Stats {
+        int playingVoices;      // Voices the game thread has started and not seen finish
+        int mixedVoices;        // Voices mixed in the last Mix call
+        int virtualVoices;      // Playing but not mixed: over budget, inaudible or paused
+        uint64_t mixCalls;
+        uint64_t framesMixed;
+        double lastMixMs;
+        double averageMixMs;
+        double maxMixMs;
+        double load;            // Mix time over the duration of the audio it produced
+        uint64_t droppedCommands; // Queue was full; the call had no effect
+    };
+
+    explicit AudioMixer(int sampleRate = 48000);
+
+    // Game thread. Volume is linear, pan runs from -1 (left) to 1 (right).
+    // loops: 0 plays once, n repeats n more times, -1 repeats until stopped.
+    VoiceId Play(const std::shared_ptr<const AudioBuffer>& buffer, Bus bus = SoundBus, float volume = 1.0f,
+                 float pan = 0.0f, int loops = 0, int priority = kDefaultPriority);
+    // Plays until the source finishes; looping is up to the source
+    VoiceId PlayStream(const std::shared_ptr<AudioStreamSource>& stream, Bus bus = MusicBus, float volume = 1.0f,
+                       float pan = 0.0f, int priority = kMaxPriority);
+    void Stop(VoiceId voice);
+    // A paused voice keeps its place but isn't mixed
+    void SetPaused(VoiceId voice, bool paused);
+    void StopBuffer(const AudioBuffer* buffer); // Every voice playing it
+    void StopAll();
+    void SetVolume(VoiceId voice, float volume);
+    void SetPan(VoiceId voice, float pan);
+    // Playback rate: 2 is an octave up and twice as fast. Anything but 1 is
+    // resampled with linear interpolation as it mixes. Streams ignore it.
+    void SetPitch(VoiceId voice, float pitch);
+    void SetBusVolume(Bus bus, float volume);
+    void SetMasterVolume(float volume);
+    // Most voices mixed at once; kMaxVoices by default
+    void SetVoiceBudget(int voices);
+    // Until the audio thread reports the voice finished
+    bool IsPlaying(VoiceId voice) const;
+
+    // Game thread, once per frame: frees the slots of finished voices
+    void Update();
+    Stats GetStats() const;
+
+    // Audio thread: mixes the next frames as interleaved stereo
+    void Mix(int16_t* output, int frames);
+
+    int GetSampleRate() const { return m_sampleRate; }
+
+private:
+    enum CommandType {
+        PlayCommand,
+        StopCommand,
+        StopAllCommand,
+        VolumeCommand,
+        PanCommand,
+        PauseCommand,
+        PitchCommand,
+        BusVolumeCommand,
+        MasterVolumeCommand,
+        VoiceBudgetCommand
+    };
+
+    struct Command {
+        CommandType type;
+        int slot;
+        uint32_t generation;
+        const AudioBuffer* buffer;
+        AudioStreamSource* stream;
+        float value;
+        float pan;
+        int loops;
+        int bus;
+        int priority;
+    };
+
+    // Game thread's view of a slot; owns the source while the voice plays
+    struct SlotState {
+        std::shared_ptr<const AudioBuffer> buffer;
+        std::shared_ptr<AudioStreamSource> stream;
+        uint32_t generation;
+        bool busy;
+    };
+
+    // Audio thread's view of a slot
+    struct Voice {
+        const AudioBuffer* buffer; // One of the two
+        AudioStreamSource* stream;
+        int streamChannels;
+        uint32_t generation;
+        int position;           // Next frame to mix
+        float fraction;         // Between position and the frame after
+        float pitch;
+        int loops;
+        int bus;
+        int priority;
+        float score;            // Priority, then loudness
+        float volume;
+        float pan;
+        float gainLeft, gainRight; // Reached at the end of the last block
+        bool playing;
+        bool paused;
+        bool stopping;          // Fading out over the next block
+        bool audible;           // Made the voice budget this Mix call
+        bool fresh;             // Started since the last Mix call
+    };
+
+    struct FinishedVoice {
+        int slot;
+        uint32_t generation;
+    };
+
+    static VoiceId MakeId(int slot, uint32_t generation) { return (generation << 8) | (uint32_t)slot; }
+    VoiceId Start(Command& command, const std::shared_ptr<const AudioBuffer>& buffer,
+                  const std::shared_ptr<AudioStreamSource>& stream);
+    bool FindSlot(VoiceId voice, int& slot) const;
+    void Post(const Command& command);
+
+    void ApplyCommands();
+    // Marks the voices to mix this call; returns how many
+    int SelectAudibleVoices();
+    void MixVoice(Voice& voice, int slot, float* accumulator, int frames);
+    // Interpolates up to frames frames of a pitched voice into output;
+    // fewer if it ends
+    int ResampleVoice(Voice& voice, float* output, int frames, bool& finished);
+    // Moves a virtual voice on without mixing it
+    void AdvanceVoice(Voice& voice, int slot, int frames);
+    void Finish(Voice& voice, int slot);
+    void MixFrames(const float* source, int channels, int frames, float* accumulator,
+                   float gainLeft, float gainRight, float stepLeft, float stepRight);
+
+    int m_sampleRate;
+
+    // Game thread
+    std::vector<SlotState> m_slots;
+    std::vector<int> m_freeSlots;
+    int m_playingVoices;
+
+    // Audio thread
+    std::vector<Voice> m_voices;
+    float m_busVolume[BusCount];
+    float m_masterVolume;
+    int m_voiceBudget;
+    std::vector<int> m_candidates; // Slots competing for the budget; sized once
+    alignas(16) float m_accumulator[kBlockFrames * 2];
+    alignas(16) float m_streamBlock[kBlockFrames * 2]; // Read from a stream or resampled before mixing
+
+    SpscQueue<Command, 1024> m_commands;
+    // One entry per slot at most, since a slot is only reused once its
+    // finish has been read
+    SpscQueue<FinishedVoice, kMaxVoices> m_finished;
+
+    // Written by the audio thread, read by GetStats
+    std::atomic<int> m_mixedVoices;
+    std::atomic<int> m_virtualVoices;
+    std::atomic<uint64_t> m_mixCalls;
+    std::atomic<uint64_t> m_framesMixed;
+    std::atomic<uint64_t> m_totalMixNs;
+    std::atomic<uint64_t> m_lastMixNs;
+    std::atomic<uint64_t> m_maxMixNs;
+    std::atomic<uint64_t> m_droppedCommands;
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+};
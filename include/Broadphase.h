@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Physics.h"
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Uniform-grid spatial hash used as the collision broadphase.
+// Every proxy is registered in each cell its AABB touches. A pair is only
+// reported from the first cell both proxies share, so the pair list comes
+// out deduplicated without sorting.
+class SpatialHash {
+public:
+    explicit SpatialHash(float cellSize = 64.0f);
+
+    int AddProxy(const Physics::AABB& aabb);
+    void MoveProxy(int proxy, const Physics::AABB& aabb);
+    void RemoveProxy(int proxy);
+    void Clear();
+
+    // Sync with a full body set: proxy i tracks aabbs[i]. Only bodies whose
+    // AABB crossed a cell boundary are re-inserted. Don't mix with AddProxy/RemoveProxy.
+    void Update(const std::vector<Physics::AABB>& aabbs);
+
+    // Overlapping proxy pairs (first < second), in no particular order
+    const std::vector<std::pair<int, int>>& FindPairs();
+
+    // Appends every proxy overlapping aabb, each once, in no particular
+    // order. Only the cells under aabb are visited, unless there are more of
+    // those than proxies. Returns the number of cells or proxies examined.
+    int Query(const Physics::AABB& aabb, std::vector<int>& outProxies) const;
+
+    float GetCellSize() const { return m_cellSize; }
+    int GetProxyCount() const { return m_proxyCount; }
+    int GetCellCount() const { return (int)m_cells.size(); }
+    int GetReinsertCount() const { return m_reinsertCount; } // since last FindPairs
+
+private:
+    struct CellRange {
+        int minX, minY, maxX, maxY;
+
+        bool operator==(const CellRange& other) const {
+            return minX == other.minX && minY == other.minY &&
+                   maxX == other.maxX && maxY == other.maxY;
+        }
+    };
+
+    struct Proxy {
+        Physics::AABB aabb;
+        CellRange cells;
+        bool active;
+    };
+
+    CellRange ComputeCellRange(const Physics::AABB& aabb) const;
+    void InsertIntoCells(int proxy, const CellRange& range);
+    void RemoveFromCells(int proxy, const CellRange& range);
+
+    static uint64_t CellKey(int x, int y) {
+        return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+    }
+
+    float m_cellSize;
+    float m_invCellSize;
+    int m_proxyCount;
+    int m_reinsertCount;
+
+    std::unordered_map<uint64_t, std::vector<int>> m_cells;
+    std::vector<Proxy> m_proxies;
+    std::vector<int> m_freeProxies;
+    std::vector<std::pair<int, int>> m_pairs;
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "DynamicAABBTree.h"
+#include "Physics.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class JobSystem;
+
+// Steps a set of Physics::Body with box contacts resolved by sequential
+// impulses. Each overlapping pair gets a contact manifold keyed by the two
+// body indices; manifolds persist between steps and start from last step's
+// impulses (warm starting), so resting stacks converge in a few iterations
+// instead of needing substeps. Pairs a few pixels apart keep their manifold
+// (speculative contacts), so a box lifting off slightly doesn't lose its
+// accumulated impulse. Bodies with a zero size don't collide.
+//
+// Touching bodies form islands. Once every body in an island has stayed
+// below its sleepThreshold for the time to sleep, the island sleeps: it
+// isn't integrated, and its contacts are neither tested nor solved. It
+// wakes as a whole when an awake body touches it, or when one of its bodies
+// is woken with Physics::ApplyImpulse / Physics::WakeBody.
+//
+// Awake islands share no dynamic bodies, so given a JobSystem they are
+// solved in parallel, largest first. The result doesn't depend on the
+// number of threads: each island is solved exactly as it would be alone.
+//
+// A body flagged isBullet that would move further than its own size in a
+// step isn't moved with its island. Once the islands are done it is swept
+// against the other bodies' new positions and stopped at the first one it
+// reaches, then bounces and carries on for the rest of the step. Bodies the
+// solve pushed outside their broadphase bounds have those bounds grown
+// first, so a box knocked into the bullet's path is still hit. Other
+// bullets are only found where they started the step. Speculative contacts
+// already keep fast boxes from passing through each other, but they can
+// catch a box flying close past a corner; the sweep can't.
+class ContactSolver {
+public:
+    struct StepStats {
+        size_t contacts;
+        size_t contactsSolved; // Contacts inside an awake island
+        size_t warmStarted;    // Contacts that carried impulses from the last step
+        size_t pairsTested;    // Broadphase pairs given to the narrowphase
+        size_t awakeBodies;    // Dynamic bodies only
+        size_t sleepingBodies;
+        size_t islands;        // Awake islands this step
+        size_t largestIsland;  // Bodies in the largest of them
+        size_t islandsSlept;   // Islands put to sleep this step
+        size_t islandsWoken;
+        size_t bulletsSwept;   // Bullets moved by a sweep instead of a plain step
+        size_t bulletHits;     // Times a sweep stopped a bullet on something
+    };
+
+    ContactSolver();
+
+    // Integrates velocities (acceleration + gravity), solves contacts, then
+    // integrates positions and clears accelerations. Bodies are identified
+    // by index: keep indices stable between steps to keep warm starting and
+    // sleeping islands. With a JobSystem of more than one thread, islands
+    // are solved on its workers.
+    void Step(std::vector<Physics::Body>& bodies, float deltaTime, const Vector2& gravity = Vector2(0, 0),
+              JobSystem* jobs = nullptr);
+
+    void SetIterations(int iterations) { m_iterations = iterations > 0 ? iterations : 1; }
+    int GetIterations() const { return m_iterations; }
+    void SetWarmStarting(bool enabled) { m_warmStarting = enabled; }
+    bool IsWarmStarting() const { return m_warmStarting; }
+    // Fraction of the penetration beyond slop removed per step
+    void SetPositionCorrection(float factor, float slop) { m_baumgarte = factor; m_slop = slop; }
+    // Approach speeds below this don't bounce, so resting contacts stay put
+    void SetRestitutionThreshold(float speed) { m_restitutionThreshold = speed; }
+
+    // Disabling wakes every sleeping body on the next step
+    void SetSleepingEnabled(bool enabled) { m_sleepingEnabled = enabled; }
+    bool IsSleepingEnabled() const { return m_sleepingEnabled; }
+    // Seconds an island has to stay below its bodies' thresholds
+    void SetTimeToSleep(float seconds) { m_timeToSleep = seconds; }
+
+    // Forgets all manifolds and islands, e.g. after bodies were reordered.
+    // Sleeping bodies stay asleep until touched.
+    void Clear();
+
+    const StepStats& GetStepStats() const { return m_stats; }
+
+private:
+    struct Contact {
+        uint64_t key;        // (a << 32) | b, a < b
+        int a, b;
+        Vector2 normal;      // From a to b
+        float penetration;   // Negative while the boxes are still apart
+        bool touching;       // Overlapping, or closing the gap this step
+        float normalImpulse;
+        float tangentImpulse;
+        float mass;          // Effective mass along the normal and the tangent
+        float bias;          // Target separating speed: bounce or push out of penetration
+        float relaxBias;     // Same without the push out
+        float friction;
+        float restitution;
+    };
+
+    void WakeRequestedIslands(std::vector<Physics::Body>& bodies);
+    void GatherPairs(const std::vector<Physics::Body>& bodies);
+    void FindContacts(const std::vector<Physics::Body>& bodies, float deltaTime);
+    void WakeTouchedIslands(std::vector<Physics::Body>& bodies);
+    void BuildIslands();
+    void BuildIslandBatches();
+    // Solves the island's contacts and integrates its bodies' positions
+    void SolveIsland(int island, std::vector<Physics::Body>& bodies, float deltaTime);
+    void SweepBullets(std::vector<Physics::Body>& bodies, float deltaTime);
+    void PrepareContacts(const int* contacts, int contactCount, std::vector<Physics::Body>& bodies, float deltaTime);
+    void SolveContact(Contact& contact, std::vector<Physics::Body>& bodies, bool useBias) const;
+    void SleepIslands(std::vector<Physics::Body>& bodies, float deltaTime);
+
+    // Wakes the body and the rest of its sleeping island
+    void WakeBody(std::vector<Physics::Body>& bodies, int body);
+    int FindIslandRoot(int body);
+
+    int m_iterations;
+    bool m_warmStarting;
+    float m_baumgarte;
+    float m_slop;
+    float m_restitutionThreshold;
+    float m_speculativeDistance;
+    bool m_sleepingEnabled;
+    float m_timeToSleep;
+
+    DynamicAABBTree m_broadphase;
+    std::vector<Physics::AABB> m_bounds;
+    std::vector<float> m_inverseMass;
+    std::vector<uint8_t> m_awake; // Dynamic and not sleeping
+    std::vector<uint8_t> m_sweeping; // Bullets moved by SweepBullets this step
+    std::vector<std::pair<int, int>> m_pairs;
+    std::vector<int> m_queryResults;
+
+    // Sorted by key, so last step's manifolds can be matched with a merge
+    std::vector<Contact> m_contacts;
+    std::vector<Contact> m_previousContacts;
+
+    // Awake islands, rebuilt every step. Bodies of island i are
+    // m_islandBodies[m_islandStarts[i] .. m_islandStarts[i + 1]), and its
+    // contacts likewise in m_islandContacts, in key order.
+    std::vector<int> m_islandParent; // Union-find over body indices
+    std::vector<int> m_islandOf;     // Per body, -1 if not awake
+    std::vector<int> m_islandStarts;
+    std::vector<int> m_islandBodies;
+    std::vector<int> m_contactIsland; // Per contact, -1 if not solved
+    std::vector<int> m_islandContactStarts;
+    std::vector<int> m_islandContacts;
+
+    // Parallel solve: islands by descending work, grouped into batches of
+    // m_islandOrder[m_batchStarts[j] .. m_batchStarts[j + 1])
+    std::vector<int> m_islandWork;
+    std::vector<int> m_islandOrder;
+    std::vector<int> m_batchStarts;
+
+    // Sleeping islands keep their members so they wake as a group
+    std::vector<int> m_sleepingIslandOf; // Per body, -1 if none
+    std::vector<std::vector<int>> m_sleepingIslands;
+    std::vector<int> m_freeSleepingIslands;
+
+    StepStats m_stats;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Physics.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Bounding volume hierarchy over Physics::AABB for broadphase pairs and
+// point/rect/ray queries. Leaves store a fat AABB (the real box grown by a
+// margin and the last displacement), so small moves don't touch the tree.
+// Inserts pick the sibling with the lowest perimeter cost and the path
+// back to the root is improved with tree rotations. Unlike SpatialHash it
+// needs no cell size tuning and handles boxes of very different sizes.
+class DynamicAABBTree {
+public:
+    struct RayHit {
+        int proxy;
+        float fraction; // Along from -> to, 0..1
+        Vector2 point;
+    };
+
+    explicit DynamicAABBTree(float fatMargin = 4.0f);
+
+    int AddProxy(const Physics::AABB& aabb, void* userData = nullptr);
+    // Returns true if the proxy had to be re-inserted. displacement is the
+    // expected movement until the next call, used to stretch the fat AABB.
+    bool MoveProxy(int proxy, const Physics::AABB& aabb, const Vector2& displacement = Vector2(0, 0));
+    void RemoveProxy(int proxy);
+    void Clear();
+
+    // Same contract as SpatialHash::Update: proxy i tracks aabbs[i]. Don't
+    // mix with AddProxy/RemoveProxy.
+    void Update(const std::vector<Physics::AABB>& aabbs);
+
+    // Overlapping proxy pairs (first < second) by exact AABB, in no particular order
+    const std::vector<std::pair<int, int>>& FindPairs();
+
+    // Append proxies whose exact AABB contains the point / overlaps the box
+    void QueryPoint(const Vector2& point, std::vector<int>& outProxies) const;
+    void QueryRect(const Physics::AABB& aabb, std::vector<int>& outProxies) const;
+    // Closest proxy hit by the segment; false if nothing is hit
+    bool RayCast(const Vector2& from, const Vector2& to, RayHit& outHit) const;
+
+    void* GetUserData(int proxy) const { return m_nodes[m_proxyNodes[proxy]].userData; }
+    const Physics::AABB& GetAABB(int proxy) const { return m_nodes[m_proxyNodes[proxy]].tight; }
+    const Physics::AABB& GetFatAABB(int proxy) const { return m_nodes[m_proxyNodes[proxy]].aabb; }
+
+    int GetProxyCount() const { return m_proxyCount; }
+    int GetReinsertCount() const { return m_reinsertCount; } // since last FindPairs
+    int GetHeight() const { return m_root == kNullNode ? 0 : m_nodes[m_root].height; }
+    // Sum of internal node perimeters over the root's; lower is a better tree
+    float GetAreaRatio() const;
+    // Checks parent links, heights and bounds; for debugging
+    bool Validate() const;
+
+private:
+    static constexpr int kNullNode = -1;
+
+    struct Node {
+        Physics::AABB aabb;  // Fat for leaves, union of children otherwise
+        Physics::AABB tight; // Leaves only
+        void* userData;
+        int proxy;           // Leaves only
+        int parent;          // Doubles as the free list link
+        int child1;
+        int child2;
+        int height;          // 0 for leaves, -1 when free
+
+        bool IsLeaf() const { return child1 == kNullNode; }
+    };
+
+    int CreateLeaf(int proxy, const Physics::AABB& aabb, void* userData);
+    int AllocateNode();
+    void FreeNode(int node);
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+    // Refits bounds and heights from node to the root, rotating on the way
+    void Refit(int node);
+    void Rotate(int node);
+    Physics::AABB MakeFat(const Physics::AABB& aabb, const Vector2& displacement) const;
+    bool ValidateNode(int node) const;
+
+    std::vector<Node> m_nodes;
+    int m_root;
+    int m_freeList;
+    int m_proxyCount;
+    int m_reinsertCount;
+    float m_fatMargin;
+
+    // Proxy ids stay stable while nodes are rotated and reused
+    std::vector<int> m_proxyNodes; // Leaf node per proxy, kNullNode if free
+    std::vector<int> m_freeProxies;
+
+    // Traversal stack reused by the queries
+    mutable std::vector<int> m_stack;
+    std::vector<std::pair<int, int>> m_pairStack;
+    std::vector<std::pair<int, int>> m_pairs;
+};
@@ -0,0 +1,319 @@
+#pragma once
+
+#include "Renderer.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Opt-in entity/component storage. Entities with the same set of component
+// types share an archetype; its components live in fixed-size chunks, one
+// contiguous array per component type, so queries walk memory linearly.
+
+typedef uint32_t ComponentTypeId;
+typedef uint64_t ComponentMask;
+static const ComponentTypeId kMaxComponentTypes = 64;
+
+// Generational id: stale copies of a destroyed entity never alias a new one
+struct Entity {
+    uint32_t index;
+    uint32_t generation;
+
+    Entity() : index(0xFFFFFFFFu), generation(0) {}
+    Entity(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+
+    bool IsNull() const { return index == 0xFFFFFFFFu; }
+    bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+// Built-in component mirroring GameObject's transform fields, so existing
+// objects can be moved over with GameObject::GetTransform()
+struct TransformComponent {
+    Vector2 position;
+    Vector2 velocity;
+    float rotation;
+    Vector2 scale;
+
+    TransformComponent() : position(0, 0), velocity(0, 0), rotation(0), scale(1, 1) {}
+};
+
+struct ComponentTypeInfo {
+    size_t size;
+    size_t alignment;
+    // Move-constructs dst from src and destroys src
+    void (*relocate)(void* dst, void* src);
+    void (*destroy)(void* component);
+};
+
+class ComponentRegistry {
+public:
+    template<typename T>
+    static ComponentTypeId GetId() {
+        static const ComponentTypeId id = Register(MakeInfo<T>());
+        return id;
+    }
+
+    static ComponentTypeInfo GetInfo(ComponentTypeId id);
+
+private:
+    static ComponentTypeId Register(const ComponentTypeInfo& info);
+
+    template<typename T>
+    static ComponentTypeInfo MakeInfo() {
+        ComponentTypeInfo info;
+        info.size = sizeof(T);
+        info.alignment = alignof(T);
+        info.relocate = [](void* dst, void* src) {
+            new (dst) T(std::move(*static_cast<T*>(src)));
+            static_cast<T*>(src)->~T();
+        };
+        info.destroy = [](void* component) { static_cast<T*>(component)->~T(); };
+        return info;
+    }
+};
+
+struct ArchetypeChunk {
+    uint8_t* data;
+    Entity* entities;
+    uint32_t count;
+};
+
+class Archetype {
+public:
+    static const size_t kChunkBytes = 16 * 1024;
+
+    Archetype(ComponentMask mask);
+    ~Archetype();
+
+    ComponentMask GetMask() const { return m_mask; }
+    const std::vector<ComponentTypeId>& GetTypes() const { return m_types; }
+    uint32_t GetChunkCapacity() const { return m_chunkCapacity; }
+    size_t GetChunkCount() const { return m_chunks.size(); }
+    ArchetypeChunk& GetChunk(size_t index) { return m_chunks[index]; }
+    size_t GetEntityCount() const { return m_entityCount; }
+
+    bool Has(ComponentTypeId id) const { return (m_mask >> id) & 1; }
+    void* GetColumn(ArchetypeChunk& chunk, ComponentTypeId id) const {
+        return chunk.data + m_columnOffsets[id];
+    }
+    template<typename T>
+    T* GetColumn(ArchetypeChunk& chunk) const {
+        return static_cast<T*>(GetColumn(chunk, ComponentRegistry::GetId<T>()));
+    }
+
+    // Reserves a row at the end; its components are left unconstructed
+    void Allocate(Entity entity, uint32_t& outChunk, uint32_t& outRow);
+    // Fills the hole with the archetype's last row. Returns the entity that
+    // moved into (chunk, row), or a null entity if the removed row was last.
+    Entity Remove(uint32_t chunk, uint32_t row, bool destroyComponents);
+
+private:
+    friend class World;
+
+    ComponentMask m_mask;
+    std::vector<ComponentTypeId> m_types;
+    std::vector<ComponentTypeInfo> m_infos; // Parallel to m_types
+    size_t m_columnOffsets[kMaxComponentTypes];
+    size_t m_columnSizes[kMaxComponentTypes];
+    size_t m_chunkBytes;
+    uint32_t m_chunkCapacity;
+    std::vector<ArchetypeChunk> m_chunks;
+    size_t m_entityCount;
+
+    // Cached transitions when a single component is added or removed
+    std::unordered_map<ComponentTypeId, Archetype*> m_addEdges;
+    std::unordered_map<ComponentTypeId, Archetype*> m_removeEdges;
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+};
+
+// Entities, archetypes and systems. Structural changes (create/destroy,
+// add/remove component) must not happen inside Each/ParallelEach.
+class World {
+public:
+    typedef std::function<void(World& world, float deltaTime)> SystemFunction;
+
+    World();
+    ~World();
+
+    Entity CreateEntity();
+    template<typename... Ts>
+    Entity CreateEntity(const Ts&... components);
+    void DestroyEntity(Entity entity);
+    bool IsAlive(Entity entity) const;
+    void Clear();
+
+    template<typename T>
+    T* AddComponent(Entity entity, const T& component = T());
+    template<typename T>
+    void RemoveComponent(Entity entity);
+    template<typename T>
+    bool HasComponent(Entity entity) const;
+    // Null if the entity is dead or lacks the component. Invalidated by structural changes.
+    template<typename T>
+    T* GetComponent(Entity entity);
+
+    // Calls function(Ts&...) or function(Entity, Ts&...) for every entity having all Ts
+    template<typename... Ts, typename F>
+    void Each(F&& function);
+    // Same, with chunks spread over the job system's threads
+    template<typename... Ts, typename F>
+    void ParallelEach(F&& function);
+
+    // Systems run in the order they were added
+    void AddSystem(const std::string& name, SystemFunction function);
+    void RemoveSystem(const std::string& name);
+    void RunSystems(float deltaTime);
+
+    // position += velocity * deltaTime for every TransformComponent
+    void IntegrateTransforms(float deltaTime);
+
+    void SetJobSystem(JobSystem* jobSystem) { m_jobSystem = jobSystem; }
+    JobSystem* GetJobSystem() const { return m_jobSystem; }
+
+    size_t GetEntityCount() const { return m_entityCount; }
+    size_t GetArchetypeCount() const { return m_archetypes.size(); }
+
+private:
+    struct EntityRecord {
+        Archetype* archetype;
+        uint32_t chunk;
+        uint32_t row;
+        uint32_t generation;
+    };
+
+    template<typename... Ts>
+    static ComponentMask MaskOf() {
+        ComponentMask mask = 0;
+        ComponentTypeId ids[] = { ComponentRegistry::GetId<Ts>()..., 0 };
+        for (size_t i = 0; i < sizeof...(Ts); ++i) {
+            mask |= ComponentMask(1) << ids[i];
+        }
+        return mask;
+    }
+
+    template<typename... Ts, typename F>
+    static void RunChunk(Archetype& archetype, ArchetypeChunk& chunk, F& function) {
+        std::tuple<Ts*...> columns(archetype.GetColumn<Ts>(chunk)...);
+        for (uint32_t i = 0; i < chunk.count; ++i) {
+            if constexpr (std::is_invocable<F&, Entity, Ts&...>::value) {
+                function(chunk.entities[i], std::get<Ts*>(columns)[i]...);
+            } else {
+                function(std::get<Ts*>(columns)[i]...);
+            }
+        }
+    }
+
+    Entity AllocateEntity(Archetype* archetype);
+    Archetype* GetArchetype(ComponentMask mask);
+    Archetype* GetAddTarget(Archetype* source, ComponentTypeId id);
+    Archetype* GetRemoveTarget(Archetype* source, ComponentTypeId id);
+    // Moves the entity's shared components into target; components target
+    // lacks are destroyed, ones only target has are left unconstructed
+    void MoveEntity(Entity entity, Archetype* target);
+    void RemoveRow(EntityRecord& record, bool destroyComponents);
+    void* GetComponentData(Entity entity, ComponentTypeId id) const;
+
+    std::vector<EntityRecord> m_records;
+    std::vector<uint32_t> m_freeIndices;
+    size_t m_entityCount;
+
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::unordered_map<ComponentMask, Archetype*> m_archetypeLookup;
+
+    std::vector<std::pair<std::string, SystemFunction>> m_systems;
+    JobSystem* m_jobSystem;
+};
+
+// World template implementation
+template<typename... Ts>
+Entity World::CreateEntity(const Ts&... components) {
+    Archetype* archetype = GetArchetype(MaskOf<Ts...>());
+    Entity entity = AllocateEntity(archetype);
+    const EntityRecord& record = m_records[entity.index];
+    ArchetypeChunk& chunk = archetype->GetChunk(record.chunk);
+    (void)chunk;
+    (new (archetype->GetColumn<Ts>(chunk) + record.row) Ts(components), ...);
+    return entity;
+}
+
+template<typename T>
+T* World::AddComponent(Entity entity, const T& component) {
+    if (!IsAlive(entity)) return nullptr;
+
+    ComponentTypeId id = ComponentRegistry::GetId<T>();
+    EntityRecord& record = m_records[entity.index];
+    if (record.archetype->Has(id)) {
+        T* existing = static_cast<T*>(GetComponentData(entity, id));
+        *existing = component;
+        return existing;
+    }
+
+    MoveEntity(entity, GetAddTarget(record.archetype, id));
+    T* added = static_cast<T*>(GetComponentData(entity, id));
+    new (added) T(component);
+    return added;
+}
+
+template<typename T>
+void World::RemoveComponent(Entity entity) {
+    if (!HasComponent<T>(entity)) return;
+    EntityRecord& record = m_records[entity.index];
+    MoveEntity(entity, GetRemoveTarget(record.archetype, ComponentRegistry::GetId<T>()));
+}
+
+template<typename T>
+bool World::HasComponent(Entity entity) const {
+    return IsAlive(entity) && m_records[entity.index].archetype->Has(ComponentRegistry::GetId<T>());
+}
+
+template<typename T>
+T* World::GetComponent(Entity entity) {
+    return static_cast<T*>(GetComponentData(entity, ComponentRegistry::GetId<T>()));
+}
+
+template<typename... Ts, typename F>
+void World::Each(F&& function) {
+    ComponentMask mask = MaskOf<Ts...>();
+    for (auto& archetype : m_archetypes) {
+        if ((archetype->GetMask() & mask) != mask) continue;
+        for (size_t c = 0; c < archetype->GetChunkCount(); ++c) {
+            RunChunk<Ts...>(*archetype, archetype->GetChunk(c), function);
+        }
+    }
+}
+
+template<typename... Ts, typename F>
+void World::ParallelEach(F&& function) {
+    if (!m_jobSystem) {
+        Each<Ts...>(function);
+        return;
+    }
+
+    ComponentMask mask = MaskOf<Ts...>();
+    std::vector<std::pair<Archetype*, ArchetypeChunk*>> chunks;
+    for (auto& archetype : m_archetypes) {
+        if ((archetype->GetMask() & mask) != mask) continue;
+        for (size_t c = 0; c < archetype->GetChunkCount(); ++c) {
+            chunks.push_back({ archetype.get(), &archetype->GetChunk(c) });
+        }
+    }
+
+    // A few batches per thread keeps stealing effective without paying per-chunk overhead
+    size_t grain = std::max<size_t>(1, chunks.size() / (m_jobSystem->GetThreadCount() * 4));
+    m_jobSystem->ParallelFor(chunks.size(), grain, [&chunks, &function](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            RunChunk<Ts...>(*chunks[i].first, *chunks[i].second, function);
+        }
+    });
+}
@@ -8,6 +8,7 @@ class Renderer;
 class AudioManager;
 class InputManager;
 class AssetManager;
+class JobSystem;
 
 class Engine {
 public:
@@ -23,10 +24,24 @@ public:
     AudioManager* GetAudioManager() const { return m_audioManager.get(); }
     InputManager* GetInputManager() const { return m_inputManager.get(); }
     AssetManager* GetAssetManager() const { return m_assetManager.get(); }
+    JobSystem* GetJobSystem() const { return m_jobSystem.get(); }
+    
+    // Mounts a pack built by AssetPacker for both textures and sounds
+    bool MountAssetPack(const std::string& packPath);
     
     bool IsRunning() const { return m_isRunning; }
     void Quit() { m_isRunning = false; }
 
+    // Fixed-step mode: Update() always receives 1/tickRate and runs as many
+    // times as the elapsed frame time covers (up to the per-frame cap).
+    // Render() blends states with GetInterpolationAlpha().
+    void SetFixedTimestep(bool enabled, float tickRate = 60.0f);
+    void SetMaxStepsPerFrame(int steps) { m_maxStepsPerFrame = steps > 0 ? steps : 1; }
+    bool IsFixedTimestep() const { return m_fixedTimestep; }
+    float GetFixedDeltaTime() const { return m_fixedDeltaTime; }
+    int GetMaxStepsPerFrame() const { return m_maxStepsPerFrame; }
+    float GetInterpolationAlpha() const { return m_interpolationAlpha; }
+
 private:
     void HandleEvents();
     virtual void Update(float deltaTime);
@@ -39,6 +54,13 @@ private:
     std::unique_ptr<AudioManager> m_audioManager;
     std::unique_ptr<InputManager> m_inputManager;
     std::unique_ptr<AssetManager> m_assetManager;
+    std::unique_ptr<JobSystem> m_jobSystem;
     
     Uint64 m_lastTime;
+
+    bool m_fixedTimestep;
+    float m_fixedDeltaTime;
+    int m_maxStepsPerFrame;
+    double m_accumulator;
+    float m_interpolationAlpha;
 };
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+// Tracks outstanding jobs. Scheduling a job with a counter increments it and
+// the job decrements it when it finishes. Jobs scheduled with a counter as
+// their dependency are held back until it reaches zero.
+class JobCounter {
+public:
+    JobCounter() : m_value(0) {}
+
+    bool IsDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+    int GetValue() const { return m_value.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+
+    struct PendingJob {
+        std::function<void()> function;
+        JobCounter* signal;
+    };
+
+    std::atomic<int> m_value;
+    std::mutex m_mutex;
+    std::vector<PendingJob> m_dependents;
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+};
+
+// Work-stealing job scheduler. Each thread (main thread included) owns a
+// deque: it pushes and pops at the back, idle threads steal from the front.
+// The main thread only runs jobs while it is inside Wait/ParallelFor.
+class JobSystem {
+public:
+    typedef std::function<void()> JobFunction;
+    typedef std::function<void(size_t begin, size_t end)> RangeFunction;
+
+    // workerCount < 0 picks hardware threads - 1
+    explicit JobSystem(int workerCount = -1);
+    ~JobSystem();
+
+    void Schedule(JobFunction function, JobCounter* signal = nullptr, JobCounter* dependency = nullptr);
+
+    // Queue a job that must run on the main thread (SDL calls). Runs during
+    // RunMainThreadJobs or while the main thread waits.
+    void ScheduleMainThread(JobFunction function, JobCounter* signal = nullptr);
+    void RunMainThreadJobs();
+
+    // Blocks until the counter reaches zero, running other jobs meanwhile
+    void Wait(JobCounter& counter);
+
+    // Runs function over [0, count) in chunks of at most grainSize and blocks until done
+    void ParallelFor(size_t count, size_t grainSize, const RangeFunction& function);
+
+    int GetWorkerCount() const { return (int)m_workers.size(); }
+    int GetThreadCount() const { return (int)m_queues.size(); }
+
+    // 0 for the main thread (and any thread the system doesn't own), 1..N for workers
+    static int GetCurrentThreadIndex();
+
+private:
+    struct Job {
+        JobFunction function;
+        JobCounter* signal;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void Push(Job job);
+    bool Pop(int threadIndex, Job& job);
+    bool Steal(int threadIndex, Job& job);
+    bool RunOneMainThreadJob();
+    void Execute(Job& job);
+    void WorkerLoop(int threadIndex);
+
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+    std::thread::id m_mainThreadId;
+
+    std::mutex m_mainThreadMutex;
+    std::deque<Job> m_mainThreadJobs;
+
+    std::atomic<int> m_pendingJobs;
+    std::atomic<int> m_sleepingWorkers;
+    std::atomic<bool> m_quit;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "AudioMixer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A WAV file played without loading it: a reader thread decodes it in
+// kChunkFrames pieces into a ring of decoded frames that the mixer drains
+// from the audio thread. Memory stays at the ring plus one chunk whatever
+// the track's length. Handles 8/16/24/32-bit PCM and 32-bit float, keeps
+// the first two channels and converts to the mixer's rate with linear
+// interpolation.
+class MusicStream : public AudioStreamSource {
+public:
+    // Frames decoded per read
+    static constexpr int kChunkFrames = 4096;
+    // Decoded frames buffered ahead of the mixer; ~0.7 s at 48 kHz
+    static constexpr int kRingFrames = 32768;
+
+    struct Stats {
+        size_t bufferedFrames;  // Decoded and not yet mixed
+        uint64_t framesDecoded;
+        uint64_t bytesRead;
+        uint64_t underruns;     // Mix calls the ring couldn't fill
+        uint64_t underrunFrames; // Played as silence
+        size_t residentBytes;   // Ring and chunk buffers
+    };
+
+    explicit MusicStream(int sampleRate);
+    ~MusicStream();
+
+    // Reads and checks the header; no audio is decoded yet
+    bool Open(const std::string& path);
+    // Fills part of the ring, then starts the reader thread. loops: 0 plays
+    // once, n repeats n more times, -1 repeats until stopped. Without a
+    // reader thread Read decodes what it needs itself, for mixing offline
+    // faster than real time.
+    void Start(int loops, bool readerThread = true);
+
+    // Audio thread
+    int Read(float* output, int frames) override;
+    bool IsFinished() const override;
+    int GetChannels() const override { return m_outputChannels; }
+
+    Stats GetStats() const;
+    double GetDuration() const; // Seconds, one pass
+
+private:
+    bool ReadHeader(const std::string& path);
+    bool Rewind();
+    void ReadLoop();
+    // Decodes one chunk into the ring; false at the end of the data
+    bool DecodeChunk();
+    void ConvertChunk(int frames);
+    void WriteRing(const float* samples, int frames);
+    size_t GetFreeFrames() const;
+
+    int m_sampleRate;
+    std::FILE* m_file;
+
+    // Format, from the header
+    int m_format;           // 1 PCM, 3 float
+    int m_channels;
+    int m_fileRate;
+    int m_bitsPerSample;
+    int m_blockAlign;
+    long m_dataOffset;
+    uint32_t m_dataBytes;
+    int m_outputChannels;
+
+    // Reader thread
+    uint32_t m_dataRead;    // Bytes of this pass
+    int m_loops;
+    int m_chunkInput;       // File frames per chunk, so a resampled chunk fits m_resampled
+    bool m_decodeOnRead;
+    std::vector<uint8_t> m_raw;
+    std::vector<float> m_decoded;    // m_raw as float, at the file's rate
+    std::vector<float> m_resampled;
+    double m_step;          // File frames per output frame
+    double m_position;      // Into m_decoded; -1 is the last frame of the previous chunk
+    float m_lastFrame[2];
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_quit;
+
+    // Ring shared with the audio thread; both counters only grow
+    std::vector<float> m_ring;
+    std::atomic<size_t> m_readFrame;
+    std::atomic<size_t> m_writeFrame;
+    std::atomic<bool> m_endOfData;
+
+    std::atomic<uint64_t> m_framesDecoded;
+    std::atomic<uint64_t> m_bytesRead;
+    std::atomic<uint64_t> m_underruns;
+    std::atomic<uint64_t> m_underrunFrames;
+
+    MusicStream(const MusicStream&) = delete;
+    MusicStream& operator=(const MusicStream&) = delete;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+class ObjectPoolBase {
+public:
+    virtual ~ObjectPoolBase() {}
+
+    // Slabs requested from the heap so far; flat once the pool has warmed up
+    uint64_t GetSlabAllocations() const { return m_slabAllocations; }
+    size_t GetLiveCount() const { return m_liveCount; }
+    size_t GetCapacity() const { return m_capacity; }
+
+protected:
+    ObjectPoolBase() : m_slabAllocations(0), m_liveCount(0), m_capacity(0) {}
+
+    uint64_t m_slabAllocations;
+    size_t m_liveCount;
+    size_t m_capacity;
+};
+
+// Slab allocator for one type. Freed slots go on an intrusive free list and
+// are reused before a new slab is allocated; slabs are only released when
+// the pool is destroyed. Objects must be destroyed before the pool.
+template<typename T>
+class ObjectPool : public ObjectPoolBase {
+public:
+    explicit ObjectPool(size_t objectsPerSlab = 256)
+        : m_objectsPerSlab(objectsPerSlab > 0 ? objectsPerSlab : 1)
+        , m_freeList(nullptr)
+    {
+    }
+
+    ~ObjectPool() {
+        for (void* slab : m_slabs) {
+            ::operator delete(slab, std::align_val_t(kAlignment));
+        }
+    }
+
+    template<typename... Args>
+    T* Create(Args&&... args) {
+        if (!m_freeList) {
+            AllocateSlab();
+        }
+
+        FreeSlot* slot = m_freeList;
+        m_freeList = slot->next;
+        m_liveCount++;
+        return new (slot) T(std::forward<Args>(args)...);
+    }
+
+    void Destroy(T* object) {
+        if (!object) return;
+
+        object->~T();
+        FreeSlot* slot = new (object) FreeSlot;
+        slot->next = m_freeList;
+        m_freeList = slot;
+        m_liveCount--;
+    }
+
+private:
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    static const size_t kSlotSize = sizeof(T) > sizeof(FreeSlot) ? sizeof(T) : sizeof(FreeSlot);
+    static const size_t kAlignment = alignof(T) > alignof(FreeSlot) ? alignof(T) : alignof(FreeSlot);
+    static const size_t kStride = (kSlotSize + kAlignment - 1) / kAlignment * kAlignment;
+
+    void AllocateSlab() {
+        uint8_t* slab = (uint8_t*)::operator new(kStride * m_objectsPerSlab, std::align_val_t(kAlignment));
+        m_slabs.push_back(slab);
+        m_slabAllocations++;
+        m_capacity += m_objectsPerSlab;
+
+        // Thread the new slots onto the free list, lowest address first
+        for (size_t i = m_objectsPerSlab; i > 0; --i) {
+            FreeSlot* slot = new (slab + (i - 1) * kStride) FreeSlot;
+            slot->next = m_freeList;
+            m_freeList = slot;
+        }
+    }
+
+    size_t m_objectsPerSlab;
+    FreeSlot* m_freeList;
+    std::vector<void*> m_slabs;
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+};
@@ -4,15 +4,34 @@
 
 class Physics {
 public:
+    struct AABB;
+    
     struct Body {
         Vector2 position;
         Vector2 velocity;
         Vector2 acceleration;
         float mass;
         float restitution; // bounciness
+        float friction;
+        Vector2 size;      // Collision box centred on position; zero for none
         bool isStatic;
         
-        Body() : mass(1.0f), restitution(0.5f), isStatic(false) {}
+        // Bodies slower than sleepThreshold (px/s) for long enough are put to
+        // sleep by ContactSolver and skipped until something wakes them
+        bool isSleeping;
+        bool canSleep;
+        float sleepThreshold;
+        float sleepTime;   // Seconds spent below sleepThreshold
+        
+        // Fast and small, e.g. projectiles: ContactSolver sweeps it against
+        // the other bodies in any step that moves it further than its size
+        bool isBullet;
+        
+        Body() : mass(1.0f), restitution(0.5f), friction(0.4f), isStatic(false),
+                 isSleeping(false), canSleep(true), sleepThreshold(5.0f), sleepTime(0.0f),
+                 isBullet(false) {}
+        
+        AABB GetBounds() const;
     };
     
     struct AABB {
@@ -32,6 +51,15 @@ public:
     
     static void UpdateBody(Body& body, float deltaTime);
     static void ApplyGravity(Body& body, const Vector2& gravity);
+    // Changes velocity by impulse / mass and wakes the body
+    static void ApplyImpulse(Body& body, const Vector2& impulse);
+    // Needed after moving a sleeping body by hand
+    static void WakeBody(Body& body);
     static bool CheckCollision(const AABB& a, const AABB& b);
+    // Moves box by displacement and finds the first touch with target, as a
+    // fraction of the displacement, and the target's face normal. False if
+    // they never touch, or if they already overlap at the start.
+    static bool SweepAABB(const AABB& box, const Vector2& displacement, const AABB& target,
+                          float& timeOfImpact, Vector2& normal);
     static void ResolveCollision(Body& a, Body& b, const AABB& aabb1, const AABB& aabb2);
 };
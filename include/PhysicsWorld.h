@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Physics.h"
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+// Owns bodies in structure-of-arrays form so integration can run as one
+// SIMD pass (AVX when compiled with it, SSE2 otherwise, scalar fallback).
+// Bodies are addressed through stable handles; the dense arrays are
+// compacted with swap-and-pop on removal.
+class PhysicsWorld {
+public:
+    typedef uint32_t BodyId;
+    static const BodyId InvalidBody = 0xFFFFFFFFu;
+
+    PhysicsWorld();
+
+    BodyId AddBody(const Physics::Body& body);
+    void RemoveBody(BodyId id);
+    bool IsValid(BodyId id) const;
+    void Reserve(size_t count);
+    void Clear();
+
+    // Legacy Body access, copied in and out of the arrays
+    Physics::Body GetBody(BodyId id) const;
+    void SetBody(BodyId id, const Physics::Body& body);
+
+    Vector2 GetPosition(BodyId id) const;
+    void SetPosition(BodyId id, const Vector2& position);
+    Vector2 GetVelocity(BodyId id) const;
+    void SetVelocity(BodyId id, const Vector2& velocity);
+    void ApplyAcceleration(BodyId id, const Vector2& acceleration);
+    bool IsStatic(BodyId id) const;
+    void SetStatic(BodyId id, bool isStatic);
+
+    // Same result as Physics::ApplyGravity followed by Physics::UpdateBody
+    // for every body, in a single pass over the arrays. With a job system
+    // the arrays are split into blocks integrated in parallel.
+    void Step(float deltaTime, const Vector2& gravity = Vector2(0, 0), JobSystem* jobs = nullptr);
+
+    size_t GetBodyCount() const { return m_x.size(); }
+
+    // Dense array index of a body; invalidated by RemoveBody
+    uint32_t GetIndex(BodyId id) const { return m_idToIndex[id]; }
+    const float* GetPositionsX() const { return m_x.data(); }
+    const float* GetPositionsY() const { return m_y.data(); }
+    const float* GetVelocitiesX() const { return m_vx.data(); }
+    const float* GetVelocitiesY() const { return m_vy.data(); }
+
+private:
+    void IntegrateRange(size_t begin, size_t end, float deltaTime, const Vector2& gravity);
+    void SetStaticBit(size_t index, bool isStatic);
+    bool GetStaticBit(size_t index) const;
+
+    std::vector<float> m_x, m_y;
+    std::vector<float> m_vx, m_vy;
+    std::vector<float> m_ax, m_ay;
+    std::vector<float> m_mass;
+    std::vector<float> m_restitution;
+    std::vector<uint32_t> m_staticMask; // one bit per body
+    bool m_hasAcceleration; // any non-zero ax/ay since the last Step
+
+    std::vector<uint32_t> m_idToIndex;
+    std::vector<BodyId> m_indexToId;
+    std::vector<BodyId> m_freeIds;
+};
@@ -3,6 +3,7 @@
 #include <SDL3/SDL.h>
 #include <string>
 #include <memory>
+#include <vector>
 
 struct Vector2 {
     float x, y;
@@ -22,24 +23,122 @@ struct Rect {
     Rect(float x = 0, float y = 0, float w = 0, float h = 0) : x(x), y(y), width(w), height(h) {}
 };
 
+struct AtlasRegion;
+
+// Maps world coordinates to screen pixels for Renderer draws. The default
+// camera (position 0,0, zoom 1) is the identity, so world units are pixels.
+class Camera {
+public:
+    Camera();
+    
+    // Top-left corner of the view, in world units
+    void SetPosition(const Vector2& position) { m_position = position; }
+    const Vector2& GetPosition() const { return m_position; }
+    void SetCenter(const Vector2& center);
+    Vector2 GetCenter() const;
+    
+    // Above 1 magnifies
+    void SetZoom(float zoom);
+    float GetZoom() const { return m_zoom; }
+    
+    // In pixels; the renderer keeps this in sync with its output size
+    void SetViewportSize(float width, float height);
+    
+    // World area currently on screen
+    Rect GetViewRect() const;
+    bool IsVisible(const Rect& bounds) const;
+    bool IsIdentity() const { return m_zoom == 1.0f && m_position.x == 0.0f && m_position.y == 0.0f; }
+    
+    Vector2 WorldToScreen(const Vector2& point) const;
+    Vector2 ScreenToWorld(const Vector2& point) const;
+    Rect WorldToScreen(const Rect& rect) const;
+    
+private:
+    Vector2 m_position;
+    float m_zoom;
+    float m_viewportWidth;
+    float m_viewportHeight;
+};
+
 class Texture {
 public:
     Texture();
     ~Texture();
     
     bool LoadFromFile(SDL_Renderer* renderer, const std::string& path);
+    bool LoadFromSurface(SDL_Renderer* renderer, SDL_Surface* surface);
+    // Turns this texture into a sub-rect of a shared atlas page
+    void SetAtlasRegion(std::shared_ptr<AtlasRegion> region);
     void Free();
     
+    // Decodes an image file into a CPU surface (placeholder if it can't be decoded)
+    static SDL_Surface* LoadSurface(const std::string& path);
+    // Same for an encoded image already in memory; nameHint picks the decoder without SDL3_image
+    static SDL_Surface* LoadSurfaceFromMemory(const void* data, size_t size, const std::string& nameHint);
+    
     void Render(SDL_Renderer* renderer, int x, int y, SDL_Rect* clip = nullptr);
     void Render(SDL_Renderer* renderer, const Rect& destRect, SDL_Rect* clip = nullptr);
     
     int GetWidth() const { return m_width; }
     int GetHeight() const { return m_height; }
     
+    // Backing SDL texture: the atlas page for packed textures
+    SDL_Texture* GetSDLTexture() const;
+    bool IsAtlased() const { return m_region != nullptr; }
+    // Normalized UVs of sourceRect (or the whole texture) within GetSDLTexture()
+    SDL_FRect GetUVs(const Rect* sourceRect = nullptr) const;
+    
 private:
+    SDL_FRect GetSourceRect(const SDL_Rect* clip) const;
+    static SDL_Surface* CreatePlaceholderSurface(const std::string& name);
+    
     SDL_Texture* m_texture;
     int m_width;
     int m_height;
+    std::shared_ptr<AtlasRegion> m_region; // Follows the region if the atlas repacks
+};
+
+// Accumulates quads and submits them with one SDL_RenderGeometry call per
+// run of adjacent quads sharing a texture. Quads are sorted before
+// submission; quads with equal sort keys keep their submission order.
+class SpriteBatch {
+public:
+    enum class SortMode {
+        Depth,           // painter's order: by depth, then submission order
+        TextureThenDepth // fewest texture switches; only for sprites that don't overlap across textures
+    };
+    
+    struct Stats {
+        int quads;
+        int drawCalls;
+    };
+    
+    SpriteBatch();
+    
+    // texture may be null for solid-colour quads; uvs are normalized
+    void AddQuad(SDL_Texture* texture, const SDL_FRect& dest, const SDL_FRect& uvs, const Color& color, float depth);
+    void Flush(SDL_Renderer* renderer);
+    void Clear();
+    
+    void SetSortMode(SortMode mode) { m_sortMode = mode; }
+    SortMode GetSortMode() const { return m_sortMode; }
+    bool IsEmpty() const { return m_quads.empty(); }
+    const Stats& GetLastFlushStats() const { return m_lastFlushStats; }
+    
+private:
+    struct Quad {
+        SDL_Texture* texture;
+        float depth;
+        SDL_FRect dest;
+        SDL_FRect uvs;
+        SDL_FColor color;
+    };
+    
+    std::vector<Quad> m_quads;
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int> m_indices;
+    SortMode m_sortMode;
+    Stats m_lastFlushStats;
 };
 
 class Renderer {
@@ -55,8 +154,33 @@ public:
     void DrawTexture(Texture* texture, const Vector2& position, const Rect* sourceRect = nullptr);
     void DrawTexture(Texture* texture, const Rect& destRect, const Rect* sourceRect = nullptr);
     
+    // Batch mode: DrawRect/DrawTexture queue quads into the sprite batch,
+    // which is flushed by FlushBatch, Present or when batching is turned off
+    void SetBatchingEnabled(bool enabled);
+    bool IsBatchingEnabled() const { return m_batching; }
+    void FlushBatch();
+    SpriteBatch& GetSpriteBatch() { return m_spriteBatch; }
+    
+    // Depth for subsequent draws in batch mode; lower depths draw first
+    void SetDrawDepth(float depth) { m_drawDepth = depth; }
+    float GetDrawDepth() const { return m_drawDepth; }
+    
+    // Draws go through the camera; disable it for screen-space overlays
+    Camera& GetCamera() { return m_camera; }
+    const Camera& GetCamera() const { return m_camera; }
+    void SetCameraEnabled(bool enabled) { m_cameraEnabled = enabled; }
+    bool IsCameraEnabled() const { return m_cameraEnabled; }
+    
     SDL_Renderer* GetSDLRenderer() const { return m_renderer; }
     
 private:
+    void BatchTexture(Texture* texture, const SDL_FRect& dest, const Rect* sourceRect);
+    bool UsesCamera() const { return m_cameraEnabled && !m_camera.IsIdentity(); }
+    
     SDL_Renderer* m_renderer;
+    Camera m_camera;
+    bool m_cameraEnabled;
+    SpriteBatch m_spriteBatch;
+    bool m_batching;
+    float m_drawDepth;
 };
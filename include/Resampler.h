@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Converts float PCM between sample rates with a polyphase windowed-sinc
+// filter. Meant for load time, where quality matters more than speed: the
+// ratio is reduced to up/down, and each output frame is a kTaps-wide dot
+// product with one phase of a Kaiser-windowed sinc. Ratios with more
+// phases than kMaxPhases interpolate between neighbouring tabulated
+// phases. Downsampling lowers the cutoff below the output's Nyquist so
+// nothing aliases.
+class Resampler {
+public:
+    // Filter length when upsampling; downsampling widens it by the ratio
+    static constexpr int kTaps = 64;
+    static constexpr int kMaxPhases = 512;
+
+    Resampler(int inputRate, int outputRate);
+
+    // Interleaved frames of any channel count; output is overwritten.
+    // Input beyond either end counts as silence.
+    void Process(const float* input, int frames, int channels, std::vector<float>& output) const;
+    int GetOutputFrames(int inputFrames) const;
+    bool IsPassthrough() const { return m_up == m_down; }
+
+private:
+    int m_up;
+    int m_down;
+    int m_taps;
+    int m_phases;                 // Tabulated phases; m_filter holds one more row
+    std::vector<float> m_filter;  // Row per phase, m_taps coefficients each
+};
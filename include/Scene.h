@@ -1,6 +1,15 @@
 #pragma once
 
 #include "Renderer.h"
+#include "Broadphase.h"
+#include "ECS.h"
+#include "ObjectPool.h"
+#include "TransformHierarchy.h"
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <typeindex>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 
@@ -8,6 +17,29 @@
 class Engine;
 class GameObject;
 
+// 32-bit reference to a GameObject in a Scene: 20 bits of slot index and 12
+// bits of generation. The slot's generation changes when its object is
+// destroyed, so stale handles resolve to nullptr instead of a new object.
+// Freed slots are reused oldest first, and a slot is retired once its
+// generation wraps, so a stale handle never matches a later object.
+struct GameObjectHandle {
+    static const uint32_t kIndexBits = 20;
+    static const uint32_t kIndexMask = (1u << kIndexBits) - 1;
+    static const uint32_t kGenerationMask = (1u << (32 - kIndexBits)) - 1;
+    
+    uint32_t value;
+    
+    GameObjectHandle() : value(0xFFFFFFFFu) {}
+    GameObjectHandle(uint32_t index, uint32_t generation)
+        : value((index & kIndexMask) | ((generation & kGenerationMask) << kIndexBits)) {}
+    
+    uint32_t GetIndex() const { return value & kIndexMask; }
+    uint32_t GetGeneration() const { return value >> kIndexBits; }
+    bool IsNull() const { return value == 0xFFFFFFFFu; }
+    bool operator==(const GameObjectHandle& other) const { return value == other.value; }
+    bool operator!=(const GameObjectHandle& other) const { return value != other.value; }
+};
+
 class Scene {
 public:
     Scene();
@@ -18,15 +50,188 @@ public:
     virtual void Render(Renderer* renderer);
     virtual void Cleanup() {}
     
-    void AddGameObject(std::shared_ptr<GameObject> obj);
+    struct AllocationStats {
+        uint64_t poolSlabAllocations; // Object storage requested from the heap
+        uint64_t containerGrowths;    // Times a scene-owned list had to reallocate
+        uint64_t spawned;
+        uint64_t destroyed;
+        size_t liveObjects;
+    };
+    
+    // Constructs a T in a per-type object pool; the scene owns it until Destroy.
+    // Steady-state spawn/destroy churn reuses pool and list memory. Inside the
+    // parallel phase the spawn is deferred and a null handle is returned.
+    template<typename T, typename... Args>
+    GameObjectHandle Spawn(Args&&... args);
+    void Destroy(GameObjectHandle handle);
+    
+    // Null for stale or null handles
+    GameObject* Get(GameObjectHandle handle) const;
+    template<typename T>
+    T* Get(GameObjectHandle handle) const { return static_cast<T*>(Get(handle)); }
+    bool IsValid(GameObjectHandle handle) const { return Get(handle) != nullptr; }
+    
+    // Safe to call from inside Update: while the scene is updating, spawns and
+    // despawns are buffered and applied at the end of Update
+    GameObjectHandle AddGameObject(std::shared_ptr<GameObject> obj);
     void RemoveGameObject(std::shared_ptr<GameObject> obj);
+    // The sync point; Update calls it after all objects have been updated
+    void ApplyPendingChanges();
+    
+    struct RenderStats {
+        int drawn;
+        int culled;
+        int cellsVisited; // Spatial hash cells (or proxies) examined by the view query
+    };
+    
+    // Objects with a non-zero size are culled against the renderer's camera
+    // through a spatial hash of their bounds, so Render only visits the
+    // cells under the view. Draw order is unchanged; zero-sized objects
+    // always draw. Bounds are refreshed at the end of Update.
+    void SetCullingEnabled(bool enabled);
+    bool IsCullingEnabled() const { return m_cullingEnabled; }
+    // World units added around the view, for drawing outside the bounds and interpolation
+    void SetCullingMargin(float margin) { m_cullingMargin = margin; }
+    float GetCullingMargin() const { return m_cullingMargin; }
+    // Counts for the last Render
+    const RenderStats& GetRenderStats() const { return m_renderStats; }
+    
+    AllocationStats GetAllocationStats() const;
+    size_t GetGameObjectCount() const { return m_gameObjects.size(); }
     
     Engine* GetEngine() const { return m_engine; }
     void SetEngine(Engine* engine) { m_engine = engine; }
     
+    // Blend factor between the previous and current update, valid during Render
+    float GetInterpolationAlpha() const { return m_interpolationAlpha; }
+    
+    // Parallel update: objects with threadSafe set are updated in batches on
+    // the job system, then the rest run serially on the calling thread.
+    // During the parallel phase Spawn/AddGameObject/Destroy are buffered per
+    // batch and applied afterwards in object order, as a serial update would;
+    // use Defer for anything else that touches other objects or the scene.
+    void SetParallelUpdate(bool enabled, size_t batchSize = 512);
+    bool IsParallelUpdate() const { return m_parallelUpdate; }
+    // Defaults to the engine's job system
+    void SetJobSystem(JobSystem* jobSystem) { m_jobSystem = jobSystem; }
+    JobSystem* GetJobSystem() const;
+    // Runs command right away, or after the parallel phase if called inside it
+    void Defer(std::function<void()> command);
+    bool IsInParallelPhase() const { return m_parallelPhase; }
+    
+    // Copies position/rotation/scale of parented objects into the transform
+    // hierarchy and recomputes world matrices of the subtrees that changed.
+    // Update calls it after the sync point; call it directly to read world
+    // transforms right after moving a parent.
+    void UpdateTransforms();
+    TransformHierarchy& GetTransformHierarchy() { return m_transforms; }
+    
+    // Optional ECS world, created on first use. Its systems run at the end of Update.
+    World& GetWorld();
+    bool HasWorld() const { return m_world != nullptr; }
+    // Replaces a GameObject with an entity carrying its TransformComponent
+    Entity MigrateToWorld(GameObjectHandle handle);
+    Entity MigrateToWorld(std::shared_ptr<GameObject> obj);
+    
 protected:
-    std::vector<std::shared_ptr<GameObject>> m_gameObjects;
+    friend class GameObject;
+    
+    typedef void (*PoolDestroyFunction)(ObjectPoolBase* pool, GameObject* obj);
+    
+    // Owner of one slot: a pooled object or a shared_ptr added by the game
+    // Freed slots queue up to this many before the oldest is reused, so one
+    // hot slot doesn't cycle through its generations every frame
+    static constexpr size_t kMinFreeSlots = 1024;
+    
+    struct ObjectSlot {
+        GameObject* object;
+        uint32_t generation;
+        ObjectPoolBase* pool;
+        PoolDestroyFunction destroy;
+        std::shared_ptr<GameObject> shared;
+    };
+    
+    template<typename T>
+    ObjectPool<T>& GetPool();
+    GameObjectHandle Register(GameObject* obj, ObjectPoolBase* pool, PoolDestroyFunction destroy,
+                              std::shared_ptr<GameObject> shared);
+    void ReleaseSlot(uint32_t index);
+    void QueueRemoval(GameObject* obj);
+    void DestroyAllObjects();
+    template<typename V>
+    void PushTracked(std::vector<V>& list, V value);
+    
+    // A side effect recorded during the parallel phase
+    struct BatchCommand {
+        enum class Type { Deactivate, Destroy, Add, Deferred };
+        Type type;
+        GameObject* object;
+        GameObjectHandle handle;
+        std::shared_ptr<GameObject> added;
+        std::function<void()> deferred;
+    };
+    
+    // Side effects of one batch, in the order its objects made them
+    struct alignas(64) BatchCommands {
+        std::vector<BatchCommand> commands;
+    };
+    
+    bool SetParent(GameObject* child, GameObject* parent, bool keepWorldTransform);
+    // Re-links child in the hierarchy and writes its new local transform back
+    bool ReparentTransform(GameObject* child, TransformId parent, bool keepWorldTransform);
+    TransformId GetOrCreateTransform(GameObject* obj);
+    // Detaches children (keeping their world transform) and drops obj's node;
+    // call SyncTransformsForRemoval first
+    void ReleaseTransform(GameObject* obj);
+    void SyncTransformsForRemoval(const std::vector<GameObject*>& removed);
+    
+    // Syncs the culling grid with the current object bounds
+    void UpdateCulling();
+    void RemoveCullProxy(GameObject* obj);
+    
+    void UpdateObject(GameObject* obj, float deltaTime);
+    void UpdateParallel(JobSystem* jobs, float deltaTime);
+    void RecordCommand(BatchCommand command);
+    void MergeBatchCommands();
+    
+    // Live objects in update/draw order, densely packed
+    std::vector<GameObject*> m_gameObjects;
+    std::vector<GameObject*> m_pendingAdds;
+    std::vector<GameObject*> m_pendingRemovals;
+    bool m_updating;
+    bool m_structureDirty;
+    
+    std::vector<ObjectSlot> m_slots;
+    std::vector<uint32_t> m_freeSlots;  // FIFO: entries before m_freeHead are taken
+    size_t m_freeHead;
+    std::unordered_map<std::type_index, std::unique_ptr<ObjectPoolBase>> m_pools;
+    uint64_t m_containerGrowths;
+    uint64_t m_spawned;
+    uint64_t m_destroyed;
+    
+    bool m_parallelUpdate;
+    bool m_parallelPhase;
+    size_t m_parallelBatchSize;
+    JobSystem* m_jobSystem;
+    std::vector<BatchCommands> m_batchCommands; // Indexed by begin / m_parallelBatchSize
+    
+    // Only objects that have a parent or children get a node
+    TransformHierarchy m_transforms;
+    std::vector<TransformId> m_childScratch;
+    
+    SpatialHash m_cullGrid;
+    std::vector<GameObject*> m_cullProxyObjects; // Indexed by proxy
+    std::vector<GameObject*> m_alwaysVisible;
+    std::vector<int> m_visibleProxies;
+    std::vector<GameObject*> m_visibleObjects;
+    bool m_cullingEnabled;
+    bool m_cullingDirty;
+    float m_cullingMargin;
+    RenderStats m_renderStats;
+    
+    std::unique_ptr<World> m_world;
     Engine* m_engine;
+    float m_interpolationAlpha;
 };
 
 class GameObject {
@@ -37,13 +242,95 @@ public:
     virtual void Update(float deltaTime) {}
     virtual void Render(Renderer* renderer) {}
     
+    // Position/rotation blended by the scene's interpolation alpha; use these in Render
+    Vector2 GetRenderPosition() const;
+    float GetRenderRotation() const;
+    // Call after teleporting so the object doesn't slide from its old position
+    void ResetInterpolation();
+    
+    TransformComponent GetTransform() const;
+    void SetTransform(const TransformComponent& transform);
+    
+    // Once parented, position/rotation/scale are relative to the parent. With
+    // keepWorldTransform they are rewritten so the object doesn't move on
+    // screen. nullptr detaches. Both objects must be in the same scene.
+    bool SetParent(GameObject* parent, bool keepWorldTransform = true);
+    GameObject* GetParent() const;
+    // As of the last Scene::UpdateTransforms; same as the local fields for
+    // objects outside a hierarchy
+    Matrix2D GetWorldMatrix() const;
+    Vector2 GetWorldPosition() const;
+    float GetWorldRotation() const;
+    
+    // World-space box around what Render draws: size at position, rotated
+    // and scaled. Override for objects that draw elsewhere.
+    virtual Rect GetBounds() const;
+    
+    // Null until the object is added to a scene
+    GameObjectHandle GetHandle() const { return m_handle; }
+    
     Vector2 position;
     Vector2 velocity;
     float rotation;
     Vector2 scale;
+    // Drawn extent from position, before rotation/scale; zero means unknown
+    // and the object is never culled
+    Vector2 size;
     bool active;
+    // Update only touches this object's own state (other objects and the
+    // scene via Scene::Defer), so it may run on a worker thread
+    bool threadSafe;
+    
+    // State at the start of the last update, written by Scene::Update
+    Vector2 previousPosition;
+    float previousRotation;
     
 protected:
     Scene* m_scene;
     friend class Scene;
+    
+private:
+    GameObjectHandle m_handle;
+    TransformId m_transformId;
+    int m_cullProxy;
+    // Position in Scene::m_gameObjects, for swap-and-pop removal
+    size_t m_sceneIndex;
+    bool m_pendingRemoval;
 };
+
+// Scene template implementation
+template<typename T, typename... Args>
+GameObjectHandle Scene::Spawn(Args&&... args) {
+    // Pools aren't thread-safe; the handle only exists once the spawn runs
+    if (m_parallelPhase) {
+        Defer([this, arguments = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+            std::apply([this](auto&&... unpacked) { Spawn<T>(std::move(unpacked)...); }, std::move(arguments));
+        });
+        return GameObjectHandle();
+    }
+    
+    ObjectPool<T>& pool = GetPool<T>();
+    T* obj = pool.Create(std::forward<Args>(args)...);
+    
+    PoolDestroyFunction destroy = [](ObjectPoolBase* base, GameObject* object) {
+        static_cast<ObjectPool<T>*>(base)->Destroy(static_cast<T*>(object));
+    };
+    return Register(obj, &pool, destroy, nullptr);
+}
+
+template<typename T>
+ObjectPool<T>& Scene::GetPool() {
+    std::unique_ptr<ObjectPoolBase>& pool = m_pools[std::type_index(typeid(T))];
+    if (!pool) {
+        pool = std::make_unique<ObjectPool<T>>();
+    }
+    return static_cast<ObjectPool<T>&>(*pool);
+}
+
+template<typename V>
+void Scene::PushTracked(std::vector<V>& list, V value) {
+    if (list.size() == list.capacity()) {
+        m_containerGrowths++;
+    }
+    list.push_back(std::move(value));
+}
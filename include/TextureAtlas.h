@@ -0,0 +1,108 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <memory>
+#include <vector>
+
+// Skyline bottom-left rectangle packer. The area can grow later without
+// moving anything already placed. Space is never handed back one rect at a
+// time; TextureAtlas repacks a page instead.
+class SkylinePacker {
+public:
+    SkylinePacker(int width, int height);
+
+    bool Insert(int width, int height, int& outX, int& outY);
+    void Grow(int newWidth, int newHeight);
+
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+
+private:
+    struct Node {
+        int x, y, width;
+    };
+
+    bool Fits(size_t index, int width, int height, int& outY) const;
+
+    std::vector<Node> m_skyline;
+    int m_width;
+    int m_height;
+};
+
+struct AtlasRegion;
+
+// One shared atlas texture. Regions packed into it keep it alive.
+struct AtlasPage {
+    AtlasPage(SDL_Texture* texture, int width, int height);
+    ~AtlasPage();
+
+    SDL_Texture* texture;
+    SkylinePacker packer;
+    std::vector<AtlasRegion*> regions; // Live regions; each removes itself when destroyed
+    long long usedPixels;
+    int textureCount;
+};
+
+// A texture's place in the atlas. Repacking may move it to another page;
+// textures holding it follow along. Destroying it gives its pixels back.
+struct AtlasRegion {
+    ~AtlasRegion();
+
+    std::shared_ptr<AtlasPage> page;
+    SDL_Rect rect;
+};
+
+// Packs small surfaces into shared render-target pages. A full page first
+// doubles in size (keeping existing sub-rects valid); a new page is opened
+// only once it has reached the maximum size. Pages whose regions are all
+// gone are released; Repack compacts pages left sparse by released regions.
+class TextureAtlas {
+public:
+    struct PageStats {
+        int width;
+        int height;
+        int textureCount;
+        long long usedPixels;
+        float occupancy;
+    };
+
+    struct Stats {
+        int pageCount;
+        int textureCount;
+        long long usedPixels;
+        long long totalPixels;
+        float occupancy;
+        std::vector<PageStats> pages;
+    };
+
+    TextureAtlas(int initialPageSize = 256, int maxPageSize = 2048, int padding = 1);
+
+    // Copies the surface into a page. Null if it can't fit an empty maximum-size page.
+    std::shared_ptr<AtlasRegion> Add(SDL_Renderer* renderer, SDL_Surface* surface);
+    // Drops the atlas' own references; pages live on while textures use them
+    void Clear();
+    // Drops pages with no regions left, returning the pixels freed
+    long long ReleaseEmptyPages();
+    // Packs every live region afresh into as few pages as it needs, if that
+    // takes fewer pixels than the pages hold now. Replaces page textures, so
+    // nothing queued for drawing may still use them. Returns the pixels freed.
+    long long Repack(SDL_Renderer* renderer);
+
+    Stats GetStats() const;
+    // Cheap totals over all pages
+    long long GetUsedPixels() const;
+    long long GetTotalPixels() const;
+    int GetMaxPageSize() const { return m_maxPageSize; }
+
+private:
+    std::shared_ptr<AtlasPage> CreatePage(SDL_Renderer* renderer, int width, int height);
+    bool GrowPage(SDL_Renderer* renderer, AtlasPage& page);
+    // The size a page grows to next; false once it is at the maximum
+    bool NextPageSize(int& width, int& height) const;
+    int InitialPageSize(int width, int height) const;
+
+    std::vector<std::shared_ptr<AtlasPage>> m_pages;
+    int m_initialPageSize;
+    int m_maxPageSize;
+    int m_padding;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Renderer.h"
+#include <cstdint>
+#include <vector>
+
+// 2D affine transform: x' = a*x + c*y + tx, y' = b*x + d*y + ty.
+// Rotations are in degrees, like GameObject::rotation.
+struct Matrix2D {
+    float a, b, c, d, tx, ty;
+
+    Matrix2D() : a(1), b(0), c(0), d(1), tx(0), ty(0) {}
+
+    static Matrix2D FromTransform(const Vector2& position, float rotation, const Vector2& scale);
+
+    // (*this * other) applies other first
+    Matrix2D operator*(const Matrix2D& other) const;
+    Vector2 TransformPoint(const Vector2& point) const;
+    Matrix2D Inverse() const;
+
+    Vector2 GetPosition() const { return Vector2(tx, ty); }
+    float GetRotation() const;
+    // Exact for rotation + scale; skew from non-uniform parent scales is dropped
+    Vector2 GetScale() const;
+};
+
+typedef uint32_t TransformId;
+static const TransformId kInvalidTransform = 0xFFFFFFFFu;
+
+// Parent/child transforms with cached local-to-world matrices. Nodes are
+// kept in a contiguous array sorted by depth, so every parent comes before
+// its children and Update is a single forward pass. Only nodes whose local
+// transform changed, and their descendants, are recomputed; a hierarchy
+// with nothing dirty costs nothing to update. Ids stay stable while the
+// array is reordered.
+class TransformHierarchy {
+public:
+    TransformHierarchy();
+
+    // New root with an identity local transform
+    TransformId Create(void* owner = nullptr);
+    // Children become roots, keeping their world transform
+    void Destroy(TransformId id);
+    bool IsValid(TransformId id) const;
+    void Clear();
+
+    // kInvalidTransform detaches. With keepWorldTransform the local transform
+    // is rewritten so the world transform doesn't change. Fails on cycles.
+    bool SetParent(TransformId id, TransformId parent, bool keepWorldTransform = true);
+    TransformId GetParent(TransformId id) const;
+    void GetChildren(TransformId id, std::vector<TransformId>& outChildren) const;
+    bool HasChildren(TransformId id) const;
+    // Makes every child a root with its world matrix as of the last Update
+    // as the new local transform. Doesn't update, so detaching the children
+    // of many nodes costs one order rebuild, at the next Update.
+    void DetachChildren(TransformId id);
+    void* GetOwner(TransformId id) const;
+
+    // Marks the node dirty only if the values actually changed
+    void SetLocal(TransformId id, const Vector2& position, float rotation, const Vector2& scale);
+    void GetLocal(TransformId id, Vector2& position, float& rotation, Vector2& scale) const;
+
+    // World matrices as of the last Update
+    const Matrix2D& GetWorldMatrix(TransformId id) const;
+    // World matrix before this frame's first change, for render interpolation
+    const Matrix2D& GetPreviousWorldMatrix(TransformId id) const;
+    // Makes the previous world matrix match the current one after the next Update
+    void ResetInterpolation(TransformId id);
+
+    // Starts a new frame for GetPreviousWorldMatrix
+    void BeginFrame() { m_frame++; }
+    // Recomputes dirty subtrees; returns the number of matrices recomputed
+    size_t Update();
+
+    // Dense access in depth order, for syncing locals from their owners.
+    // Indices are invalidated by Create/Destroy/SetParent followed by Update.
+    size_t GetNodeCount() const { return m_nodes.size(); }
+    void* GetOwnerAt(size_t index) const;
+    void SetLocalAt(size_t index, const Vector2& position, float rotation, const Vector2& scale);
+
+    size_t GetLastUpdateCount() const { return m_lastUpdateCount; }
+
+private:
+    static const uint32_t kNoParent = 0xFFFFFFFFu;
+
+    // Hot per-node data, in depth order
+    struct Node {
+        TransformId id;
+        uint32_t parent; // Dense index
+        bool dirty;
+        bool resetInterpolation;
+        Vector2 position;
+        float rotation;
+        Vector2 scale;
+    };
+
+    struct Record {
+        uint32_t dense;
+        TransformId parent;
+        // Siblings form a doubly linked list, so children are found and
+        // unlinked without a scan
+        TransformId firstChild;
+        TransformId previousSibling;
+        TransformId nextSibling;
+        void* owner;
+        bool alive;
+    };
+
+    void LinkChild(TransformId id, TransformId parent);
+    void UnlinkChild(TransformId id);
+    void MarkDirty(size_t index);
+    // Drops destroyed nodes and re-sorts by depth
+    void RebuildOrder();
+
+    std::vector<Node> m_nodes;
+    std::vector<Matrix2D> m_world;
+    std::vector<Matrix2D> m_previousWorld;
+    std::vector<uint32_t> m_changedPass;  // Update pass that last recomputed the node
+    std::vector<uint32_t> m_changedFrame; // Frame in which m_previousWorld was captured
+
+    std::vector<Record> m_records;
+    std::vector<TransformId> m_freeIds;
+
+    bool m_orderDirty;
+    size_t m_firstDirty;
+    uint32_t m_pass;
+    uint32_t m_frame;
+    size_t m_lastUpdateCount;
+};
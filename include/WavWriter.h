@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Writes 16-bit PCM WAV files a block at a time, so a long render never
+// has to be held in memory. The header's sizes are filled in by Close.
+class WavWriter {
+public:
+    WavWriter();
+    ~WavWriter(); // Closes
+
+    bool Open(const std::string& path, int channels, int sampleRate);
+    // Interleaved samples
+    bool Write(const int16_t* samples, int frames);
+    bool Close();
+
+    bool IsOpen() const { return m_file != nullptr; }
+    uint32_t GetFrames() const { return m_frames; }
+
+private:
+    std::FILE* m_file;
+    int m_channels;
+    int m_sampleRate;
+    uint32_t m_frames;
+
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+};
@@ -1,10 +1,32 @@
 #include "AssetManager.h"
+#include <climits>
 #include <iostream>
 
-AssetManager::AssetManager() : m_renderer(nullptr) {
+AssetManager::AssetManager()
+    : m_renderer(nullptr)
+    , m_jobSystem(nullptr)
+    , m_cacheBudget(256 * 1024 * 1024)
+    , m_cacheBytes(0)
+    , m_cacheHits(0)
+    , m_cacheMisses(0)
+    , m_cacheEvictions(0)
+    , m_uploadBudgetNS(2000000) // 2 ms
+    , m_maxUploadsPerFrame(16)
+    , m_atlasMaxSpriteSize(256)
+{
 }
 
 AssetManager::~AssetManager() {
+    WaitForAsyncLoads();
+    
+    // Decoded but never uploaded
+    for (auto& decoded : m_uploadQueue) {
+        if (decoded.surface) {
+            SDL_DestroySurface(decoded.surface);
+        }
+    }
+    m_uploadQueue.clear();
+    
     UnloadAllTextures();
 }
 
@@ -12,13 +34,19 @@ std::shared_ptr<Texture> AssetManager::LoadTexture(const std::string& name, cons
     // Check if texture is already loaded
     auto it = m_textures.find(name);
     if (it != m_textures.end()) {
-        return it->second;
+        return Touch(it->second);
     }
+    m_cacheMisses++;
     
     // Load new texture
-    auto texture = std::make_shared<Texture>();
-    if (texture->LoadFromFile(m_renderer->GetSDLRenderer(), path)) {
-        m_textures[name] = texture;
+    SDL_Surface* surface = LoadSurface(path);
+    auto texture = surface ? CreateTexture(surface) : nullptr;
+    if (surface) {
+        SDL_DestroySurface(surface);
+    }
+    
+    if (texture) {
+        AddToCache(name, texture);
         std::cout << "Loaded texture: " << name << " from " << path << std::endl;
         return texture;
     }
@@ -30,20 +58,286 @@ std::shared_ptr<Texture> AssetManager::LoadTexture(const std::string& name, cons
 std::shared_ptr<Texture> AssetManager::GetTexture(const std::string& name) {
     auto it = m_textures.find(name);
     if (it != m_textures.end()) {
-        return it->second;
+        return Touch(it->second);
     }
+    m_cacheMisses++;
     return nullptr;
 }
 
 void AssetManager::UnloadTexture(const std::string& name) {
     auto it = m_textures.find(name);
     if (it != m_textures.end()) {
+        m_cacheBytes -= it->second.bytes;
+        m_recency.erase(it->second.recency);
         m_textures.erase(it);
+        m_atlas.ReleaseEmptyPages();
         std::cout << "Unloaded texture: " << name << std::endl;
     }
 }
 
 void AssetManager::UnloadAllTextures() {
     m_textures.clear();
+    m_recency.clear();
+    m_cacheBytes = 0;
+    m_atlas.Clear();
     std::cout << "All textures unloaded" << std::endl;
 }
+
+void AssetManager::SetCacheBudget(size_t bytes) {
+    m_cacheBudget = bytes;
+    EvictToBudget();
+}
+
+AssetManager::CacheStats AssetManager::GetCacheStats() const {
+    CacheStats stats;
+    stats.hits = m_cacheHits;
+    stats.misses = m_cacheMisses;
+    stats.evictions = m_cacheEvictions;
+    stats.bytes = GetCacheBytes();
+    stats.budget = m_cacheBudget;
+    stats.textureCount = (int)m_textures.size();
+    return stats;
+}
+
+void AssetManager::ResetCacheStats() {
+    m_cacheHits = 0;
+    m_cacheMisses = 0;
+    m_cacheEvictions = 0;
+}
+
+void AssetManager::PrintCacheStats() const {
+    Uint64 lookups = m_cacheHits + m_cacheMisses;
+    std::cout << "Texture cache: " << m_textures.size() << " textures, "
+              << GetCacheBytes() / 1024 << " / " << m_cacheBudget / 1024 << " KB, "
+              << m_cacheHits << " hits, " << m_cacheMisses << " misses ("
+              << (lookups > 0 ? (int)(m_cacheHits * 100 / lookups) : 0) << "% hit rate), "
+              << m_cacheEvictions << " evictions" << std::endl;
+}
+
+std::shared_ptr<Texture> AssetManager::Touch(CachedTexture& entry) {
+    m_cacheHits++;
+    m_recency.splice(m_recency.begin(), m_recency, entry.recency);
+    return entry.texture;
+}
+
+void AssetManager::AddToCache(const std::string& name, const std::shared_ptr<Texture>& texture) {
+    UnloadTexture(name);
+    
+    CachedTexture entry;
+    entry.texture = texture;
+    entry.bytes = texture->IsAtlased() ? 0 : (size_t)texture->GetWidth() * texture->GetHeight() * 4;
+    m_recency.push_front(name);
+    entry.recency = m_recency.begin();
+    
+    m_cacheBytes += entry.bytes;
+    m_textures[name] = entry;
+    
+    EvictToBudget();
+}
+
+void AssetManager::EvictToBudget() {
+    if (m_cacheBudget == 0 || GetCacheBytes() <= m_cacheBudget) return;
+    
+    // Oldest first; textures still referenced elsewhere are skipped and
+    // become candidates again once released. An atlased texture frees
+    // nothing until its page is released or repacked, so the loop stops
+    // once what the pages would hold after compaction fits.
+    bool evictedAtlased = false;
+    auto it = m_recency.end();
+    while (it != m_recency.begin() && m_cacheBytes + (size_t)m_atlas.GetUsedPixels() * 4 > m_cacheBudget) {
+        --it;
+        auto entry = m_textures.find(*it);
+        if (entry->second.texture.use_count() > 1) continue;
+        
+        evictedAtlased |= entry->second.texture->IsAtlased();
+        m_cacheBytes -= entry->second.bytes;
+        m_textures.erase(entry);
+        it = m_recency.erase(it);
+        m_cacheEvictions++;
+    }
+    
+    if (evictedAtlased) {
+        CompactAtlas();
+    }
+}
+
+size_t AssetManager::GetCacheBytes() const {
+    return m_cacheBytes + (size_t)m_atlas.GetTotalPixels() * 4;
+}
+
+size_t AssetManager::CompactAtlas() {
+    long long freed = m_atlas.ReleaseEmptyPages();
+    if (m_renderer) {
+        // Repacking replaces page textures, so nothing queued may still point at them
+        m_renderer->FlushBatch();
+        freed += m_atlas.Repack(m_renderer->GetSDLRenderer());
+    }
+    return (size_t)freed * 4;
+}
+
+void AssetManager::PrintAtlasStats() const {
+    TextureAtlas::Stats stats = m_atlas.GetStats();
+    std::cout << "Texture atlas: " << stats.textureCount << " textures in " << stats.pageCount
+              << " pages, " << (int)(stats.occupancy * 100.0f) << "% occupied" << std::endl;
+    
+    for (size_t i = 0; i < stats.pages.size(); ++i) {
+        const TextureAtlas::PageStats& page = stats.pages[i];
+        std::cout << "  page " << i << ": " << page.width << "x" << page.height << ", "
+                  << page.textureCount << " textures, " << (int)(page.occupancy * 100.0f) << "% occupied" << std::endl;
+    }
+}
+
+std::shared_ptr<Texture> AssetManager::CreateTexture(SDL_Surface* surface) {
+    SDL_Renderer* renderer = m_renderer->GetSDLRenderer();
+    auto texture = std::make_shared<Texture>();
+    
+    if (m_atlasMaxSpriteSize > 0 && surface->w <= m_atlasMaxSpriteSize && surface->h <= m_atlasMaxSpriteSize) {
+        // Growing a page replaces its SDL_Texture, so nothing queued may still point at it
+        m_renderer->FlushBatch();
+        
+        std::shared_ptr<AtlasRegion> region = m_atlas.Add(renderer, surface);
+        if (region) {
+            texture->SetAtlasRegion(region);
+            return texture;
+        }
+    }
+    
+    if (texture->LoadFromSurface(renderer, surface)) {
+        return texture;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<TextureRequest> AssetManager::LoadTextureAsync(const std::string& name, const std::string& path) {
+    auto pending = m_pendingRequests.find(name);
+    if (pending != m_pendingRequests.end()) {
+        return pending->second;
+    }
+    
+    auto request = std::make_shared<TextureRequest>(name, path);
+    
+    auto it = m_textures.find(name);
+    if (it != m_textures.end()) {
+        request->m_texture = Touch(it->second);
+        request->m_state = TextureRequest::State::Ready;
+        return request;
+    }
+    
+    m_pendingRequests[name] = request;
+    
+    // With no workers the job would only run once someone waits on it
+    if (m_jobSystem && m_jobSystem->GetWorkerCount() > 0) {
+        m_jobSystem->Schedule([this, request]() {
+            QueueUpload(request, LoadSurface(request->GetPath()));
+        }, &m_decodeJobs);
+    } else {
+        QueueUpload(request, LoadSurface(path));
+    }
+    m_cacheMisses++;
+    
+    return request;
+}
+
+int AssetManager::ProcessUploads() {
+    int uploads = UploadDecoded(m_uploadBudgetNS, m_maxUploadsPerFrame);
+    
+    // Textures released since last frame may now be evictable
+    EvictToBudget();
+    return uploads;
+}
+
+int AssetManager::UploadDecoded(Uint64 budgetNS, int maxUploads) {
+    Uint64 start = SDL_GetTicksNS();
+    int uploads = 0;
+    
+    while (uploads < maxUploads) {
+        DecodedTexture decoded;
+        {
+            std::lock_guard<std::mutex> lock(m_uploadMutex);
+            if (m_uploadQueue.empty()) break;
+            decoded = m_uploadQueue.front();
+            m_uploadQueue.pop_front();
+        }
+        
+        std::shared_ptr<TextureRequest>& request = decoded.request;
+        m_pendingRequests.erase(request->GetName());
+        
+        std::shared_ptr<Texture> texture;
+        if (decoded.surface) {
+            texture = CreateTexture(decoded.surface);
+            SDL_DestroySurface(decoded.surface);
+        }
+        
+        if (texture) {
+            request->m_texture = texture;
+            AddToCache(request->GetName(), texture);
+            request->m_state = TextureRequest::State::Ready;
+        } else {
+            std::cerr << "Failed to load texture: " << request->GetName() << " from " << request->GetPath() << std::endl;
+            request->m_state = TextureRequest::State::Failed;
+        }
+        uploads++;
+        
+        if (SDL_GetTicksNS() - start >= budgetNS) break;
+    }
+    
+    return uploads;
+}
+
+void AssetManager::SetUploadBudget(Uint64 nanoseconds, int maxUploadsPerFrame) {
+    m_uploadBudgetNS = nanoseconds;
+    m_maxUploadsPerFrame = maxUploadsPerFrame > 0 ? maxUploadsPerFrame : 1;
+}
+
+void AssetManager::WaitForAsyncLoads() {
+    if (m_jobSystem) {
+        m_jobSystem->Wait(m_decodeJobs);
+    }
+}
+
+void AssetManager::QueueUpload(const std::shared_ptr<TextureRequest>& request, SDL_Surface* surface) {
+    std::lock_guard<std::mutex> lock(m_uploadMutex);
+    m_uploadQueue.push_back({ request, surface });
+}
+
+bool AssetManager::MountPack(const std::string& packPath) {
+    // Decode jobs read the pack list
+    WaitForAsyncLoads();
+    
+    auto pack = std::make_unique<AssetPack>();
+    if (!pack->Open(packPath)) {
+        return false;
+    }
+    m_packs.push_back(std::move(pack));
+    return true;
+}
+
+void AssetManager::UnmountPacks() {
+    // Queued surfaces may point into a mapping, upload them all first
+    WaitForAsyncLoads();
+    UploadDecoded(UINT64_MAX, INT_MAX);
+    m_packs.clear();
+}
+
+SDL_Surface* AssetManager::LoadSurface(const std::string& path) const {
+    for (auto it = m_packs.rbegin(); it != m_packs.rend(); ++it) {
+        const AssetPack::Entry* entry = (*it)->Find(path);
+        if (!entry) continue;
+        
+        AssetPack::Span span = (*it)->GetData(*entry);
+        if (entry->type == (uint8_t)AssetPack::EntryType::ImageRGBA32) {
+            // Pre-decoded: wrap the mapped pixels, no copy and no decode
+            SDL_Surface* surface = SDL_CreateSurfaceFrom((int)entry->width, (int)entry->height,
+                                                         SDL_PIXELFORMAT_RGBA32, (void*)span.data,
+                                                         (int)entry->width * 4);
+            if (surface) {
+                return surface;
+            }
+            std::cerr << "Unable to wrap packed image: " << path << " SDL Error: " << SDL_GetError() << std::endl;
+            continue;
+        }
+        return Texture::LoadSurfaceFromMemory(span.data, span.size, path);
+    }
+    
+    return Texture::LoadSurface(path);
+}
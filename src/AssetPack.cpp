@@ -0,0 +1,354 @@
+#include "AssetPack.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char kPackMagic[4] = { '9', 'G', 'P', 'K' };
+
+static size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// AssetPack Implementation
+AssetPack::AssetPack()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_entries(nullptr)
+    , m_entryCount(0)
+    , m_names(nullptr)
+#ifdef _WIN32
+    , m_file(nullptr)
+    , m_mapping(nullptr)
+#endif
+{
+}
+
+AssetPack::~AssetPack() {
+    Close();
+}
+
+bool AssetPack::Open(const std::string& path) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Unable to open asset pack: " << path << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(Header)) {
+        std::cerr << "Invalid asset pack: " << path << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        std::cerr << "Unable to map asset pack: " << path << std::endl;
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_size = (size_t)fileSize.QuadPart;
+    m_data = (const uint8_t*)view;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Unable to open asset pack: " << path << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(Header)) {
+        std::cerr << "Invalid asset pack: " << path << std::endl;
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file alive
+    if (view == MAP_FAILED) {
+        std::cerr << "Unable to map asset pack: " << path << std::endl;
+        return false;
+    }
+
+    m_size = (size_t)info.st_size;
+    m_data = (const uint8_t*)view;
+#endif
+
+    const Header* header = (const Header*)m_data;
+    m_path = path;
+    m_entryCount = header->entryCount;
+    m_entries = (const Entry*)(m_data + header->tableOffset);
+    m_names = (const char*)(m_data + header->namesOffset);
+
+    if (!Validate()) {
+        std::cerr << "Corrupt or incompatible asset pack: " << path << std::endl;
+        Close();
+        return false;
+    }
+
+    std::cout << "Mounted asset pack: " << path << " (" << m_entryCount << " assets)" << std::endl;
+    return true;
+}
+
+void AssetPack::Close() {
+    if (!m_data) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle((HANDLE)m_mapping);
+    CloseHandle((HANDLE)m_file);
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    munmap((void*)m_data, m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_entries = nullptr;
+    m_entryCount = 0;
+    m_names = nullptr;
+    m_path.clear();
+}
+
+const AssetPack::Entry* AssetPack::Find(const std::string& name) const {
+    if (!m_data) return nullptr;
+
+    std::string normalized = NormalizeName(name);
+    uint64_t hash = HashName(normalized);
+
+    const Entry* end = m_entries + m_entryCount;
+    const Entry* entry = std::lower_bound(m_entries, end, hash, [](const Entry& e, uint64_t h) {
+        return e.hash < h;
+    });
+
+    // Hashes may collide, the stored name decides
+    for (; entry != end && entry->hash == hash; ++entry) {
+        if (entry->nameLength == normalized.size() &&
+            std::memcmp(m_names + entry->nameOffset, normalized.data(), normalized.size()) == 0) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+AssetPack::Span AssetPack::GetData(const Entry& entry) const {
+    Span span = { m_data + entry.offset, (size_t)entry.size };
+    return span;
+}
+
+std::string AssetPack::GetName(const Entry& entry) const {
+    return std::string(m_names + entry.nameOffset, entry.nameLength);
+}
+
+std::string AssetPack::NormalizeName(const std::string& name) {
+    std::string normalized = name;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    while (normalized.compare(0, 2, "./") == 0) {
+        normalized.erase(0, 2);
+    }
+    return normalized;
+}
+
+uint64_t AssetPack::HashName(const std::string& name) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool AssetPack::Validate() const {
+    const Header* header = (const Header*)m_data;
+    if (std::memcmp(header->magic, kPackMagic, sizeof(kPackMagic)) != 0 || header->version != kVersion) {
+        return false;
+    }
+
+    if (header->tableOffset % alignof(Entry) != 0 ||
+        header->tableOffset > m_size ||
+        (m_size - header->tableOffset) / sizeof(Entry) < m_entryCount ||
+        header->namesOffset > m_size) {
+        return false;
+    }
+
+    size_t namesSize = m_size - header->namesOffset;
+    for (size_t i = 0; i < m_entryCount; ++i) {
+        const Entry& entry = m_entries[i];
+        if (entry.offset > m_size || entry.size > m_size - entry.offset) return false;
+        if ((size_t)entry.nameOffset + entry.nameLength > namesSize) return false;
+        if (i > 0 && m_entries[i - 1].hash > entry.hash) return false;
+        if (entry.type == (uint8_t)EntryType::ImageRGBA32 &&
+            (uint64_t)entry.width * entry.height * 4 != entry.size) return false;
+        if (entry.type == (uint8_t)EntryType::AudioF32 &&
+            (entry.width == 0 || entry.height < 1 || entry.height > 2 || entry.offset % sizeof(float) != 0 ||
+             entry.size % (sizeof(float) * entry.height) != 0)) return false;
+    }
+    return true;
+}
+
+// AssetPackWriter Implementation
+void AssetPackWriter::AddRaw(const std::string& name, std::vector<uint8_t> data) {
+    Item item;
+    item.name = AssetPack::NormalizeName(name);
+    item.type = AssetPack::EntryType::Raw;
+    item.width = 0;
+    item.height = 0;
+    item.data = std::move(data);
+    m_items.push_back(std::move(item));
+}
+
+bool AssetPackWriter::AddFile(const std::string& name, const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file) {
+        std::cerr << "Unable to read: " << filePath << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> data((size_t)file.tellg());
+    file.seekg(0);
+    file.read((char*)data.data(), (std::streamsize)data.size());
+    if (!file) {
+        std::cerr << "Unable to read: " << filePath << std::endl;
+        return false;
+    }
+
+    AddRaw(name, std::move(data));
+    return true;
+}
+
+void AssetPackWriter::AddImage(const std::string& name, int width, int height, const void* pixels) {
+    Item item;
+    item.name = AssetPack::NormalizeName(name);
+    item.type = AssetPack::EntryType::ImageRGBA32;
+    item.width = (uint32_t)width;
+    item.height = (uint32_t)height;
+    const uint8_t* bytes = (const uint8_t*)pixels;
+    item.data.assign(bytes, bytes + (size_t)width * height * 4);
+    m_items.push_back(std::move(item));
+}
+
+void AssetPackWriter::AddAudio(const std::string& name, int sampleRate, int channels, const float* samples,
+                               int frames) {
+    Item item;
+    item.name = AssetPack::NormalizeName(name);
+    item.type = AssetPack::EntryType::AudioF32;
+    item.width = (uint32_t)sampleRate;
+    item.height = (uint32_t)channels;
+    const uint8_t* bytes = (const uint8_t*)samples;
+    item.data.assign(bytes, bytes + (size_t)frames * channels * sizeof(float));
+    m_items.push_back(std::move(item));
+}
+
+bool AssetPackWriter::Write(const std::string& path) const {
+    // Sorted by hash for binary search; equal hashes by name so output is reproducible
+    std::vector<const Item*> items;
+    for (const auto& item : m_items) {
+        items.push_back(&item);
+    }
+    std::stable_sort(items.begin(), items.end(), [](const Item* a, const Item* b) {
+        uint64_t ha = AssetPack::HashName(a->name);
+        uint64_t hb = AssetPack::HashName(b->name);
+        return ha != hb ? ha < hb : a->name < b->name;
+    });
+
+    // Duplicate names: the one added last wins
+    std::vector<const Item*> unique;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (i + 1 < items.size() && items[i + 1]->name == items[i]->name) {
+            continue;
+        }
+        unique.push_back(items[i]);
+    }
+
+    std::vector<AssetPack::Entry> entries(unique.size());
+    std::string names;
+    for (size_t i = 0; i < unique.size(); ++i) {
+        const Item& item = *unique[i];
+        AssetPack::Entry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.hash = AssetPack::HashName(item.name);
+        entry.size = item.data.size();
+        entry.nameOffset = (uint32_t)names.size();
+        entry.nameLength = (uint16_t)item.name.size();
+        entry.type = (uint8_t)item.type;
+        entry.width = item.width;
+        entry.height = item.height;
+        names += item.name;
+    }
+
+    // Blobs go out grouped by type, then by name, so assets loaded together
+    // (every sound in a bank) are one contiguous run of the file
+    std::vector<size_t> blobOrder(unique.size());
+    for (size_t i = 0; i < blobOrder.size(); ++i) {
+        blobOrder[i] = i;
+    }
+    std::stable_sort(blobOrder.begin(), blobOrder.end(), [&unique](size_t a, size_t b) {
+        if (unique[a]->type != unique[b]->type) return unique[a]->type < unique[b]->type;
+        return unique[a]->name < unique[b]->name;
+    });
+    size_t offset = AlignUp(sizeof(AssetPack::Header), AssetPack::kBlobAlignment);
+    for (size_t i : blobOrder) {
+        entries[i].offset = offset;
+        offset = AlignUp(offset + unique[i]->data.size(), AssetPack::kBlobAlignment);
+    }
+
+    AssetPack::Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kPackMagic, sizeof(kPackMagic));
+    header.version = AssetPack::kVersion;
+    header.entryCount = (uint32_t)entries.size();
+    header.tableOffset = offset;
+    header.namesOffset = offset + entries.size() * sizeof(AssetPack::Entry);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Unable to write asset pack: " << path << std::endl;
+        return false;
+    }
+
+    static const char padding[AssetPack::kBlobAlignment] = {};
+    size_t written = 0;
+    auto writeBytes = [&file, &written](const void* data, size_t size) {
+        file.write((const char*)data, (std::streamsize)size);
+        written += size;
+    };
+    auto padTo = [&writeBytes, &written](size_t position) {
+        writeBytes(padding, position - written);
+    };
+
+    writeBytes(&header, sizeof(header));
+    for (size_t i : blobOrder) {
+        padTo(entries[i].offset);
+        writeBytes(unique[i]->data.data(), unique[i]->data.size());
+    }
+    padTo(header.tableOffset);
+    writeBytes(entries.data(), entries.size() * sizeof(AssetPack::Entry));
+    writeBytes(names.data(), names.size());
+
+    if (!file) {
+        std::cerr << "Unable to write asset pack: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -1,86 +1,329 @@
 #include "AudioManager.h"
+#include "Resampler.h"
+#include "WavWriter.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 // Sound Implementation
-Sound::Sound() : m_channel(-1) {
+Sound::Sound(const std::shared_ptr<AudioMixer>& mixer)
+    : m_mixer(mixer), m_minInterval(kDefaultMinInterval), m_limitedPlays(0) {
 }
 
 Sound::~Sound() {
-    // No cleanup needed for stub implementation
+    // Voices still playing keep their own reference to the buffer
 }
 
 bool Sound::LoadFromFile(const std::string& path) {
-    std::cout << "Sound loading stubbed for: " << path << std::endl;
-    return true; // Stub implementation
+    SDL_IOStream* io = SDL_IOFromFile(path.c_str(), "rb");
+    if (!io) {
+        std::cerr << "Failed to open sound " << path << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+    return Decode(io, path);
+}
+
+bool Sound::LoadFromMemory(const void* data, size_t size) {
+    SDL_IOStream* io = data ? SDL_IOFromConstMem(data, size) : nullptr;
+    if (!io) {
+        std::cerr << "Failed to read sound from memory: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    return Decode(io, "memory");
+}
+
+bool Sound::Decode(SDL_IOStream* io, const std::string& source) {
+    SDL_AudioSpec spec;
+    Uint8* wav = nullptr;
+    Uint32 wavLength = 0;
+    if (!SDL_LoadWAV_IO(io, true, &spec, &wav, &wavLength)) {
+        std::cerr << "Failed to decode sound " << source << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+    
+    // SDL converts the sample format and channels; the rate is left to
+    // Resampler, whose filter is far cleaner than SDL's
+    SDL_AudioSpec target;
+    target.format = SDL_AUDIO_F32;
+    target.channels = spec.channels > 1 ? 2 : 1;
+    target.freq = spec.freq;
+    
+    Uint8* converted = nullptr;
+    int convertedLength = 0;
+    bool ok = SDL_ConvertAudioSamples(&spec, wav, (int)wavLength, &target, &converted, &convertedLength);
+    SDL_free(wav);
+    if (!ok) {
+        std::cerr << "Failed to convert sound " << source << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+    
+    int frames = convertedLength / (int)(sizeof(float) * target.channels);
+    ok = LoadFromPCM((const float*)converted, frames, target.channels, target.freq);
+    SDL_free(converted);
+    return ok;
+}
+
+bool Sound::LoadFromPCM(const float* samples, int frames, int channels, int sampleRate) {
+    if (!samples || frames < 0 || channels < 1 || channels > 2 || sampleRate <= 0) {
+        std::cerr << "Invalid PCM for sound: " << channels << " channels at " << sampleRate << " Hz" << std::endl;
+        return false;
+    }
+    
+    // Converted once here so voices mix straight from the buffer
+    auto mixer = m_mixer.lock();
+    auto buffer = std::make_shared<AudioBuffer>();
+    buffer->channels = channels;
+    Resampler resampler(sampleRate, mixer ? mixer->GetSampleRate() : sampleRate);
+    resampler.Process(samples, frames, channels, buffer->samples);
+    buffer->frames = (int)(buffer->samples.size() / channels);
+    
+    m_buffer = buffer;
+    return true;
 }
 
-void Sound::Play(int loops) {
-    std::cout << "Playing sound (stubbed)" << std::endl;
+AudioMixer::VoiceId Sound::Play(int loops, float volume, float pan, int priority) {
+    auto mixer = m_mixer.lock();
+    if (!mixer) return AudioMixer::InvalidVoice;
+    
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - m_lastPlay < std::chrono::duration<float>(m_minInterval)) {
+        m_limitedPlays++;
+        return AudioMixer::InvalidVoice;
+    }
+    m_lastPlay = now;
+    return mixer->Play(m_buffer, AudioMixer::SoundBus, volume, pan, loops, priority);
 }
 
 void Sound::Stop() {
-    std::cout << "Stopping sound (stubbed)" << std::endl;
+    auto mixer = m_mixer.lock();
+    if (mixer && m_buffer) {
+        mixer->StopBuffer(m_buffer.get());
+    }
 }
 
 // Music Implementation
-Music::Music() {
+Music::Music(const std::shared_ptr<AudioMixer>& mixer, bool readerThread)
+    : m_mixer(mixer)
+    , m_started(false)
+    , m_readerThread(readerThread)
+    , m_voice(AudioMixer::InvalidVoice)
+    , m_paused(false) {
 }
 
 Music::~Music() {
-    // No cleanup needed for stub implementation
+    // The mixer keeps the stream until its voice has faded out
+    Stop();
 }
 
 bool Music::LoadFromFile(const std::string& path) {
-    std::cout << "Music loading stubbed for: " << path << std::endl;
-    return true; // Stub implementation
+    auto mixer = m_mixer.lock();
+    auto stream = std::make_shared<MusicStream>(mixer ? mixer->GetSampleRate() : 48000);
+    if (!stream->Open(path)) {
+        return false;
+    }
+    
+    Stop();
+    m_path = path;
+    m_stream = stream;
+    m_started = false;
+    return true;
 }
 
 void Music::Play(int loops) {
-    std::cout << "Playing music (stubbed)" << std::endl;
+    auto mixer = m_mixer.lock();
+    if (!mixer || m_path.empty()) return;
+    
+    Stop();
+    if (!m_stream || m_started) {
+        m_stream = std::make_shared<MusicStream>(mixer->GetSampleRate());
+        if (!m_stream->Open(m_path)) {
+            m_stream.reset();
+            return;
+        }
+    }
+    m_stream->Start(loops, m_readerThread);
+    m_started = true;
+    m_voice = mixer->PlayStream(m_stream, AudioMixer::MusicBus);
+    m_paused = false;
 }
 
 void Music::Stop() {
-    std::cout << "Stopping music (stubbed)" << std::endl;
+    auto mixer = m_mixer.lock();
+    if (mixer && m_voice != AudioMixer::InvalidVoice) {
+        mixer->Stop(m_voice);
+    }
+    m_voice = AudioMixer::InvalidVoice;
+    m_paused = false;
 }
 
 void Music::Pause() {
-    std::cout << "Pausing music (stubbed)" << std::endl;
+    auto mixer = m_mixer.lock();
+    if (mixer && mixer->IsPlaying(m_voice)) {
+        mixer->SetPaused(m_voice, true);
+        m_paused = true;
+    }
 }
 
 void Music::Resume() {
-    std::cout << "Resuming music (stubbed)" << std::endl;
+    auto mixer = m_mixer.lock();
+    if (mixer && m_paused) {
+        mixer->SetPaused(m_voice, false);
+        m_paused = false;
+    }
 }
 
 bool Music::IsPlaying() const {
-    return false; // Stub implementation
+    auto mixer = m_mixer.lock();
+    return mixer && !m_paused && mixer->IsPlaying(m_voice);
+}
+
+MusicStream::Stats Music::GetStreamStats() const {
+    return m_stream ? m_stream->GetStats() : MusicStream::Stats();
 }
 
 // AudioManager Implementation
-AudioManager::AudioManager() : m_initialized(false) {
+// Frames mixed per pass of the callback
+static const int kCallbackFrames = 1024;
+// Voices mixed at once; the rest go virtual
+static const int kVoiceBudget = 48;
+
+AudioManager::AudioManager()
+    : m_stream(nullptr), m_minDistance(64.0f), m_maxDistance(1024.0f), m_backend(DeviceBackend), m_initialized(false) {
 }
 
 AudioManager::~AudioManager() {
     Shutdown();
 }
 
-bool AudioManager::Initialize() {
+bool AudioManager::Initialize(Backend backend, int sampleRate) {
+    m_backend = backend;
+    SDL_AudioSpec spec;
+    spec.format = SDL_AUDIO_S16;
+    spec.channels = 2;
+    spec.freq = sampleRate > 0 ? sampleRate : 48000;
+    
+    // Mix at the device's own rate, so SDL has nothing left to resample
+    SDL_AudioSpec deviceSpec;
+    int deviceFrames = 0;
+    if (backend == DeviceBackend &&
+        SDL_GetAudioDeviceFormat(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &deviceSpec, &deviceFrames) && deviceSpec.freq > 0) {
+        spec.freq = deviceSpec.freq;
+    }
+    
+    m_mixer = std::make_shared<AudioMixer>(spec.freq);
+    m_mixer->SetVoiceBudget(kVoiceBudget);
+    m_mixBuffer.resize(kCallbackFrames * 2);
     m_initialized = true;
-    std::cout << "Audio Manager initialized (stubbed - no actual audio support)!" << std::endl;
+    
+    if (backend == OfflineBackend) {
+        std::cout << "Audio Manager initialized offline: " << spec.freq << " Hz stereo" << std::endl;
+        return true;
+    }
+    
+    m_stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, MixCallback, this);
+    if (m_stream) {
+        SDL_ResumeAudioStreamDevice(m_stream);
+        std::cout << "Audio Manager initialized: " << spec.freq << " Hz stereo, "
+                  << kVoiceBudget << " of " << AudioMixer::kMaxVoices << " voices mixed" << std::endl;
+    } else {
+        std::cerr << "No audio device, sounds will be silent: " << SDL_GetError() << std::endl;
+    }
     return true;
 }
 
 void AudioManager::Shutdown() {
     if (m_initialized) {
+        // Stops the callback before the mixer goes away
+        if (m_stream) {
+            SDL_DestroyAudioStream(m_stream);
+            m_stream = nullptr;
+        }
         m_sounds.clear();
         m_music.clear();
+        m_packs.clear();
+        m_emitters.clear();
+        m_mixer.reset();
         m_initialized = false;
         std::cout << "Audio Manager shut down" << std::endl;
     }
 }
 
+void AudioManager::Update() {
+    if (!m_mixer) return;
+    m_mixer->Update();
+    
+    // Follow the listener; only changes worth hearing are sent
+    for (size_t i = 0; i < m_emitters.size();) {
+        Emitter& emitter = m_emitters[i];
+        if (!m_mixer->IsPlaying(emitter.voice)) {
+            emitter = m_emitters.back();
+            m_emitters.pop_back();
+            continue;
+        }
+        
+        float volume, pan;
+        Attenuate(emitter.position, volume, pan);
+        if (std::fabs(volume - emitter.volume) > 0.001f) {
+            m_mixer->SetVolume(emitter.voice, volume);
+            emitter.volume = volume;
+        }
+        if (std::fabs(pan - emitter.pan) > 0.01f) {
+            m_mixer->SetPan(emitter.voice, pan);
+            emitter.pan = pan;
+        }
+        ++i;
+    }
+}
+
+void AudioManager::Attenuate(const Vector2& position, float& volume, float& pan) const {
+    Vector2 offset = position - m_listener;
+    float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+    float t = (distance - m_minDistance) / (m_maxDistance - m_minDistance);
+    volume = 1.0f - std::max(0.0f, std::min(t, 1.0f));
+    volume *= volume;
+    pan = offset.x / std::max(distance, m_minDistance);
+}
+
+void AudioManager::SetAttenuation(float minDistance, float maxDistance) {
+    m_minDistance = std::max(0.0f, minDistance);
+    m_maxDistance = std::max(m_minDistance + 1.0f, maxDistance);
+}
+
+void SDLCALL AudioManager::MixCallback(void* userdata, SDL_AudioStream* stream, int additionalAmount, int /*totalAmount*/) {
+    AudioManager* manager = (AudioManager*)userdata;
+    int frames = additionalAmount / (int)(sizeof(int16_t) * 2);
+    while (frames > 0) {
+        int count = std::min(frames, kCallbackFrames);
+        manager->m_mixer->Mix(manager->m_mixBuffer.data(), count);
+        SDL_PutAudioStreamData(stream, manager->m_mixBuffer.data(), count * (int)(sizeof(int16_t) * 2));
+        frames -= count;
+    }
+}
+
 std::shared_ptr<Sound> AudioManager::LoadSound(const std::string& name, const std::string& path) {
-    auto sound = std::make_shared<Sound>();
-    if (sound->LoadFromFile(path)) {
+    auto sound = std::make_shared<Sound>(m_mixer);
+    
+    const AssetPack::Entry* entry = nullptr;
+    AssetPack* pack = nullptr;
+    for (auto it = m_packs.rbegin(); it != m_packs.rend() && !entry; ++it) {
+        entry = (*it)->Find(path);
+        pack = it->get();
+    }
+    
+    bool loaded = false;
+    if (entry && entry->type == (uint8_t)AssetPack::EntryType::AudioF32) {
+        AssetPack::Span span = pack->GetData(*entry);
+        int channels = (int)entry->height;
+        loaded = sound->LoadFromPCM((const float*)span.data, (int)(span.size / (sizeof(float) * channels)), channels,
+                                    (int)entry->width);
+    } else if (entry) {
+        AssetPack::Span span = pack->GetData(*entry);
+        loaded = sound->LoadFromMemory(span.data, span.size);
+    } else {
+        loaded = sound->LoadFromFile(path);
+    }
+    
+    if (loaded) {
         m_sounds[name] = sound;
         return sound;
     }
@@ -88,7 +331,8 @@ std::shared_ptr<Sound> AudioManager::LoadSound(const std::string& name, const st
 }
 
 std::shared_ptr<Music> AudioManager::LoadMusic(const std::string& name, const std::string& path) {
-    auto music = std::make_shared<Music>();
+    // Offline renders outrun any reader thread, so decode as the mixer reads
+    auto music = std::make_shared<Music>(m_mixer, m_backend == DeviceBackend);
     if (music->LoadFromFile(path)) {
         m_music[name] = music;
         return music;
@@ -96,10 +340,35 @@ std::shared_ptr<Music> AudioManager::LoadMusic(const std::string& name, const st
     return nullptr;
 }
 
-void AudioManager::PlaySound(const std::string& name, int loops) {
+AudioMixer::VoiceId AudioManager::PlaySound(const std::string& name, int loops, int priority) {
     auto it = m_sounds.find(name);
-    if (it != m_sounds.end()) {
-        it->second->Play(loops);
+    if (it == m_sounds.end()) return AudioMixer::InvalidVoice;
+    return it->second->Play(loops, 1.0f, 0.0f, priority);
+}
+
+AudioMixer::VoiceId AudioManager::PlaySoundAt(const std::string& name, const Vector2& position, int loops,
+                                              int priority) {
+    auto it = m_sounds.find(name);
+    if (it == m_sounds.end()) return AudioMixer::InvalidVoice;
+    
+    Emitter emitter;
+    emitter.position = position;
+    Attenuate(position, emitter.volume, emitter.pan);
+    if (emitter.volume <= 0.0f && loops == 0) return AudioMixer::InvalidVoice;
+    
+    emitter.voice = it->second->Play(loops, emitter.volume, emitter.pan, priority);
+    if (emitter.voice != AudioMixer::InvalidVoice) {
+        m_emitters.push_back(emitter);
+    }
+    return emitter.voice;
+}
+
+void AudioManager::SetVoicePosition(AudioMixer::VoiceId voice, const Vector2& position) {
+    for (Emitter& emitter : m_emitters) {
+        if (emitter.voice == voice) {
+            emitter.position = position;
+            return;
+        }
     }
 }
 
@@ -111,13 +380,116 @@ void AudioManager::PlayMusic(const std::string& name, int loops) {
 }
 
 void AudioManager::StopMusic() {
-    std::cout << "Stopping all music (stubbed)" << std::endl;
+    for (auto& entry : m_music) {
+        entry.second->Stop();
+    }
 }
 
 void AudioManager::SetSoundVolume(int volume) {
-    std::cout << "Setting sound volume to " << volume << " (stubbed)" << std::endl;
+    if (m_mixer) {
+        m_mixer->SetBusVolume(AudioMixer::SoundBus, std::max(0, std::min(volume, 128)) / 128.0f);
+    }
 }
 
 void AudioManager::SetMusicVolume(int volume) {
-    std::cout << "Setting music volume to " << volume << " (stubbed)" << std::endl;
+    if (m_mixer) {
+        m_mixer->SetBusVolume(AudioMixer::MusicBus, std::max(0, std::min(volume, 128)) / 128.0f);
+    }
+}
+
+bool AudioManager::MountPack(const std::string& packPath) {
+    auto pack = std::make_unique<AssetPack>();
+    if (!pack->Open(packPath)) {
+        return false;
+    }
+    m_packs.push_back(std::move(pack));
+    return true;
+}
+
+int AudioManager::LoadSoundBank(const std::string& packPath) {
+    if (!MountPack(packPath)) return -1;
+    const AssetPack& pack = *m_packs.back();
+    
+    // Walked in file order: the blobs are contiguous, so the whole bank
+    // streams in as one sequential read
+    std::vector<const AssetPack::Entry*> entries;
+    for (size_t i = 0; i < pack.GetEntryCount(); ++i) {
+        const AssetPack::Entry& entry = pack.GetEntries()[i];
+        if (entry.type == (uint8_t)AssetPack::EntryType::AudioF32) {
+            entries.push_back(&entry);
+        }
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const AssetPack::Entry* a, const AssetPack::Entry* b) { return a->offset < b->offset; });
+    
+    int loaded = 0;
+    for (const AssetPack::Entry* entry : entries) {
+        AssetPack::Span span = pack.GetData(*entry);
+        int channels = (int)entry->height;
+        auto sound = std::make_shared<Sound>(m_mixer);
+        if (sound->LoadFromPCM((const float*)span.data, (int)(span.size / (sizeof(float) * channels)), channels,
+                               (int)entry->width)) {
+            m_sounds[pack.GetName(*entry)] = sound;
+            loaded++;
+        }
+    }
+    if (m_mixer && !entries.empty() && (int)entries.front()->width != m_mixer->GetSampleRate()) {
+        std::cerr << "Sound bank " << packPath << " is " << entries.front()->width << " Hz, resampled to "
+                  << m_mixer->GetSampleRate() << " Hz on load" << std::endl;
+    }
+    return loaded;
+}
+
+void AudioManager::UnmountPacks() {
+    // Sounds copy their samples out of the pack, so loaded ones stay valid
+    m_packs.clear();
+}
+
+bool AudioManager::Render(int16_t* output, int frames) {
+    if (m_backend != OfflineBackend || !m_mixer) return false;
+    m_mixer->Mix(output, frames);
+    return true;
+}
+
+bool AudioManager::RenderToFile(const std::string& path, int frames) {
+    if (m_backend != OfflineBackend || !m_mixer) return false;
+    
+    WavWriter writer;
+    if (!writer.Open(path, 2, m_mixer->GetSampleRate())) return false;
+    for (int done = 0; done < frames; done += kCallbackFrames) {
+        int count = std::min(kCallbackFrames, frames - done);
+        m_mixer->Mix(m_mixBuffer.data(), count);
+        // Frees finished voices as the game loop would
+        Update();
+        if (!writer.Write(m_mixBuffer.data(), count)) {
+            std::cerr << "Failed to write audio to " << path << std::endl;
+            return false;
+        }
+    }
+    return writer.Close();
+}
+
+AudioMixer::Stats AudioManager::GetMixerStats() const {
+    return m_mixer ? m_mixer->GetStats() : AudioMixer::Stats();
+}
+
+void AudioManager::PrintMixerStats() const {
+    AudioMixer::Stats stats = GetMixerStats();
+    std::cout << "Audio mixer: " << stats.playingVoices << " voices playing, " << stats.mixedVoices
+              << " mixed last callback, mix " << stats.averageMixMs << " ms avg, " << stats.maxMixMs << " ms max, "
+              << (int)(stats.load * 100.0) << "% of audio time, " << stats.droppedCommands << " dropped commands"
+              << std::endl;
+    uint64_t limitedPlays = 0;
+    for (const auto& entry : m_sounds) {
+        limitedPlays += entry.second->GetLimitedPlays();
+    }
+    std::cout << "  " << stats.virtualVoices << " virtual voices, "
+              << m_emitters.size() << " placed in the world, " << limitedPlays << " plays rate-limited" << std::endl;
+    for (const auto& entry : m_music) {
+        if (!entry.second->IsPlaying()) continue;
+        MusicStream::Stats music = entry.second->GetStreamStats();
+        std::cout << "  Music " << entry.first << ": " << music.bufferedFrames << " frames buffered, "
+                  << music.underruns << " underruns (" << music.underrunFrames << " frames of silence), "
+                  << music.residentBytes / 1024 << " KB resident" << std::endl;
+    }
 }
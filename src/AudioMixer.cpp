@@ -0,0 +1,619 @@
+#include "AudioMixer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define AUDIO_MIXER_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIO_MIXER_SSE
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+AudioMixer::AudioMixer(int sampleRate)
+    : m_sampleRate(sampleRate > 0 ? sampleRate : 48000)
+    , m_slots(kMaxVoices)
+    , m_playingVoices(0)
+    , m_voices(kMaxVoices)
+    , m_masterVolume(1.0f)
+    , m_voiceBudget(kMaxVoices)
+    , m_candidates(kMaxVoices)
+    , m_mixedVoices(0)
+    , m_virtualVoices(0)
+    , m_mixCalls(0)
+    , m_framesMixed(0)
+    , m_totalMixNs(0)
+    , m_lastMixNs(0)
+    , m_maxMixNs(0)
+    , m_droppedCommands(0)
+{
+    // Handed out from the back, so slot 0 goes first
+    for (int slot = kMaxVoices - 1; slot >= 0; --slot) {
+        m_freeSlots.push_back(slot);
+        m_slots[slot].generation = 0;
+        m_slots[slot].busy = false;
+        m_voices[slot] = Voice();
+        m_voices[slot].playing = false;
+    }
+    for (int bus = 0; bus < BusCount; ++bus) {
+        m_busVolume[bus] = 1.0f;
+    }
+}
+
+AudioMixer::VoiceId AudioMixer::Play(const std::shared_ptr<const AudioBuffer>& buffer, Bus bus, float volume,
+                                     float pan, int loops, int priority) {
+    if (!buffer || buffer->frames <= 0) return InvalidVoice;
+
+    Command command = Command();
+    command.type = PlayCommand;
+    command.buffer = buffer.get();
+    command.value = volume;
+    command.pan = pan;
+    command.loops = loops;
+    command.bus = bus;
+    command.priority = priority;
+    return Start(command, buffer, nullptr);
+}
+
+AudioMixer::VoiceId AudioMixer::PlayStream(const std::shared_ptr<AudioStreamSource>& stream, Bus bus, float volume,
+                                           float pan, int priority) {
+    if (!stream) return InvalidVoice;
+
+    Command command = Command();
+    command.type = PlayCommand;
+    command.stream = stream.get();
+    command.value = volume;
+    command.pan = pan;
+    command.bus = bus;
+    command.priority = priority;
+    return Start(command, nullptr, stream);
+}
+
+AudioMixer::VoiceId AudioMixer::Start(Command& command, const std::shared_ptr<const AudioBuffer>& buffer,
+                                      const std::shared_ptr<AudioStreamSource>& stream) {
+    if (m_freeSlots.empty()) return InvalidVoice;
+
+    int slot = m_freeSlots.back();
+    SlotState& state = m_slots[slot];
+    uint32_t generation = (state.generation + 1) & 0xFFFFFF;
+    if (generation == 0) generation = 1;
+
+    command.slot = slot;
+    command.generation = generation;
+    if (!m_commands.Push(command)) {
+        m_droppedCommands.fetch_add(1, std::memory_order_relaxed);
+        return InvalidVoice;
+    }
+
+    m_freeSlots.pop_back();
+    state.buffer = buffer;
+    state.stream = stream;
+    state.generation = generation;
+    state.busy = true;
+    m_playingVoices++;
+    return MakeId(slot, generation);
+}
+
+void AudioMixer::Stop(VoiceId voice) {
+    int slot;
+    if (!FindSlot(voice, slot)) return;
+
+    Command command = Command();
+    command.type = StopCommand;
+    command.slot = slot;
+    command.generation = m_slots[slot].generation;
+    Post(command);
+}
+
+void AudioMixer::SetPaused(VoiceId voice, bool paused) {
+    int slot;
+    if (!FindSlot(voice, slot)) return;
+
+    Command command = Command();
+    command.type = PauseCommand;
+    command.slot = slot;
+    command.generation = m_slots[slot].generation;
+    command.value = paused ? 1.0f : 0.0f;
+    Post(command);
+}
+
+void AudioMixer::StopBuffer(const AudioBuffer* buffer) {
+    for (int slot = 0; slot < kMaxVoices; ++slot) {
+        if (m_slots[slot].busy && m_slots[slot].buffer.get() == buffer) {
+            Stop(MakeId(slot, m_slots[slot].generation));
+        }
+    }
+}
+
+void AudioMixer::StopAll() {
+    Command command = Command();
+    command.type = StopAllCommand;
+    Post(command);
+}
+
+void AudioMixer::SetVolume(VoiceId voice, float volume) {
+    int slot;
+    if (!FindSlot(voice, slot)) return;
+
+    Command command = Command();
+    command.type = VolumeCommand;
+    command.slot = slot;
+    command.generation = m_slots[slot].generation;
+    command.value = volume;
+    Post(command);
+}
+
+void AudioMixer::SetPan(VoiceId voice, float pan) {
+    int slot;
+    if (!FindSlot(voice, slot)) return;
+
+    Command command = Command();
+    command.type = PanCommand;
+    command.slot = slot;
+    command.generation = m_slots[slot].generation;
+    command.pan = pan;
+    Post(command);
+}
+
+void AudioMixer::SetPitch(VoiceId voice, float pitch) {
+    int slot;
+    if (!FindSlot(voice, slot)) return;
+
+    Command command = Command();
+    command.type = PitchCommand;
+    command.slot = slot;
+    command.generation = m_slots[slot].generation;
+    command.value = std::max(1.0f / 1024.0f, std::min(pitch, kMaxPitch));
+    Post(command);
+}
+
+void AudioMixer::SetBusVolume(Bus bus, float volume) {
+    Command command = Command();
+    command.type = BusVolumeCommand;
+    command.bus = bus;
+    command.value = volume;
+    Post(command);
+}
+
+void AudioMixer::SetMasterVolume(float volume) {
+    Command command = Command();
+    command.type = MasterVolumeCommand;
+    command.value = volume;
+    Post(command);
+}
+
+void AudioMixer::SetVoiceBudget(int voices) {
+    Command command = Command();
+    command.type = VoiceBudgetCommand;
+    command.value = (float)std::max(0, std::min(voices, kMaxVoices));
+    Post(command);
+}
+
+bool AudioMixer::IsPlaying(VoiceId voice) const {
+    int slot;
+    return FindSlot(voice, slot);
+}
+
+void AudioMixer::Update() {
+    FinishedVoice finished;
+    while (m_finished.Pop(finished)) {
+        SlotState& state = m_slots[finished.slot];
+        // A stream's reader thread is joined here, never on the audio thread
+        state.buffer.reset();
+        state.stream.reset();
+        state.busy = false;
+        m_freeSlots.push_back(finished.slot);
+        m_playingVoices--;
+    }
+}
+
+AudioMixer::Stats AudioMixer::GetStats() const {
+    Stats stats = Stats();
+    stats.playingVoices = m_playingVoices;
+    stats.mixedVoices = m_mixedVoices.load(std::memory_order_relaxed);
+    stats.virtualVoices = m_virtualVoices.load(std::memory_order_relaxed);
+    stats.mixCalls = m_mixCalls.load(std::memory_order_relaxed);
+    stats.framesMixed = m_framesMixed.load(std::memory_order_relaxed);
+    stats.lastMixMs = m_lastMixNs.load(std::memory_order_relaxed) / 1e6;
+    stats.maxMixMs = m_maxMixNs.load(std::memory_order_relaxed) / 1e6;
+    stats.droppedCommands = m_droppedCommands.load(std::memory_order_relaxed);
+
+    double totalMs = m_totalMixNs.load(std::memory_order_relaxed) / 1e6;
+    if (stats.mixCalls > 0) {
+        stats.averageMixMs = totalMs / stats.mixCalls;
+    }
+    if (stats.framesMixed > 0) {
+        stats.load = totalMs / (stats.framesMixed * 1000.0 / m_sampleRate);
+    }
+    return stats;
+}
+
+bool AudioMixer::FindSlot(VoiceId voice, int& slot) const {
+    slot = (int)(voice & 0xFF);
+    const SlotState& state = m_slots[slot];
+    return voice != InvalidVoice && state.busy && state.generation == (voice >> 8);
+}
+
+void AudioMixer::Post(const Command& command) {
+    if (!m_commands.Push(command)) {
+        m_droppedCommands.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AudioMixer::Mix(int16_t* output, int frames) {
+    Clock::time_point start = Clock::now();
+    ApplyCommands();
+
+    int playingVoices = 0;
+    for (const Voice& voice : m_voices) {
+        playingVoices += voice.playing;
+    }
+    int mixedVoices = SelectAudibleVoices();
+
+    for (int done = 0; done < frames; done += kBlockFrames) {
+        int count = std::min(kBlockFrames, frames - done);
+        std::memset(m_accumulator, 0, sizeof(float) * count * 2);
+        for (int slot = 0; slot < kMaxVoices; ++slot) {
+            Voice& voice = m_voices[slot];
+            // Stopping overrides pausing, so a paused voice can still finish
+            if (!voice.playing || (voice.paused && !voice.stopping)) continue;
+            // A voice that just dropped out is mixed once more, fading out;
+            // a paused one was already silent and stops without a sound
+            if (!voice.paused && (voice.audible || voice.gainLeft > 0.0f || voice.gainRight > 0.0f)) {
+                MixVoice(voice, slot, m_accumulator, count);
+            } else {
+                AdvanceVoice(voice, slot, count);
+            }
+        }
+
+        // Scale to 16 bits and saturate
+        int16_t* out = output + done * 2;
+        int samples = count * 2;
+        float scale = m_masterVolume * 32767.0f;
+        int i = 0;
+#if defined(AUDIO_MIXER_AVX) || defined(AUDIO_MIXER_SSE)
+        const __m128 gain = _mm_set1_ps(scale);
+        const __m128 low = _mm_set1_ps(-32768.0f);
+        const __m128 high = _mm_set1_ps(32767.0f);
+        for (; i + 8 <= samples; i += 8) {
+            __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_load_ps(m_accumulator + i), gain), low), high);
+            __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_load_ps(m_accumulator + i + 4), gain), low), high);
+            _mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+        }
+#endif
+        for (; i < samples; ++i) {
+            float value = std::max(-32768.0f, std::min(m_accumulator[i] * scale, 32767.0f));
+            out[i] = (int16_t)std::lrint(value);
+        }
+    }
+
+    uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    m_mixedVoices.store(mixedVoices, std::memory_order_relaxed);
+    m_virtualVoices.store(playingVoices - mixedVoices, std::memory_order_relaxed);
+    m_mixCalls.store(m_mixCalls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    m_framesMixed.store(m_framesMixed.load(std::memory_order_relaxed) + frames, std::memory_order_relaxed);
+    m_totalMixNs.store(m_totalMixNs.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    m_lastMixNs.store(ns, std::memory_order_relaxed);
+    if (ns > m_maxMixNs.load(std::memory_order_relaxed)) {
+        m_maxMixNs.store(ns, std::memory_order_relaxed);
+    }
+}
+
+void AudioMixer::ApplyCommands() {
+    Command command;
+    while (m_commands.Pop(command)) {
+        Voice& voice = m_voices[command.slot];
+        bool current = voice.playing && voice.generation == command.generation;
+
+        switch (command.type) {
+        case PlayCommand:
+            voice.buffer = command.buffer;
+            voice.stream = command.stream;
+            voice.streamChannels = command.stream ? command.stream->GetChannels() : 0;
+            voice.generation = command.generation;
+            voice.position = 0;
+            voice.fraction = 0.0f;
+            voice.pitch = 1.0f;
+            voice.loops = command.loops;
+            voice.bus = command.bus;
+            voice.priority = command.priority;
+            voice.volume = command.value;
+            voice.pan = command.pan;
+            voice.playing = true;
+            voice.paused = false;
+            voice.stopping = false;
+            voice.audible = false;
+            voice.fresh = true;
+            // Set when it makes the budget; only later changes ramp
+            voice.gainLeft = 0.0f;
+            voice.gainRight = 0.0f;
+            break;
+        case StopCommand:
+            if (current) voice.stopping = true;
+            break;
+        case StopAllCommand:
+            for (Voice& other : m_voices) {
+                other.stopping = other.playing;
+            }
+            break;
+        case VolumeCommand:
+            if (current) voice.volume = command.value;
+            break;
+        case PanCommand:
+            if (current) voice.pan = command.pan;
+            break;
+        case PauseCommand:
+            if (current) voice.paused = command.value != 0.0f;
+            break;
+        case PitchCommand:
+            if (current) voice.pitch = command.value;
+            break;
+        case BusVolumeCommand:
+            m_busVolume[command.bus] = command.value;
+            break;
+        case MasterVolumeCommand:
+            m_masterVolume = command.value;
+            break;
+        case VoiceBudgetCommand:
+            m_voiceBudget = (int)command.value;
+            break;
+        }
+    }
+}
+
+int AudioMixer::SelectAudibleVoices() {
+    int candidates = 0;
+    for (int slot = 0; slot < kMaxVoices; ++slot) {
+        Voice& voice = m_voices[slot];
+        voice.audible = false;
+        if (!voice.playing || voice.paused || voice.stopping) continue;
+
+        float gain = voice.volume * m_busVolume[voice.bus] * m_masterVolume;
+        if (gain >= kInaudibleGain) {
+            voice.score = voice.priority + std::min(gain, 0.999f);
+            m_candidates[candidates++] = slot;
+        }
+    }
+
+    int audible = std::min(candidates, m_voiceBudget);
+    if (audible < candidates) {
+        // Ties go to the lower slot, so the choice is stable between calls
+        std::nth_element(m_candidates.begin(), m_candidates.begin() + audible, m_candidates.begin() + candidates,
+                         [this](int a, int b) {
+                             float scoreA = m_voices[a].score;
+                             float scoreB = m_voices[b].score;
+                             return scoreA > scoreB || (scoreA == scoreB && a < b);
+                         });
+    }
+    for (int i = 0; i < audible; ++i) {
+        Voice& voice = m_voices[m_candidates[i]];
+        voice.audible = true;
+        // New voices start at full gain; only voices coming back fade in
+        if (voice.fresh) {
+            voice.gainLeft = voice.volume * m_busVolume[voice.bus] * std::min(1.0f, 1.0f - voice.pan);
+            voice.gainRight = voice.volume * m_busVolume[voice.bus] * std::min(1.0f, 1.0f + voice.pan);
+        }
+    }
+    for (Voice& voice : m_voices) {
+        voice.fresh = false;
+    }
+    return audible;
+}
+
+void AudioMixer::MixVoice(Voice& voice, int slot, float* accumulator, int frames) {
+    // Volume, pan and stop changes ramp over the block so they don't click
+    float volume = voice.stopping || !voice.audible ? 0.0f : voice.volume * m_busVolume[voice.bus];
+    float targetLeft = volume * std::min(1.0f, 1.0f - voice.pan);
+    float targetRight = volume * std::min(1.0f, 1.0f + voice.pan);
+    float stepLeft = (targetLeft - voice.gainLeft) / frames;
+    float stepRight = (targetRight - voice.gainRight) / frames;
+
+    bool finished = voice.stopping;
+    if (voice.stream) {
+        // Whatever the stream has; a shortfall plays as silence
+        int count = voice.stream->Read(m_streamBlock, frames);
+        MixFrames(m_streamBlock, voice.streamChannels, count, accumulator, voice.gainLeft, voice.gainRight,
+                  stepLeft, stepRight);
+        if (count < frames && voice.stream->IsFinished()) {
+            finished = true;
+        }
+    }
+
+    const AudioBuffer* buffer = voice.buffer;
+    if (buffer && (voice.pitch != 1.0f || voice.fraction != 0.0f)) {
+        int count = ResampleVoice(voice, m_streamBlock, frames, finished);
+        MixFrames(m_streamBlock, buffer->channels, count, accumulator, voice.gainLeft, voice.gainRight,
+                  stepLeft, stepRight);
+        buffer = nullptr;
+    }
+
+    int done = buffer ? 0 : frames;
+    while (done < frames) {
+        int count = std::min(frames - done, buffer->frames - voice.position);
+        MixFrames(buffer->samples.data() + (size_t)voice.position * buffer->channels, buffer->channels, count,
+                  accumulator + done * 2, voice.gainLeft + stepLeft * done, voice.gainRight + stepRight * done,
+                  stepLeft, stepRight);
+        voice.position += count;
+        done += count;
+
+        if (voice.position == buffer->frames) {
+            if (voice.loops == 0) {
+                finished = true;
+                break;
+            }
+            voice.position = 0;
+            if (voice.loops > 0) voice.loops--;
+        }
+    }
+    voice.gainLeft = targetLeft;
+    voice.gainRight = targetRight;
+
+    if (finished) {
+        Finish(voice, slot);
+    }
+}
+
+int AudioMixer::ResampleVoice(Voice& voice, float* output, int frames, bool& finished) {
+    const AudioBuffer& buffer = *voice.buffer;
+    const float* samples = buffer.samples.data();
+    int channels = buffer.channels;
+    for (int i = 0; i < frames; ++i) {
+        // A step longer than the buffer passes the loop point more than once
+        while (voice.position >= buffer.frames) {
+            if (voice.loops == 0) {
+                finished = true;
+                return i;
+            }
+            voice.position -= buffer.frames;
+            if (voice.loops > 0) voice.loops--;
+        }
+
+        // Frames whose next sample is still inside the buffer need no
+        // checks; the truncation leaves room for rounding in fraction
+        int run = std::min(frames - i, (int)((buffer.frames - 2 - voice.position - voice.fraction) / voice.pitch));
+        if (run > 0) {
+            // 32.32 fixed point, so each frame's position depends only on
+            // an integer add rather than a chain of float conversions
+            uint64_t position = ((uint64_t)voice.position << 32) + (uint64_t)(voice.fraction * 4294967296.0);
+            uint64_t step = (uint64_t)(voice.pitch * 4294967296.0);
+            float* out = output + i * channels;
+            if (channels == 1) {
+                for (int k = 0; k < run; ++k) {
+                    const float* a = samples + (position >> 32);
+                    float fraction = (int32_t)((uint32_t)position >> 8) * (1.0f / 16777216.0f);
+                    out[k] = a[0] + (a[1] - a[0]) * fraction;
+                    position += step;
+                }
+            } else {
+                for (int k = 0; k < run; ++k) {
+                    const float* a = samples + (position >> 32) * 2;
+                    float fraction = (int32_t)((uint32_t)position >> 8) * (1.0f / 16777216.0f);
+                    out[k * 2] = a[0] + (a[2] - a[0]) * fraction;
+                    out[k * 2 + 1] = a[1] + (a[3] - a[1]) * fraction;
+                    position += step;
+                }
+            }
+            voice.position = (int)(position >> 32);
+            voice.fraction = (uint32_t)position * (1.0f / 4294967296.0f);
+            i += run - 1;
+            continue;
+        }
+
+        // Past the end, a loop interpolates towards its start and a last
+        // play towards silence
+        int next = voice.position + 1;
+        bool wraps = next == buffer.frames;
+        const float* a = samples + (size_t)voice.position * channels;
+        const float* b = samples + (size_t)(wraps ? 0 : next) * channels;
+        for (int c = 0; c < channels; ++c) {
+            float to = wraps && voice.loops == 0 ? 0.0f : b[c];
+            output[i * channels + c] = a[c] + (to - a[c]) * voice.fraction;
+        }
+
+        voice.fraction += voice.pitch;
+        int whole = (int)voice.fraction;
+        voice.position += whole;
+        voice.fraction -= whole;
+    }
+    return frames;
+}
+
+void AudioMixer::AdvanceVoice(Voice& voice, int slot, int frames) {
+    bool finished = voice.stopping;
+    if (voice.stream && !finished) {
+        // Drained anyway, so the stream stays in time and its reader going
+        int count = voice.stream->Read(m_streamBlock, frames);
+        if (count < frames && voice.stream->IsFinished()) {
+            finished = true;
+        }
+    } else if (!finished) {
+        float advance = voice.fraction + voice.pitch * frames;
+        int whole = (int)advance;
+        voice.position += whole;
+        voice.fraction = advance - whole;
+        while (voice.position >= voice.buffer->frames) {
+            if (voice.loops == 0) {
+                finished = true;
+                break;
+            }
+            voice.position -= voice.buffer->frames;
+            if (voice.loops > 0) voice.loops--;
+        }
+    }
+
+    if (finished) {
+        Finish(voice, slot);
+    }
+}
+
+void AudioMixer::Finish(Voice& voice, int slot) {
+    voice.playing = false;
+    FinishedVoice report = { slot, voice.generation };
+    m_finished.Push(report);
+}
+
+void AudioMixer::MixFrames(const float* source, int channels, int frames, float* accumulator,
+                           float gainLeft, float gainRight, float stepLeft, float stepRight) {
+    int i = 0;
+#if defined(AUDIO_MIXER_AVX)
+    // Eight output samples (four frames) per iteration
+    __m256 gain = _mm256_setr_ps(gainLeft, gainRight, gainLeft + stepLeft, gainRight + stepRight,
+                                 gainLeft + 2 * stepLeft, gainRight + 2 * stepRight,
+                                 gainLeft + 3 * stepLeft, gainRight + 3 * stepRight);
+    const __m256 step = _mm256_setr_ps(4 * stepLeft, 4 * stepRight, 4 * stepLeft, 4 * stepRight,
+                                       4 * stepLeft, 4 * stepRight, 4 * stepLeft, 4 * stepRight);
+    if (channels == 1) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128 mono = _mm_loadu_ps(source + i);
+            __m256 stereo = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(mono, mono)),
+                                                 _mm_unpackhi_ps(mono, mono), 1);
+            float* out = accumulator + i * 2;
+            _mm256_storeu_ps(out, _mm256_add_ps(_mm256_loadu_ps(out), _mm256_mul_ps(stereo, gain)));
+            gain = _mm256_add_ps(gain, step);
+        }
+    } else {
+        for (; i + 4 <= frames; i += 4) {
+            float* out = accumulator + i * 2;
+            __m256 stereo = _mm256_loadu_ps(source + i * 2);
+            _mm256_storeu_ps(out, _mm256_add_ps(_mm256_loadu_ps(out), _mm256_mul_ps(stereo, gain)));
+            gain = _mm256_add_ps(gain, step);
+        }
+    }
+#elif defined(AUDIO_MIXER_SSE)
+    // Four output samples (two frames) per multiply
+    __m128 gain = _mm_setr_ps(gainLeft, gainRight, gainLeft + stepLeft, gainRight + stepRight);
+    const __m128 step = _mm_setr_ps(2 * stepLeft, 2 * stepRight, 2 * stepLeft, 2 * stepRight);
+    if (channels == 1) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128 mono = _mm_loadu_ps(source + i);
+            float* out = accumulator + i * 2;
+            _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(_mm_unpacklo_ps(mono, mono), gain)));
+            gain = _mm_add_ps(gain, step);
+            _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_mul_ps(_mm_unpackhi_ps(mono, mono), gain)));
+            gain = _mm_add_ps(gain, step);
+        }
+    } else {
+        for (; i + 2 <= frames; i += 2) {
+            float* out = accumulator + i * 2;
+            _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(_mm_loadu_ps(source + i * 2), gain)));
+            gain = _mm_add_ps(gain, step);
+        }
+    }
+#endif
+
+    for (; i < frames; ++i) {
+        float left = gainLeft + stepLeft * i;
+        float right = gainRight + stepRight * i;
+        if (channels == 1) {
+            accumulator[i * 2] += source[i] * left;
+            accumulator[i * 2 + 1] += source[i] * right;
+        } else {
+            accumulator[i * 2] += source[i * 2] * left;
+            accumulator[i * 2 + 1] += source[i * 2 + 1] * right;
+        }
+    }
+}
@@ -0,0 +1,209 @@
+#include "Broadphase.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(float cellSize)
+    : m_cellSize(cellSize > 0.0f ? cellSize : 64.0f)
+    , m_invCellSize(1.0f / m_cellSize)
+    , m_proxyCount(0)
+    , m_reinsertCount(0)
+{
+}
+
+int SpatialHash::AddProxy(const Physics::AABB& aabb) {
+    int proxy;
+    if (!m_freeProxies.empty()) {
+        proxy = m_freeProxies.back();
+        m_freeProxies.pop_back();
+    } else {
+        proxy = (int)m_proxies.size();
+        m_proxies.push_back(Proxy());
+    }
+
+    Proxy& p = m_proxies[proxy];
+    p.aabb = aabb;
+    p.cells = ComputeCellRange(aabb);
+    p.active = true;
+    InsertIntoCells(proxy, p.cells);
+
+    m_proxyCount++;
+    return proxy;
+}
+
+void SpatialHash::MoveProxy(int proxy, const Physics::AABB& aabb) {
+    Proxy& p = m_proxies[proxy];
+    p.aabb = aabb;
+
+    CellRange range = ComputeCellRange(aabb);
+    if (range == p.cells) return;
+
+    // Crossed a cell boundary, re-insert
+    RemoveFromCells(proxy, p.cells);
+    p.cells = range;
+    InsertIntoCells(proxy, range);
+    m_reinsertCount++;
+}
+
+void SpatialHash::RemoveProxy(int proxy) {
+    Proxy& p = m_proxies[proxy];
+    if (!p.active) return;
+
+    RemoveFromCells(proxy, p.cells);
+    p.active = false;
+    m_freeProxies.push_back(proxy);
+    m_proxyCount--;
+}
+
+void SpatialHash::Clear() {
+    m_cells.clear();
+    m_proxies.clear();
+    m_freeProxies.clear();
+    m_pairs.clear();
+    m_proxyCount = 0;
+    m_reinsertCount = 0;
+}
+
+void SpatialHash::Update(const std::vector<Physics::AABB>& aabbs) {
+    int count = (int)aabbs.size();
+
+    // Drop proxies for bodies that no longer exist
+    for (int i = count; i < (int)m_proxies.size(); ++i) {
+        if (m_proxies[i].active) {
+            RemoveFromCells(i, m_proxies[i].cells);
+            m_proxyCount--;
+        }
+    }
+    if ((int)m_proxies.size() > count) {
+        m_proxies.resize(count);
+    }
+    m_freeProxies.clear();
+
+    for (int i = 0; i < count; ++i) {
+        if (i >= (int)m_proxies.size()) {
+            m_proxies.push_back(Proxy());
+            m_proxies[i].active = false;
+        }
+
+        Proxy& p = m_proxies[i];
+        if (p.active) {
+            MoveProxy(i, aabbs[i]);
+        } else {
+            p.aabb = aabbs[i];
+            p.cells = ComputeCellRange(aabbs[i]);
+            p.active = true;
+            InsertIntoCells(i, p.cells);
+            m_proxyCount++;
+        }
+    }
+}
+
+const std::vector<std::pair<int, int>>& SpatialHash::FindPairs() {
+    m_pairs.clear();
+
+    for (const auto& cell : m_cells) {
+        const std::vector<int>& proxies = cell.second;
+        if (proxies.size() < 2) continue;
+
+        int cellX = (int)(uint32_t)(cell.first >> 32);
+        int cellY = (int)(uint32_t)(cell.first & 0xFFFFFFFFu);
+
+        for (size_t i = 0; i < proxies.size(); ++i) {
+            const Proxy& a = m_proxies[proxies[i]];
+            for (size_t j = i + 1; j < proxies.size(); ++j) {
+                const Proxy& b = m_proxies[proxies[j]];
+
+                // Only the first shared cell reports the pair
+                if (std::max(a.cells.minX, b.cells.minX) != cellX ||
+                    std::max(a.cells.minY, b.cells.minY) != cellY) {
+                    continue;
+                }
+
+                if (!a.aabb.Intersects(b.aabb)) continue;
+
+                int first = proxies[i];
+                int second = proxies[j];
+                if (first > second) std::swap(first, second);
+                m_pairs.emplace_back(first, second);
+            }
+        }
+    }
+
+    m_reinsertCount = 0;
+    return m_pairs;
+}
+
+int SpatialHash::Query(const Physics::AABB& aabb, std::vector<int>& outProxies) const {
+    CellRange range = ComputeCellRange(aabb);
+
+    // Zoomed far out: walking the proxies beats probing mostly empty cells
+    int64_t cellCount = (int64_t)(range.maxX - range.minX + 1) * (range.maxY - range.minY + 1);
+    if (cellCount > (int64_t)m_proxies.size()) {
+        for (int proxy = 0; proxy < (int)m_proxies.size(); ++proxy) {
+            if (m_proxies[proxy].active && m_proxies[proxy].aabb.Intersects(aabb)) {
+                outProxies.push_back(proxy);
+            }
+        }
+        return (int)m_proxies.size();
+    }
+
+    int visited = 0;
+    for (int y = range.minY; y <= range.maxY; ++y) {
+        for (int x = range.minX; x <= range.maxX; ++x) {
+            visited++;
+            auto it = m_cells.find(CellKey(x, y));
+            if (it == m_cells.end()) continue;
+
+            for (int proxy : it->second) {
+                const Proxy& p = m_proxies[proxy];
+
+                // Report from the first cell the proxy shares with the query
+                if (std::max(p.cells.minX, range.minX) != x ||
+                    std::max(p.cells.minY, range.minY) != y) {
+                    continue;
+                }
+
+                if (p.aabb.Intersects(aabb)) {
+                    outProxies.push_back(proxy);
+                }
+            }
+        }
+    }
+    return visited;
+}
+
+SpatialHash::CellRange SpatialHash::ComputeCellRange(const Physics::AABB& aabb) const {
+    CellRange range;
+    range.minX = (int)std::floor(aabb.min.x * m_invCellSize);
+    range.minY = (int)std::floor(aabb.min.y * m_invCellSize);
+    range.maxX = (int)std::floor(aabb.max.x * m_invCellSize);
+    range.maxY = (int)std::floor(aabb.max.y * m_invCellSize);
+    return range;
+}
+
+void SpatialHash::InsertIntoCells(int proxy, const CellRange& range) {
+    for (int y = range.minY; y <= range.maxY; ++y) {
+        for (int x = range.minX; x <= range.maxX; ++x) {
+            m_cells[CellKey(x, y)].push_back(proxy);
+        }
+    }
+}
+
+void SpatialHash::RemoveFromCells(int proxy, const CellRange& range) {
+    for (int y = range.minY; y <= range.maxY; ++y) {
+        for (int x = range.minX; x <= range.maxX; ++x) {
+            auto it = m_cells.find(CellKey(x, y));
+            if (it == m_cells.end()) continue;
+
+            std::vector<int>& proxies = it->second;
+            auto found = std::find(proxies.begin(), proxies.end(), proxy);
+            if (found != proxies.end()) {
+                *found = proxies.back();
+                proxies.pop_back();
+            }
+
+            if (proxies.empty()) {
+                m_cells.erase(it);
+            }
+        }
+    }
+}
@@ -0,0 +1,667 @@
+#include "ContactSolver.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+static const int kRelaxIterations = 2;
+// Bodies plus contact solves per iteration; smaller islands share a job
+static const int kMinBatchWork = 256;
+// Bounces a bullet may take within one step; the rest of the step is dropped
+static const int kMaxBulletSubsteps = 4;
+
+static float Dot(const Vector2& a, const Vector2& b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+static bool HasShape(const Physics::Body& body) {
+    return body.size.x > 0.0f && body.size.y > 0.0f;
+}
+
+// Grows box to cover other; false if it already did
+static bool Cover(Physics::AABB& box, const Physics::AABB& other) {
+    if (other.min.x >= box.min.x && other.min.y >= box.min.y && other.max.x <= box.max.x && other.max.y <= box.max.y) {
+        return false;
+    }
+    box.min = Vector2(std::min(box.min.x, other.min.x), std::min(box.min.y, other.min.y));
+    box.max = Vector2(std::max(box.max.x, other.max.x), std::max(box.max.y, other.max.y));
+    return true;
+}
+
+ContactSolver::ContactSolver()
+    : m_iterations(8)
+    , m_warmStarting(true)
+    , m_baumgarte(0.2f)
+    , m_slop(0.5f)
+    , m_restitutionThreshold(30.0f)
+    , m_speculativeDistance(4.0f)
+    , m_sleepingEnabled(true)
+    , m_timeToSleep(0.5f)
+    , m_stats()
+{
+}
+
+void ContactSolver::Step(std::vector<Physics::Body>& bodies, float deltaTime, const Vector2& gravity, JobSystem* jobs) {
+    m_stats = StepStats();
+    if (deltaTime <= 0.0f) return;
+
+    size_t count = bodies.size();
+    m_inverseMass.resize(count);
+    m_awake.resize(count);
+    m_sweeping.resize(count);
+    m_sleepingIslandOf.resize(count, -1);
+    WakeRequestedIslands(bodies);
+
+    for (size_t i = 0; i < count; ++i) {
+        Physics::Body& body = bodies[i];
+        m_inverseMass[i] = body.isStatic || body.mass <= 0.0f ? 0.0f : 1.0f / body.mass;
+        m_awake[i] = m_inverseMass[i] > 0.0f && !body.isSleeping;
+        if (m_awake[i]) {
+            body.velocity = body.velocity + (body.acceleration + gravity) * deltaTime;
+        }
+
+        // Only bullets that could skip past something get the sweep
+        Vector2 motion = body.velocity * deltaTime;
+        m_sweeping[i] = m_awake[i] && body.isBullet && HasShape(body) &&
+                        (std::fabs(motion.x) > body.size.x || std::fabs(motion.y) > body.size.y);
+    }
+
+    FindContacts(bodies, deltaTime);
+    WakeTouchedIslands(bodies);
+    BuildIslands();
+
+    // Islands share no awake bodies, so they can be solved in any order, or
+    // at the same time, with the same result bit for bit
+    int islandCount = (int)m_islandStarts.size() - 1;
+    if (jobs && jobs->GetThreadCount() > 1 && islandCount > 1) {
+        BuildIslandBatches();
+        jobs->ParallelFor(m_batchStarts.size() - 1, 1, [&](size_t begin, size_t end) {
+            for (size_t batch = begin; batch < end; ++batch) {
+                for (int i = m_batchStarts[batch]; i < m_batchStarts[batch + 1]; ++i) {
+                    SolveIsland(m_islandOrder[i], bodies, deltaTime);
+                }
+            }
+        });
+    } else {
+        for (int island = 0; island < islandCount; ++island) {
+            SolveIsland(island, bodies, deltaTime);
+        }
+    }
+
+    // After every island, so bullets sweep against where the others ended up
+    SweepBullets(bodies, deltaTime);
+    SleepIslands(bodies, deltaTime);
+
+    m_stats.contacts = m_contacts.size();
+    m_stats.contactsSolved = m_islandContacts.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (m_inverseMass[i] == 0.0f) continue;
+
+        if (m_awake[i]) {
+            m_stats.awakeBodies++;
+        } else {
+            m_stats.sleepingBodies++;
+        }
+    }
+}
+
+void ContactSolver::Clear() {
+    m_broadphase.Clear();
+    m_contacts.clear();
+    m_previousContacts.clear();
+    m_islandContacts.clear();
+    m_sleepingIslandOf.clear();
+    m_sleepingIslands.clear();
+    m_freeSleepingIslands.clear();
+}
+
+void ContactSolver::WakeRequestedIslands(std::vector<Physics::Body>& bodies) {
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        const Physics::Body& body = bodies[i];
+        if (!m_sleepingEnabled && body.isSleeping) {
+            WakeBody(bodies, (int)i);
+        } else if (m_sleepingIslandOf[i] >= 0 && !body.isSleeping) {
+            // Woken from outside; the rest of its island follows
+            WakeBody(bodies, (int)i);
+        }
+    }
+}
+
+void ContactSolver::GatherPairs(const std::vector<Physics::Body>& bodies) {
+    m_pairs.clear();
+
+    size_t awakeCount = 0;
+    for (uint8_t awake : m_awake) {
+        awakeCount += awake;
+    }
+
+    if (awakeCount * 2 >= bodies.size()) {
+        for (const std::pair<int, int>& pair : m_broadphase.FindPairs()) {
+            if (m_awake[pair.first] || m_awake[pair.second]) {
+                m_pairs.push_back(pair);
+            }
+        }
+        return;
+    }
+
+    // Mostly asleep: only the awake bodies need to look for partners
+    for (int i = 0; i < (int)bodies.size(); ++i) {
+        if (!m_awake[i] || !HasShape(bodies[i])) continue;
+
+        m_queryResults.clear();
+        m_broadphase.QueryRect(m_bounds[i], m_queryResults);
+        for (int other : m_queryResults) {
+            // Two awake bodies find each other; keep one of the two
+            if (other == i || (m_awake[other] && other < i)) continue;
+            m_pairs.emplace_back(std::min(i, other), std::max(i, other));
+        }
+    }
+}
+
+void ContactSolver::FindContacts(const std::vector<Physics::Body>& bodies, float deltaTime) {
+    // Grown and swept along this step's motion so pairs that are about to
+    // touch are found too. Swept bullets only need the pairs they start in.
+    float margin = m_speculativeDistance / 2.0f;
+    m_bounds.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        Physics::AABB& box = m_bounds[i];
+        Vector2 motion = m_sweeping[i] ? Vector2(0, 0) : bodies[i].velocity * deltaTime;
+        box = bodies[i].GetBounds();
+        box.min = box.min - Vector2(margin - std::min(motion.x, 0.0f), margin - std::min(motion.y, 0.0f));
+        box.max = box.max + Vector2(margin + std::max(motion.x, 0.0f), margin + std::max(motion.y, 0.0f));
+    }
+    m_broadphase.Update(m_bounds);
+    GatherPairs(bodies);
+
+    m_previousContacts.swap(m_contacts);
+    m_contacts.clear();
+
+    for (const std::pair<int, int>& pair : m_pairs) {
+        int a = pair.first;
+        int b = pair.second;
+        if (!HasShape(bodies[a]) || !HasShape(bodies[b])) continue;
+        if (m_inverseMass[a] == 0.0f && m_inverseMass[b] == 0.0f) continue;
+        m_stats.pairsTested++;
+
+        // Overlap of the real boxes; negative is a gap
+        Physics::AABB boxA = bodies[a].GetBounds();
+        Physics::AABB boxB = bodies[b].GetBounds();
+        float overlapX = std::min(boxA.max.x, boxB.max.x) - std::max(boxA.min.x, boxB.min.x);
+        float overlapY = std::min(boxA.max.y, boxB.max.y) - std::max(boxA.min.y, boxB.min.y);
+
+        // How far each gap closes this step at the current velocities
+        Vector2 direction(bodies[b].position.x >= bodies[a].position.x ? 1.0f : -1.0f,
+                          bodies[b].position.y >= bodies[a].position.y ? 1.0f : -1.0f);
+        Vector2 relativeMotion = (bodies[b].velocity - bodies[a].velocity) * deltaTime;
+        float closingX = -relativeMotion.x * direction.x;
+        float closingY = -relativeMotion.y * direction.y;
+
+        // Push apart along the axis of least overlap, or across the gap. Boxes
+        // apart on both axes only meet if both gaps close, and then on the one
+        // that closes last.
+        bool alongX = overlapX < overlapY;
+        if (overlapX < 0.0f && overlapY < 0.0f) {
+            if (-overlapX > closingX || -overlapY > closingY) continue;
+            alongX = -overlapX * closingY > -overlapY * closingX;
+        }
+
+        // Keeping near contacts alive stops stacks from losing their
+        // warm-started impulses whenever a box lifts off slightly, and
+        // contacts closing within the step stop fast boxes sinking in deep
+        float penetration = alongX ? overlapX : overlapY;
+        float closing = alongX ? closingX : closingY;
+        if (penetration < -(m_speculativeDistance + std::max(closing, 0.0f))) continue;
+
+        Contact contact = Contact();
+        contact.key = ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+        contact.a = a;
+        contact.b = b;
+        contact.normal = alongX ? Vector2(direction.x, 0.0f) : Vector2(0.0f, direction.y);
+        contact.penetration = penetration;
+        contact.touching = penetration + std::max(closing, 0.0f) >= 0.0f;
+        m_contacts.push_back(contact);
+    }
+
+    // The broadphase reports pairs in no particular order; sorting keeps the
+    // solve order, and so the result, independent of the tree layout
+    auto byKey = [](const Contact& left, const Contact& right) {
+        return left.key < right.key;
+    };
+    std::sort(m_contacts.begin(), m_contacts.end(), byKey);
+
+    if (m_warmStarting) {
+        size_t previous = 0;
+        for (Contact& contact : m_contacts) {
+            while (previous < m_previousContacts.size() && m_previousContacts[previous].key < contact.key) {
+                previous++;
+            }
+            if (previous == m_previousContacts.size()) break;
+
+            const Contact& old = m_previousContacts[previous];
+            if (old.key == contact.key && old.normal.x == contact.normal.x && old.normal.y == contact.normal.y) {
+                contact.normalImpulse = old.normalImpulse;
+                contact.tangentImpulse = old.tangentImpulse;
+                m_stats.warmStarted++;
+            }
+        }
+    }
+
+    // Contacts with no awake body weren't tested; keep them as they were so
+    // a woken island starts from its resting impulses
+    size_t tested = m_contacts.size();
+    for (const Contact& old : m_previousContacts) {
+        if (old.a >= (int)bodies.size() || old.b >= (int)bodies.size()) continue;
+        if (m_awake[old.a] || m_awake[old.b]) continue;
+        if (bodies[old.a].isSleeping || bodies[old.b].isSleeping) {
+            m_contacts.push_back(old);
+        }
+    }
+    std::inplace_merge(m_contacts.begin(), m_contacts.begin() + tested, m_contacts.end(), byKey);
+}
+
+void ContactSolver::WakeTouchedIslands(std::vector<Physics::Body>& bodies) {
+    // A woken island can touch another, hence the repeat
+    bool wokeAny = true;
+    while (wokeAny) {
+        wokeAny = false;
+        for (const Contact& contact : m_contacts) {
+            if (!contact.touching) continue;
+
+            if (m_awake[contact.a] && bodies[contact.b].isSleeping) {
+                WakeBody(bodies, contact.b);
+                wokeAny = true;
+            } else if (m_awake[contact.b] && bodies[contact.a].isSleeping) {
+                WakeBody(bodies, contact.a);
+                wokeAny = true;
+            }
+        }
+    }
+}
+
+void ContactSolver::BuildIslands() {
+    size_t count = m_awake.size();
+    m_islandParent.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        m_islandParent[i] = (int)i;
+    }
+
+    // Static bodies don't join islands, or everything on the ground would
+    // be one island. Neither do gaps that stay open this step, so boxes
+    // lying side by side can sleep apart.
+    for (const Contact& contact : m_contacts) {
+        if (!contact.touching || !m_awake[contact.a] || !m_awake[contact.b]) continue;
+
+        int rootA = FindIslandRoot(contact.a);
+        int rootB = FindIslandRoot(contact.b);
+        if (rootA != rootB) {
+            // The lowest index stays root, so island order is deterministic
+            m_islandParent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+    }
+
+    // Number islands in order of their lowest body; roots come first since
+    // they are the lowest index of their island
+    m_islandOf.assign(count, -1);
+    int islandCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!m_awake[i]) continue;
+
+        int root = FindIslandRoot((int)i);
+        if (m_islandOf[root] < 0) {
+            m_islandOf[root] = islandCount++;
+        }
+        m_islandOf[i] = m_islandOf[root];
+    }
+
+    // Bucket the bodies by island, keeping index order within each
+    m_islandStarts.assign(islandCount + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        if (m_awake[i]) {
+            m_islandStarts[m_islandOf[i] + 1]++;
+        }
+    }
+    for (int island = 0; island < islandCount; ++island) {
+        m_islandStarts[island + 1] += m_islandStarts[island];
+    }
+
+    // The union-find array is done with; reuse it as the fill cursors
+    std::vector<int>& cursors = m_islandParent;
+    cursors.assign(m_islandStarts.begin(), m_islandStarts.end() - 1);
+    m_islandBodies.resize(m_islandStarts[islandCount]);
+    for (size_t i = 0; i < count; ++i) {
+        if (m_awake[i]) {
+            m_islandBodies[cursors[m_islandOf[i]]++] = (int)i;
+        }
+    }
+
+    // Same for the contacts, which stay in key order within each island.
+    // A gap that stays open between two islands, or to a sleeping body,
+    // isn't solved at all.
+    m_contactIsland.resize(m_contacts.size());
+    m_islandContactStarts.assign(islandCount + 1, 0);
+    for (size_t index = 0; index < m_contacts.size(); ++index) {
+        const Contact& contact = m_contacts[index];
+        int islandA = m_islandOf[contact.a];
+        int islandB = m_islandOf[contact.b];
+        bool dynamicA = m_inverseMass[contact.a] > 0.0f;
+        bool dynamicB = m_inverseMass[contact.b] > 0.0f;
+
+        int island = -1;
+        if (islandA >= 0 && (islandB == islandA || !dynamicB)) {
+            island = islandA;
+        } else if (islandB >= 0 && !dynamicA) {
+            island = islandB;
+        }
+        m_contactIsland[index] = island;
+        if (island >= 0) {
+            m_islandContactStarts[island + 1]++;
+        }
+    }
+    for (int island = 0; island < islandCount; ++island) {
+        m_islandContactStarts[island + 1] += m_islandContactStarts[island];
+    }
+
+    cursors.assign(m_islandContactStarts.begin(), m_islandContactStarts.end() - 1);
+    m_islandContacts.resize(m_islandContactStarts[islandCount]);
+    for (size_t index = 0; index < m_contacts.size(); ++index) {
+        if (m_contactIsland[index] >= 0) {
+            m_islandContacts[cursors[m_contactIsland[index]]++] = (int)index;
+        }
+    }
+
+    m_stats.islands = islandCount;
+    for (int island = 0; island < islandCount; ++island) {
+        size_t size = m_islandStarts[island + 1] - m_islandStarts[island];
+        m_stats.largestIsland = std::max(m_stats.largestIsland, size);
+    }
+}
+
+void ContactSolver::BuildIslandBatches() {
+    // Largest first, so the long islands start early and the small ones
+    // fill in the gaps at the end. Ties keep island order.
+    int islandCount = (int)m_islandStarts.size() - 1;
+    m_islandWork.resize(islandCount);
+    m_islandOrder.resize(islandCount);
+    for (int island = 0; island < islandCount; ++island) {
+        m_islandWork[island] = (m_islandStarts[island + 1] - m_islandStarts[island]) +
+                               (m_islandContactStarts[island + 1] - m_islandContactStarts[island]) * m_iterations;
+        m_islandOrder[island] = island;
+    }
+    std::stable_sort(m_islandOrder.begin(), m_islandOrder.end(), [this](int left, int right) {
+        return m_islandWork[left] > m_islandWork[right];
+    });
+
+    // Small islands are grouped so a job is worth scheduling
+    m_batchStarts.clear();
+    m_batchStarts.push_back(0);
+    int work = 0;
+    for (int i = 0; i < islandCount; ++i) {
+        work += m_islandWork[m_islandOrder[i]];
+        if (work >= kMinBatchWork) {
+            m_batchStarts.push_back(i + 1);
+            work = 0;
+        }
+    }
+    if (m_batchStarts.back() != islandCount) {
+        m_batchStarts.push_back(islandCount);
+    }
+}
+
+void ContactSolver::SolveIsland(int island, std::vector<Physics::Body>& bodies, float deltaTime) {
+    const int* contacts = m_islandContacts.data() + m_islandContactStarts[island];
+    int contactCount = m_islandContactStarts[island + 1] - m_islandContactStarts[island];
+
+    PrepareContacts(contacts, contactCount, bodies, deltaTime);
+    for (int iteration = 0; iteration < m_iterations; ++iteration) {
+        for (int i = 0; i < contactCount; ++i) {
+            SolveContact(m_contacts[contacts[i]], bodies, true);
+        }
+    }
+
+    for (int i = m_islandStarts[island]; i < m_islandStarts[island + 1]; ++i) {
+        if (m_sweeping[m_islandBodies[i]]) continue;
+
+        Physics::Body& body = bodies[m_islandBodies[i]];
+        body.position = body.position + body.velocity * deltaTime;
+        body.acceleration = Vector2(0, 0);
+    }
+
+    // The push out of penetration has done its job on the positions. Solving
+    // again without it keeps that velocity from carrying over, and from being
+    // warm started into the next step, where it would make stacks bounce.
+    for (int iteration = 0; iteration < kRelaxIterations; ++iteration) {
+        for (int i = 0; i < contactCount; ++i) {
+            SolveContact(m_contacts[contacts[i]], bodies, false);
+        }
+    }
+}
+
+void ContactSolver::SweepBullets(std::vector<Physics::Body>& bodies, float deltaTime) {
+    if (std::find(m_sweeping.begin(), m_sweeping.end(), 1) == m_sweeping.end()) return;
+
+    // The tree holds each body's bounds swept along its velocity from before
+    // the solve. A body the solve set moving, such as a resting box knocked
+    // into a bullet's path, can end up outside them, so grow those leaves to
+    // cover where the bodies are now.
+    for (int i = 0; i < (int)bodies.size(); ++i) {
+        if (m_sweeping[i] || m_inverseMass[i] == 0.0f || !HasShape(bodies[i])) continue;
+
+        if (Cover(m_bounds[i], bodies[i].GetBounds())) {
+            m_broadphase.MoveProxy(i, m_bounds[i]);
+        }
+    }
+
+    for (int i = 0; i < (int)bodies.size(); ++i) {
+        if (!m_sweeping[i]) continue;
+
+        Physics::Body& bullet = bodies[i];
+        bullet.acceleration = Vector2(0, 0);
+        m_stats.bulletsSwept++;
+
+        // Move up to the first body in the way, bounce off it, and go on with
+        // what is left of the step
+        float remaining = deltaTime;
+        for (int substep = 0; substep < kMaxBulletSubsteps && remaining > 0.0f; ++substep) {
+            Vector2 displacement = bullet.velocity * remaining;
+            Physics::AABB box = bullet.GetBounds();
+            Physics::AABB swept = box;
+            swept.min = swept.min + Vector2(std::min(displacement.x, 0.0f), std::min(displacement.y, 0.0f));
+            swept.max = swept.max + Vector2(std::max(displacement.x, 0.0f), std::max(displacement.y, 0.0f));
+
+            // Leaves cover each body's path this step up to where it is now.
+            // Other bullets are found where they started the step, so two
+            // bullets crossing in one step can miss. Ties go to the lower index.
+            m_queryResults.clear();
+            m_broadphase.QueryRect(swept, m_queryResults);
+            int hit = -1;
+            float hitTime = 1.0f;
+            Vector2 hitNormal;
+            for (int other : m_queryResults) {
+                if (other == i || !HasShape(bodies[other])) continue;
+
+                float time;
+                Vector2 normal;
+                if (Physics::SweepAABB(box, displacement, bodies[other].GetBounds(), time, normal) &&
+                    (time < hitTime || (time == hitTime && other < hit))) {
+                    hit = other;
+                    hitTime = time;
+                    hitNormal = normal;
+                }
+            }
+
+            if (hit < 0) {
+                bullet.position = bullet.position + displacement;
+                break;
+            }
+            bullet.position = bullet.position + displacement * hitTime;
+            remaining -= remaining * hitTime;
+            m_stats.bulletHits++;
+
+            // Already moving apart: leave the touching pair to the solver
+            Physics::Body& target = bodies[hit];
+            float normalVelocity = Dot(bullet.velocity - target.velocity, hitNormal);
+            if (normalVelocity >= 0.0f) break;
+
+            float restitution = normalVelocity < -m_restitutionThreshold ? (bullet.restitution + target.restitution) / 2.0f : 0.0f;
+            float impulse = -(1.0f + restitution) * normalVelocity / (m_inverseMass[i] + m_inverseMass[hit]);
+            bullet.velocity = bullet.velocity + hitNormal * (impulse * m_inverseMass[i]);
+            if (m_inverseMass[hit] > 0.0f) {
+                target.velocity = target.velocity - hitNormal * (impulse * m_inverseMass[hit]);
+                if (target.isSleeping) {
+                    WakeBody(bodies, hit);
+                }
+            }
+        }
+    }
+}
+
+void ContactSolver::PrepareContacts(const int* contacts, int contactCount, std::vector<Physics::Body>& bodies, float deltaTime) {
+    for (int i = 0; i < contactCount; ++i) {
+        Contact& contact = m_contacts[contacts[i]];
+        Physics::Body& a = bodies[contact.a];
+        Physics::Body& b = bodies[contact.b];
+        float inverseMassA = m_inverseMass[contact.a];
+        float inverseMassB = m_inverseMass[contact.b];
+
+        contact.mass = 1.0f / (inverseMassA + inverseMassB);
+        contact.friction = std::sqrt(a.friction * b.friction);
+        contact.restitution = (a.restitution + b.restitution) / 2.0f;
+
+        // Not touching yet: may approach, but only as far as closing the gap
+        if (contact.penetration < 0.0f) {
+            contact.bias = contact.penetration / deltaTime;
+            contact.relaxBias = contact.bias;
+        } else {
+            // Bounce off fast impacts, otherwise just push out of penetration
+            float normalVelocity = Dot(b.velocity - a.velocity, contact.normal);
+            float bounce = normalVelocity < -m_restitutionThreshold ? -contact.restitution * normalVelocity : 0.0f;
+            float correction = m_baumgarte / deltaTime * std::max(contact.penetration - m_slop, 0.0f);
+            contact.bias = std::max(bounce, correction);
+            contact.relaxBias = bounce;
+        }
+    }
+
+    // Only once every bounce is decided: a resting contact would otherwise
+    // see a neighbour's warm start as an impact
+    for (int i = 0; i < contactCount; ++i) {
+        const Contact& contact = m_contacts[contacts[i]];
+        if (contact.normalImpulse == 0.0f && contact.tangentImpulse == 0.0f) continue;
+
+        Vector2 tangent(-contact.normal.y, contact.normal.x);
+        Vector2 impulse = contact.normal * contact.normalImpulse + tangent * contact.tangentImpulse;
+        if (m_inverseMass[contact.a] > 0.0f) {
+            bodies[contact.a].velocity = bodies[contact.a].velocity - impulse * m_inverseMass[contact.a];
+        }
+        if (m_inverseMass[contact.b] > 0.0f) {
+            bodies[contact.b].velocity = bodies[contact.b].velocity + impulse * m_inverseMass[contact.b];
+        }
+    }
+}
+
+void ContactSolver::SolveContact(Contact& contact, std::vector<Physics::Body>& bodies, bool useBias) const {
+    float inverseMassA = m_inverseMass[contact.a];
+    float inverseMassB = m_inverseMass[contact.b];
+    Vector2 velocityA = bodies[contact.a].velocity;
+    Vector2 velocityB = bodies[contact.b].velocity;
+    Vector2 tangent(-contact.normal.y, contact.normal.x);
+
+    // Friction first, bounded by the normal impulse from the last iteration
+    float tangentVelocity = Dot(velocityB - velocityA, tangent);
+    float maxFriction = contact.friction * contact.normalImpulse;
+    float tangentImpulse = std::max(-maxFriction, std::min(contact.tangentImpulse - contact.mass * tangentVelocity, maxFriction));
+    float tangentDelta = tangentImpulse - contact.tangentImpulse;
+    contact.tangentImpulse = tangentImpulse;
+
+    velocityA = velocityA - tangent * (tangentDelta * inverseMassA);
+    velocityB = velocityB + tangent * (tangentDelta * inverseMassB);
+
+    // The accumulated normal impulse may shrink but never pull
+    float normalVelocity = Dot(velocityB - velocityA, contact.normal);
+    float target = useBias ? contact.bias : contact.relaxBias;
+    float normalImpulse = std::max(contact.normalImpulse + contact.mass * (target - normalVelocity), 0.0f);
+    float normalDelta = normalImpulse - contact.normalImpulse;
+    contact.normalImpulse = normalImpulse;
+
+    velocityA = velocityA - contact.normal * (normalDelta * inverseMassA);
+    velocityB = velocityB + contact.normal * (normalDelta * inverseMassB);
+
+    // Static bodies are shared by islands solved at the same time; never
+    // write them, even with an unchanged value
+    if (inverseMassA > 0.0f) bodies[contact.a].velocity = velocityA;
+    if (inverseMassB > 0.0f) bodies[contact.b].velocity = velocityB;
+}
+
+void ContactSolver::SleepIslands(std::vector<Physics::Body>& bodies, float deltaTime) {
+    for (int body : m_islandBodies) {
+        Physics::Body& b = bodies[body];
+        float speedSquared = Dot(b.velocity, b.velocity);
+        if (b.canSleep && speedSquared < b.sleepThreshold * b.sleepThreshold) {
+            b.sleepTime += deltaTime;
+        } else {
+            b.sleepTime = 0.0f;
+        }
+    }
+
+    if (!m_sleepingEnabled) return;
+
+    for (size_t island = 0; island + 1 < m_islandStarts.size(); ++island) {
+        int begin = m_islandStarts[island];
+        int end = m_islandStarts[island + 1];
+
+        // The whole island sleeps or none of it does
+        bool resting = true;
+        for (int i = begin; i < end && resting; ++i) {
+            resting = bodies[m_islandBodies[i]].sleepTime >= m_timeToSleep;
+        }
+        if (!resting) continue;
+
+        int id;
+        if (!m_freeSleepingIslands.empty()) {
+            id = m_freeSleepingIslands.back();
+            m_freeSleepingIslands.pop_back();
+        } else {
+            id = (int)m_sleepingIslands.size();
+            m_sleepingIslands.emplace_back();
+        }
+
+        std::vector<int>& members = m_sleepingIslands[id];
+        members.assign(m_islandBodies.begin() + begin, m_islandBodies.begin() + end);
+        for (int body : members) {
+            Physics::Body& b = bodies[body];
+            b.isSleeping = true;
+            b.velocity = Vector2(0, 0);
+            b.acceleration = Vector2(0, 0);
+            m_sleepingIslandOf[body] = id;
+            m_awake[body] = 0;
+        }
+        m_stats.islandsSlept++;
+    }
+}
+
+void ContactSolver::WakeBody(std::vector<Physics::Body>& bodies, int body) {
+    int id = m_sleepingIslandOf[body];
+    if (id < 0) {
+        Physics::WakeBody(bodies[body]);
+        m_awake[body] = m_inverseMass[body] > 0.0f;
+        return;
+    }
+
+    // Members past the end were removed since the island fell asleep
+    for (int member : m_sleepingIslands[id]) {
+        if (member >= (int)bodies.size()) continue;
+
+        Physics::WakeBody(bodies[member]);
+        m_sleepingIslandOf[member] = -1;
+        m_awake[member] = m_inverseMass[member] > 0.0f;
+    }
+    m_sleepingIslands[id].clear();
+    m_freeSleepingIslands.push_back(id);
+    m_stats.islandsWoken++;
+}
+
+int ContactSolver::FindIslandRoot(int body) {
+    while (m_islandParent[body] != body) {
+        m_islandParent[body] = m_islandParent[m_islandParent[body]];
+        body = m_islandParent[body];
+    }
+    return body;
+}
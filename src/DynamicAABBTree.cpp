@@ -0,0 +1,522 @@
+#include "DynamicAABBTree.h"
+#include <algorithm>
+#include <cmath>
+
+static Physics::AABB Union(const Physics::AABB& a, const Physics::AABB& b) {
+    Physics::AABB result;
+    result.min = Vector2(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y));
+    result.max = Vector2(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y));
+    return result;
+}
+
+// The 2D stand-in for surface area in the SAH cost
+static float Perimeter(const Physics::AABB& aabb) {
+    return 2.0f * ((aabb.max.x - aabb.min.x) + (aabb.max.y - aabb.min.y));
+}
+
+static bool Contains(const Physics::AABB& outer, const Physics::AABB& inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y &&
+           outer.max.x >= inner.max.x && outer.max.y >= inner.max.y;
+}
+
+static bool ContainsPoint(const Physics::AABB& aabb, const Vector2& point) {
+    return point.x >= aabb.min.x && point.x <= aabb.max.x &&
+           point.y >= aabb.min.y && point.y <= aabb.max.y;
+}
+
+// Slab test of the segment from + t * delta, t in [0, maxFraction]
+static bool RayIntersects(const Physics::AABB& aabb, const Vector2& from, const Vector2& delta,
+                          float maxFraction, float& outFraction) {
+    float tMin = 0.0f;
+    float tMax = maxFraction;
+    const float origin[2] = { from.x, from.y };
+    const float direction[2] = { delta.x, delta.y };
+    const float boxMin[2] = { aabb.min.x, aabb.min.y };
+    const float boxMax[2] = { aabb.max.x, aabb.max.y };
+
+    for (int axis = 0; axis < 2; ++axis) {
+        if (std::fabs(direction[axis]) < 1e-12f) {
+            if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis]) return false;
+            continue;
+        }
+
+        float inverse = 1.0f / direction[axis];
+        float t1 = (boxMin[axis] - origin[axis]) * inverse;
+        float t2 = (boxMax[axis] - origin[axis]) * inverse;
+        if (t1 > t2) std::swap(t1, t2);
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if (tMin > tMax) return false;
+    }
+
+    outFraction = tMin;
+    return true;
+}
+
+DynamicAABBTree::DynamicAABBTree(float fatMargin)
+    : m_root(kNullNode)
+    , m_freeList(kNullNode)
+    , m_proxyCount(0)
+    , m_reinsertCount(0)
+    , m_fatMargin(fatMargin)
+{
+}
+
+int DynamicAABBTree::AddProxy(const Physics::AABB& aabb, void* userData) {
+    int proxy;
+    if (!m_freeProxies.empty()) {
+        proxy = m_freeProxies.back();
+        m_freeProxies.pop_back();
+    } else {
+        proxy = (int)m_proxyNodes.size();
+        m_proxyNodes.push_back(kNullNode);
+    }
+
+    m_proxyNodes[proxy] = CreateLeaf(proxy, aabb, userData);
+    return proxy;
+}
+
+bool DynamicAABBTree::MoveProxy(int proxy, const Physics::AABB& aabb, const Vector2& displacement) {
+    int leaf = m_proxyNodes[proxy];
+    m_nodes[leaf].tight = aabb;
+
+    // Still inside the fat box, and the box isn't left over from a much faster move
+    Physics::AABB fat = MakeFat(aabb, displacement);
+    if (Contains(m_nodes[leaf].aabb, aabb) && Perimeter(m_nodes[leaf].aabb) <= 4.0f * Perimeter(fat)) {
+        return false;
+    }
+
+    RemoveLeaf(leaf);
+    m_nodes[leaf].aabb = fat;
+    InsertLeaf(leaf);
+    m_reinsertCount++;
+    return true;
+}
+
+void DynamicAABBTree::RemoveProxy(int proxy) {
+    if (proxy < 0 || proxy >= (int)m_proxyNodes.size() || m_proxyNodes[proxy] == kNullNode) return;
+
+    int leaf = m_proxyNodes[proxy];
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+    m_proxyNodes[proxy] = kNullNode;
+    m_freeProxies.push_back(proxy);
+    m_proxyCount--;
+}
+
+void DynamicAABBTree::Clear() {
+    m_nodes.clear();
+    m_root = kNullNode;
+    m_freeList = kNullNode;
+    m_proxyNodes.clear();
+    m_freeProxies.clear();
+    m_pairs.clear();
+    m_proxyCount = 0;
+    m_reinsertCount = 0;
+}
+
+void DynamicAABBTree::Update(const std::vector<Physics::AABB>& aabbs) {
+    int count = (int)aabbs.size();
+
+    // Drop proxies for bodies that no longer exist
+    for (int i = count; i < (int)m_proxyNodes.size(); ++i) {
+        RemoveProxy(i);
+    }
+    if ((int)m_proxyNodes.size() > count) {
+        m_proxyNodes.resize(count);
+    }
+    m_freeProxies.clear();
+
+    for (int i = 0; i < count; ++i) {
+        if (i >= (int)m_proxyNodes.size()) {
+            m_proxyNodes.push_back(kNullNode);
+        }
+
+        if (m_proxyNodes[i] != kNullNode) {
+            // Assume the body keeps moving the way it just did
+            Vector2 displacement = aabbs[i].min - m_nodes[m_proxyNodes[i]].tight.min;
+            MoveProxy(i, aabbs[i], displacement);
+        } else {
+            m_proxyNodes[i] = CreateLeaf(i, aabbs[i], nullptr);
+        }
+    }
+}
+
+const std::vector<std::pair<int, int>>& DynamicAABBTree::FindPairs() {
+    m_pairs.clear();
+    m_reinsertCount = 0;
+    if (m_root == kNullNode) return m_pairs;
+
+    // One descent of the tree against itself: a subtree is paired with itself
+    // and with every overlapping subtree once, instead of querying per leaf
+    m_pairStack.clear();
+    m_pairStack.emplace_back(m_root, m_root);
+    while (!m_pairStack.empty()) {
+        std::pair<int, int> top = m_pairStack.back();
+        m_pairStack.pop_back();
+        const Node& a = m_nodes[top.first];
+        const Node& b = m_nodes[top.second];
+
+        if (top.first == top.second) {
+            if (!a.IsLeaf()) {
+                m_pairStack.emplace_back(a.child1, a.child1);
+                m_pairStack.emplace_back(a.child2, a.child2);
+                m_pairStack.emplace_back(a.child1, a.child2);
+            }
+            continue;
+        }
+
+        if (!a.aabb.Intersects(b.aabb)) continue;
+
+        if (a.IsLeaf() && b.IsLeaf()) {
+            if (a.tight.Intersects(b.tight)) {
+                m_pairs.emplace_back(std::min(a.proxy, b.proxy), std::max(a.proxy, b.proxy));
+            }
+        } else if (b.IsLeaf() || (!a.IsLeaf() && Perimeter(a.aabb) >= Perimeter(b.aabb))) {
+            // Split the larger side
+            m_pairStack.emplace_back(a.child1, top.second);
+            m_pairStack.emplace_back(a.child2, top.second);
+        } else {
+            m_pairStack.emplace_back(top.first, b.child1);
+            m_pairStack.emplace_back(top.first, b.child2);
+        }
+    }
+
+    return m_pairs;
+}
+
+void DynamicAABBTree::QueryPoint(const Vector2& point, std::vector<int>& outProxies) const {
+    if (m_root == kNullNode) return;
+
+    m_stack.clear();
+    m_stack.push_back(m_root);
+    while (!m_stack.empty()) {
+        const Node& node = m_nodes[m_stack.back()];
+        m_stack.pop_back();
+        if (!ContainsPoint(node.aabb, point)) continue;
+
+        if (node.IsLeaf()) {
+            if (ContainsPoint(node.tight, point)) {
+                outProxies.push_back(node.proxy);
+            }
+        } else {
+            m_stack.push_back(node.child1);
+            m_stack.push_back(node.child2);
+        }
+    }
+}
+
+void DynamicAABBTree::QueryRect(const Physics::AABB& aabb, std::vector<int>& outProxies) const {
+    if (m_root == kNullNode) return;
+
+    m_stack.clear();
+    m_stack.push_back(m_root);
+    while (!m_stack.empty()) {
+        const Node& node = m_nodes[m_stack.back()];
+        m_stack.pop_back();
+        if (!node.aabb.Intersects(aabb)) continue;
+
+        if (node.IsLeaf()) {
+            if (node.tight.Intersects(aabb)) {
+                outProxies.push_back(node.proxy);
+            }
+        } else {
+            m_stack.push_back(node.child1);
+            m_stack.push_back(node.child2);
+        }
+    }
+}
+
+bool DynamicAABBTree::RayCast(const Vector2& from, const Vector2& to, RayHit& outHit) const {
+    if (m_root == kNullNode) return false;
+
+    Vector2 delta = to - from;
+    float best = 1.0f;
+    int bestProxy = kNullNode;
+
+    m_stack.clear();
+    m_stack.push_back(m_root);
+    while (!m_stack.empty()) {
+        const Node& node = m_nodes[m_stack.back()];
+        m_stack.pop_back();
+
+        // Subtrees entered beyond the closest hit so far can't do better
+        float fraction;
+        if (!RayIntersects(node.aabb, from, delta, best, fraction)) continue;
+
+        if (node.IsLeaf()) {
+            if (RayIntersects(node.tight, from, delta, best, fraction) &&
+                (bestProxy == kNullNode || fraction < best)) {
+                best = fraction;
+                bestProxy = node.proxy;
+            }
+        } else {
+            m_stack.push_back(node.child1);
+            m_stack.push_back(node.child2);
+        }
+    }
+
+    if (bestProxy == kNullNode) return false;
+
+    outHit.proxy = bestProxy;
+    outHit.fraction = best;
+    outHit.point = from + delta * best;
+    return true;
+}
+
+float DynamicAABBTree::GetAreaRatio() const {
+    if (m_root == kNullNode) return 0.0f;
+
+    float rootArea = Perimeter(m_nodes[m_root].aabb);
+    if (rootArea <= 0.0f) return 0.0f;
+
+    float totalArea = 0.0f;
+    for (const Node& node : m_nodes) {
+        if (node.height > 0) {
+            totalArea += Perimeter(node.aabb);
+        }
+    }
+    return totalArea / rootArea;
+}
+
+bool DynamicAABBTree::Validate() const {
+    if (m_root == kNullNode) return m_proxyCount == 0;
+    if (m_nodes[m_root].parent != kNullNode) return false;
+    return ValidateNode(m_root);
+}
+
+int DynamicAABBTree::CreateLeaf(int proxy, const Physics::AABB& aabb, void* userData) {
+    int leaf = AllocateNode();
+    Node& node = m_nodes[leaf];
+    node.aabb = MakeFat(aabb, Vector2(0, 0));
+    node.tight = aabb;
+    node.userData = userData;
+    node.proxy = proxy;
+    node.height = 0;
+
+    InsertLeaf(leaf);
+    m_proxyCount++;
+    return leaf;
+}
+
+int DynamicAABBTree::AllocateNode() {
+    int index;
+    if (m_freeList != kNullNode) {
+        index = m_freeList;
+        m_freeList = m_nodes[index].parent;
+    } else {
+        index = (int)m_nodes.size();
+        m_nodes.push_back(Node());
+    }
+
+    Node& node = m_nodes[index];
+    node.userData = nullptr;
+    node.proxy = kNullNode;
+    node.parent = kNullNode;
+    node.child1 = kNullNode;
+    node.child2 = kNullNode;
+    node.height = 0;
+    return index;
+}
+
+void DynamicAABBTree::FreeNode(int index) {
+    m_nodes[index].parent = m_freeList;
+    m_nodes[index].height = -1;
+    m_freeList = index;
+}
+
+void DynamicAABBTree::InsertLeaf(int leaf) {
+    if (m_root == kNullNode) {
+        m_root = leaf;
+        m_nodes[leaf].parent = kNullNode;
+        return;
+    }
+
+    // Walk down towards the cheapest sibling: creating a parent there costs
+    // its perimeter, and every ancestor grows by the inherited increase
+    Physics::AABB leafAABB = m_nodes[leaf].aabb;
+    int index = m_root;
+    while (!m_nodes[index].IsLeaf()) {
+        const Node& node = m_nodes[index];
+        float area = Perimeter(node.aabb);
+        float combinedArea = Perimeter(Union(node.aabb, leafAABB));
+
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float childCosts[2];
+        int children[2] = { node.child1, node.child2 };
+        for (int i = 0; i < 2; ++i) {
+            const Node& child = m_nodes[children[i]];
+            float grown = Perimeter(Union(leafAABB, child.aabb));
+            childCosts[i] = (child.IsLeaf() ? grown : grown - Perimeter(child.aabb)) + inheritanceCost;
+        }
+
+        if (cost < childCosts[0] && cost < childCosts[1]) break;
+        index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+    }
+
+    int sibling = index;
+    int oldParent = m_nodes[sibling].parent;
+    int newParent = AllocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].aabb = Union(leafAABB, m_nodes[sibling].aabb);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    m_nodes[newParent].child1 = sibling;
+    m_nodes[newParent].child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    if (oldParent == kNullNode) {
+        m_root = newParent;
+    } else if (m_nodes[oldParent].child1 == sibling) {
+        m_nodes[oldParent].child1 = newParent;
+    } else {
+        m_nodes[oldParent].child2 = newParent;
+    }
+
+    Refit(oldParent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int leaf) {
+    if (leaf == m_root) {
+        m_root = kNullNode;
+        return;
+    }
+
+    int parent = m_nodes[leaf].parent;
+    int grandParent = m_nodes[parent].parent;
+    int sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    FreeNode(parent);
+    m_nodes[leaf].parent = kNullNode;
+
+    if (grandParent == kNullNode) {
+        m_root = sibling;
+        m_nodes[sibling].parent = kNullNode;
+        return;
+    }
+
+    if (m_nodes[grandParent].child1 == parent) {
+        m_nodes[grandParent].child1 = sibling;
+    } else {
+        m_nodes[grandParent].child2 = sibling;
+    }
+    m_nodes[sibling].parent = grandParent;
+    Refit(grandParent);
+}
+
+void DynamicAABBTree::Refit(int index) {
+    while (index != kNullNode) {
+        Rotate(index);
+
+        Node& node = m_nodes[index];
+        const Node& child1 = m_nodes[node.child1];
+        const Node& child2 = m_nodes[node.child2];
+        node.aabb = Union(child1.aabb, child2.aabb);
+        node.height = 1 + std::max(child1.height, child2.height);
+        index = node.parent;
+    }
+}
+
+void DynamicAABBTree::Rotate(int a) {
+    // A has children B and C; B has D and E, C has F and G. Swaps a child
+    // of A with a grandchild on the other side when that shrinks the
+    // perimeter of the internal node that changes.
+    int b = m_nodes[a].child1;
+    int c = m_nodes[a].child2;
+    Node& nodeB = m_nodes[b];
+    Node& nodeC = m_nodes[c];
+    if (nodeB.IsLeaf() && nodeC.IsLeaf()) return;
+
+    enum Swap { None, BF, BG, CD, CE };
+    Swap best = None;
+    float bestCost = 0.0f;
+    Physics::AABB bestAABB;
+
+    if (!nodeC.IsLeaf()) {
+        float areaC = Perimeter(nodeC.aabb);
+        const Node& nodeF = m_nodes[nodeC.child1];
+        const Node& nodeG = m_nodes[nodeC.child2];
+
+        // B <-> F leaves C = B + G, B <-> G leaves C = F + B
+        Physics::AABB bg = Union(nodeB.aabb, nodeG.aabb);
+        Physics::AABB bf = Union(nodeB.aabb, nodeF.aabb);
+        float costBF = Perimeter(bg) - areaC;
+        float costBG = Perimeter(bf) - areaC;
+        if (costBF < bestCost) { best = BF; bestCost = costBF; bestAABB = bg; }
+        if (costBG < bestCost) { best = BG; bestCost = costBG; bestAABB = bf; }
+    }
+
+    if (!nodeB.IsLeaf()) {
+        float areaB = Perimeter(nodeB.aabb);
+        const Node& nodeD = m_nodes[nodeB.child1];
+        const Node& nodeE = m_nodes[nodeB.child2];
+
+        // C <-> D leaves B = C + E, C <-> E leaves B = D + C
+        Physics::AABB ce = Union(nodeC.aabb, nodeE.aabb);
+        Physics::AABB cd = Union(nodeC.aabb, nodeD.aabb);
+        float costCD = Perimeter(ce) - areaB;
+        float costCE = Perimeter(cd) - areaB;
+        if (costCD < bestCost) { best = CD; bestCost = costCD; bestAABB = ce; }
+        if (costCE < bestCost) { best = CE; bestCost = costCE; bestAABB = cd; }
+    }
+
+    switch (best) {
+        case None:
+            return;
+        case BF:
+        case BG: {
+            int swapped = best == BF ? nodeC.child1 : nodeC.child2;
+            int kept = best == BF ? nodeC.child2 : nodeC.child1;
+            m_nodes[a].child1 = swapped;
+            m_nodes[swapped].parent = a;
+            if (best == BF) nodeC.child1 = b; else nodeC.child2 = b;
+            nodeB.parent = c;
+            nodeC.aabb = bestAABB;
+            nodeC.height = 1 + std::max(nodeB.height, m_nodes[kept].height);
+            break;
+        }
+        case CD:
+        case CE: {
+            int swapped = best == CD ? nodeB.child1 : nodeB.child2;
+            int kept = best == CD ? nodeB.child2 : nodeB.child1;
+            m_nodes[a].child2 = swapped;
+            m_nodes[swapped].parent = a;
+            if (best == CD) nodeB.child1 = c; else nodeB.child2 = c;
+            nodeC.parent = b;
+            nodeB.aabb = bestAABB;
+            nodeB.height = 1 + std::max(nodeC.height, m_nodes[kept].height);
+            break;
+        }
+    }
+}
+
+Physics::AABB DynamicAABBTree::MakeFat(const Physics::AABB& aabb, const Vector2& displacement) const {
+    Physics::AABB fat;
+    fat.min = Vector2(aabb.min.x - m_fatMargin, aabb.min.y - m_fatMargin);
+    fat.max = Vector2(aabb.max.x + m_fatMargin, aabb.max.y + m_fatMargin);
+
+    // Stretch in the direction of travel
+    const float multiplier = 2.0f;
+    if (displacement.x < 0.0f) fat.min.x += displacement.x * multiplier;
+    else fat.max.x += displacement.x * multiplier;
+    if (displacement.y < 0.0f) fat.min.y += displacement.y * multiplier;
+    else fat.max.y += displacement.y * multiplier;
+    return fat;
+}
+
+bool DynamicAABBTree::ValidateNode(int index) const {
+    const Node& node = m_nodes[index];
+    if (node.IsLeaf()) {
+        return node.height == 0 && node.child2 == kNullNode &&
+               m_proxyNodes[node.proxy] == index && Contains(node.aabb, node.tight);
+    }
+
+    const Node& child1 = m_nodes[node.child1];
+    const Node& child2 = m_nodes[node.child2];
+    if (child1.parent != index || child2.parent != index) return false;
+    if (node.height != 1 + std::max(child1.height, child2.height)) return false;
+    if (!Contains(node.aabb, child1.aabb) || !Contains(node.aabb, child2.aabb)) return false;
+    return ValidateNode(node.child1) && ValidateNode(node.child2);
+}
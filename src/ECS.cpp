@@ -0,0 +1,307 @@
+#include "ECS.h"
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+
+static const size_t kColumnAlignment = 16;
+
+static size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// ComponentRegistry Implementation
+static std::vector<ComponentTypeInfo>& GetComponentTypes() {
+    static std::vector<ComponentTypeInfo> types;
+    return types;
+}
+
+static std::mutex& GetRegistryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+ComponentTypeId ComponentRegistry::Register(const ComponentTypeInfo& info) {
+    std::lock_guard<std::mutex> lock(GetRegistryMutex());
+    std::vector<ComponentTypeInfo>& types = GetComponentTypes();
+    if (types.size() >= kMaxComponentTypes) {
+        std::cerr << "Too many component types! The limit is " << kMaxComponentTypes << std::endl;
+        std::abort();
+    }
+    types.push_back(info);
+    return (ComponentTypeId)(types.size() - 1);
+}
+
+ComponentTypeInfo ComponentRegistry::GetInfo(ComponentTypeId id) {
+    std::lock_guard<std::mutex> lock(GetRegistryMutex());
+    return GetComponentTypes()[id];
+}
+
+// Archetype Implementation
+Archetype::Archetype(ComponentMask mask)
+    : m_mask(mask)
+    , m_chunkBytes(0)
+    , m_chunkCapacity(0)
+    , m_entityCount(0)
+{
+    size_t rowBytes = sizeof(Entity);
+    for (ComponentTypeId id = 0; id < kMaxComponentTypes; ++id) {
+        m_columnOffsets[id] = 0;
+        m_columnSizes[id] = 0;
+        if ((mask >> id) & 1) {
+            ComponentTypeInfo info = ComponentRegistry::GetInfo(id);
+            m_types.push_back(id);
+            m_infos.push_back(info);
+            m_columnSizes[id] = info.size;
+            rowBytes += info.size;
+        }
+    }
+
+    // Largest capacity whose padded layout still fits the chunk (at least one row)
+    uint32_t capacity = (uint32_t)std::max<size_t>(1, kChunkBytes / rowBytes);
+    for (;;) {
+        size_t offset = sizeof(Entity) * capacity;
+        for (size_t i = 0; i < m_types.size(); ++i) {
+            ComponentTypeId id = m_types[i];
+            const ComponentTypeInfo& info = m_infos[i];
+            offset = AlignUp(offset, std::max(info.alignment, kColumnAlignment));
+            m_columnOffsets[id] = offset;
+            offset += info.size * capacity;
+        }
+
+        if (offset <= kChunkBytes || capacity == 1) {
+            m_chunkBytes = AlignUp(offset, kColumnAlignment);
+            break;
+        }
+        capacity--;
+    }
+    m_chunkCapacity = capacity;
+}
+
+Archetype::~Archetype() {
+    for (auto& chunk : m_chunks) {
+        for (size_t i = 0; i < m_types.size(); ++i) {
+            const ComponentTypeInfo& info = m_infos[i];
+            uint8_t* column = (uint8_t*)GetColumn(chunk, m_types[i]);
+            for (uint32_t row = 0; row < chunk.count; ++row) {
+                info.destroy(column + row * info.size);
+            }
+        }
+        ::operator delete(chunk.data, std::align_val_t(64));
+    }
+}
+
+void Archetype::Allocate(Entity entity, uint32_t& outChunk, uint32_t& outRow) {
+    if (m_chunks.empty() || m_chunks.back().count == m_chunkCapacity) {
+        ArchetypeChunk chunk;
+        chunk.data = (uint8_t*)::operator new(m_chunkBytes, std::align_val_t(64));
+        chunk.entities = (Entity*)chunk.data;
+        chunk.count = 0;
+        m_chunks.push_back(chunk);
+    }
+
+    ArchetypeChunk& chunk = m_chunks.back();
+    outChunk = (uint32_t)(m_chunks.size() - 1);
+    outRow = chunk.count++;
+    chunk.entities[outRow] = entity;
+    m_entityCount++;
+}
+
+Entity Archetype::Remove(uint32_t chunkIndex, uint32_t row, bool destroyComponents) {
+    ArchetypeChunk& chunk = m_chunks[chunkIndex];
+    ArchetypeChunk& last = m_chunks.back();
+    uint32_t lastRow = last.count - 1;
+
+    for (size_t i = 0; i < m_types.size(); ++i) {
+        ComponentTypeId id = m_types[i];
+        const ComponentTypeInfo& info = m_infos[i];
+        uint8_t* hole = (uint8_t*)GetColumn(chunk, id) + row * info.size;
+        if (destroyComponents) {
+            info.destroy(hole);
+        }
+        if (&chunk != &last || row != lastRow) {
+            info.relocate(hole, (uint8_t*)GetColumn(last, id) + lastRow * info.size);
+        }
+    }
+
+    Entity moved;
+    if (&chunk != &last || row != lastRow) {
+        moved = last.entities[lastRow];
+        chunk.entities[row] = moved;
+    }
+
+    last.count--;
+    m_entityCount--;
+    if (last.count == 0) {
+        ::operator delete(last.data, std::align_val_t(64));
+        m_chunks.pop_back();
+    }
+    return moved;
+}
+
+// World Implementation
+World::World() : m_entityCount(0), m_jobSystem(nullptr) {
+}
+
+World::~World() {
+}
+
+Entity World::CreateEntity() {
+    return AllocateEntity(GetArchetype(0));
+}
+
+void World::DestroyEntity(Entity entity) {
+    if (!IsAlive(entity)) return;
+
+    EntityRecord& record = m_records[entity.index];
+    RemoveRow(record, true);
+    record.archetype = nullptr;
+    record.generation++;
+    m_freeIndices.push_back(entity.index);
+    m_entityCount--;
+}
+
+bool World::IsAlive(Entity entity) const {
+    return entity.index < m_records.size() &&
+           m_records[entity.index].generation == entity.generation &&
+           m_records[entity.index].archetype != nullptr;
+}
+
+void World::Clear() {
+    m_archetypes.clear();
+    m_archetypeLookup.clear();
+
+    // Keep the records so old handles stay detectably stale
+    m_freeIndices.clear();
+    for (uint32_t i = 0; i < (uint32_t)m_records.size(); ++i) {
+        if (m_records[i].archetype) {
+            m_records[i].archetype = nullptr;
+            m_records[i].generation++;
+        }
+        m_freeIndices.push_back(i);
+    }
+    m_entityCount = 0;
+}
+
+void World::AddSystem(const std::string& name, SystemFunction function) {
+    m_systems.push_back({ name, function });
+}
+
+void World::RemoveSystem(const std::string& name) {
+    for (auto it = m_systems.begin(); it != m_systems.end(); ++it) {
+        if (it->first == name) {
+            m_systems.erase(it);
+            return;
+        }
+    }
+}
+
+void World::RunSystems(float deltaTime) {
+    for (auto& system : m_systems) {
+        system.second(*this, deltaTime);
+    }
+}
+
+void World::IntegrateTransforms(float deltaTime) {
+    ParallelEach<TransformComponent>([deltaTime](TransformComponent& transform) {
+        transform.position = transform.position + transform.velocity * deltaTime;
+    });
+}
+
+Entity World::AllocateEntity(Archetype* archetype) {
+    uint32_t index;
+    if (!m_freeIndices.empty()) {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    } else {
+        index = (uint32_t)m_records.size();
+        m_records.push_back({ nullptr, 0, 0, 0 });
+    }
+
+    EntityRecord& record = m_records[index];
+    Entity entity(index, record.generation);
+    record.archetype = archetype;
+    archetype->Allocate(entity, record.chunk, record.row);
+    m_entityCount++;
+    return entity;
+}
+
+Archetype* World::GetArchetype(ComponentMask mask) {
+    auto it = m_archetypeLookup.find(mask);
+    if (it != m_archetypeLookup.end()) {
+        return it->second;
+    }
+
+    m_archetypes.push_back(std::make_unique<Archetype>(mask));
+    Archetype* archetype = m_archetypes.back().get();
+    m_archetypeLookup[mask] = archetype;
+    return archetype;
+}
+
+Archetype* World::GetAddTarget(Archetype* source, ComponentTypeId id) {
+    auto it = source->m_addEdges.find(id);
+    if (it != source->m_addEdges.end()) {
+        return it->second;
+    }
+
+    Archetype* target = GetArchetype(source->GetMask() | (ComponentMask(1) << id));
+    source->m_addEdges[id] = target;
+    target->m_removeEdges[id] = source;
+    return target;
+}
+
+Archetype* World::GetRemoveTarget(Archetype* source, ComponentTypeId id) {
+    auto it = source->m_removeEdges.find(id);
+    if (it != source->m_removeEdges.end()) {
+        return it->second;
+    }
+
+    Archetype* target = GetArchetype(source->GetMask() & ~(ComponentMask(1) << id));
+    source->m_removeEdges[id] = target;
+    target->m_addEdges[id] = source;
+    return target;
+}
+
+void World::MoveEntity(Entity entity, Archetype* target) {
+    EntityRecord& record = m_records[entity.index];
+    Archetype* source = record.archetype;
+
+    uint32_t chunkIndex, row;
+    target->Allocate(entity, chunkIndex, row);
+
+    ArchetypeChunk& from = source->GetChunk(record.chunk);
+    ArchetypeChunk& to = target->GetChunk(chunkIndex);
+    for (size_t i = 0; i < source->m_types.size(); ++i) {
+        ComponentTypeId id = source->m_types[i];
+        const ComponentTypeInfo& info = source->m_infos[i];
+        uint8_t* component = (uint8_t*)source->GetColumn(from, id) + record.row * info.size;
+        if (target->Has(id)) {
+            info.relocate((uint8_t*)target->GetColumn(to, id) + row * info.size, component);
+        } else {
+            info.destroy(component);
+        }
+    }
+
+    RemoveRow(record, false);
+    record.archetype = target;
+    record.chunk = chunkIndex;
+    record.row = row;
+}
+
+void World::RemoveRow(EntityRecord& record, bool destroyComponents) {
+    Entity moved = record.archetype->Remove(record.chunk, record.row, destroyComponents);
+    if (!moved.IsNull()) {
+        m_records[moved.index].chunk = record.chunk;
+        m_records[moved.index].row = record.row;
+    }
+}
+
+void* World::GetComponentData(Entity entity, ComponentTypeId id) const {
+    if (!IsAlive(entity)) return nullptr;
+
+    const EntityRecord& record = m_records[entity.index];
+    Archetype* archetype = record.archetype;
+    if (!archetype->Has(id)) return nullptr;
+
+    return (uint8_t*)archetype->GetColumn(archetype->GetChunk(record.chunk), id) +
+           record.row * archetype->m_columnSizes[id];
+}
@@ -3,12 +3,19 @@
 #include "AudioManager.h"
 #include "InputManager.h"
 #include "AssetManager.h"
+#include "JobSystem.h"
+#include <cmath>
 #include <iostream>
 
 Engine::Engine() 
     : m_window(nullptr)
     , m_isRunning(false)
     , m_lastTime(0)
+    , m_fixedTimestep(false)
+    , m_fixedDeltaTime(1.0f / 60.0f)
+    , m_maxStepsPerFrame(5)
+    , m_accumulator(0.0)
+    , m_interpolationAlpha(1.0f)
 {
 }
 
@@ -37,6 +44,9 @@ bool Engine::Initialize(const std::string& title, int width, int height) {
     }
 
     // Initialize subsystems
+    m_jobSystem = std::make_unique<JobSystem>();
+    std::cout << "Job system started with " << m_jobSystem->GetWorkerCount() << " worker threads" << std::endl;
+
     m_renderer = std::make_unique<Renderer>();
     if (!m_renderer->Initialize(m_window)) {
         std::cerr << "Renderer failed to initialize!" << std::endl;
@@ -53,6 +63,7 @@ bool Engine::Initialize(const std::string& title, int width, int height) {
     
     m_assetManager = std::make_unique<AssetManager>();
     m_assetManager->SetRenderer(m_renderer.get());
+    m_assetManager->SetJobSystem(m_jobSystem.get());
 
     m_isRunning = true;
     m_lastTime = SDL_GetTicksNS();
@@ -68,11 +79,57 @@ void Engine::Run() {
         m_lastTime = currentTime;
 
         HandleEvents();
-        Update(deltaTime);
+        m_jobSystem->RunMainThreadJobs();
+
+        if (m_fixedTimestep) {
+            m_accumulator += deltaTime;
+
+            int steps = 0;
+            while (m_accumulator >= m_fixedDeltaTime && steps < m_maxStepsPerFrame) {
+                Update(m_fixedDeltaTime);
+                m_accumulator -= m_fixedDeltaTime;
+                steps++;
+            }
+
+            // Hit the catch-up cap: drop the backlog instead of spiralling
+            if (m_accumulator >= m_fixedDeltaTime) {
+                m_accumulator = std::fmod(m_accumulator, (double)m_fixedDeltaTime);
+            }
+
+            m_interpolationAlpha = (float)(m_accumulator / m_fixedDeltaTime);
+        } else {
+            Update(deltaTime);
+            m_interpolationAlpha = 1.0f;
+        }
+
+        // Finished async texture loads, within the per-frame upload budget
+        m_assetManager->ProcessUploads();
+        m_audioManager->Update();
+
         Render();
     }
 }
 
+void Engine::SetFixedTimestep(bool enabled, float tickRate) {
+    m_fixedTimestep = enabled;
+    if (tickRate > 0.0f) {
+        m_fixedDeltaTime = 1.0f / tickRate;
+    }
+    m_accumulator = 0.0;
+    m_interpolationAlpha = 1.0f;
+}
+
+bool Engine::MountAssetPack(const std::string& packPath) {
+    if (!m_assetManager || !m_audioManager) {
+        std::cerr << "Engine must be initialized before mounting asset packs" << std::endl;
+        return false;
+    }
+    
+    bool texturesMounted = m_assetManager->MountPack(packPath);
+    bool soundsMounted = m_audioManager->MountPack(packPath);
+    return texturesMounted && soundsMounted;
+}
+
 void Engine::HandleEvents() {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
@@ -104,6 +161,12 @@ void Engine::Shutdown() {
         m_window = nullptr;
     }
     
+    // Workers may still reference other subsystems, stop them first
+    if (m_assetManager) {
+        m_assetManager->WaitForAsyncLoads();
+        m_assetManager->SetJobSystem(nullptr);
+    }
+    m_jobSystem.reset();
     m_assetManager.reset();
     m_audioManager.reset();
     m_inputManager.reset();
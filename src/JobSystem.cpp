@@ -0,0 +1,209 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+static thread_local int t_threadIndex = 0;
+
+JobSystem::JobSystem(int workerCount)
+    : m_mainThreadId(std::this_thread::get_id())
+    , m_pendingJobs(0)
+    , m_sleepingWorkers(0)
+    , m_quit(false)
+{
+    if (workerCount < 0) {
+        workerCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    }
+
+    // Queue 0 belongs to the main thread
+    for (int i = 0; i <= workerCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    for (int i = 1; i <= workerCount; ++i) {
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_quit = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::Schedule(JobFunction function, JobCounter* signal, JobCounter* dependency) {
+    if (signal) {
+        signal->m_value.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    if (dependency) {
+        std::lock_guard<std::mutex> lock(dependency->m_mutex);
+        if (dependency->m_value.load(std::memory_order_acquire) != 0) {
+            dependency->m_dependents.push_back({std::move(function), signal});
+            return;
+        }
+    }
+
+    Push({std::move(function), signal});
+}
+
+void JobSystem::ScheduleMainThread(JobFunction function, JobCounter* signal) {
+    if (signal) {
+        signal->m_value.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+    m_mainThreadJobs.push_back({std::move(function), signal});
+}
+
+void JobSystem::RunMainThreadJobs() {
+    std::deque<Job> jobs;
+    {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        jobs.swap(m_mainThreadJobs);
+    }
+
+    // Jobs queued from here on run next time
+    for (auto& job : jobs) {
+        Execute(job);
+    }
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    int self = GetCurrentThreadIndex();
+    if (self >= (int)m_queues.size()) self = 0;
+
+    while (!counter.IsDone()) {
+        Job job;
+        if (Pop(self, job) || Steal(self, job)) {
+            Execute(job);
+            continue;
+        }
+
+        if (std::this_thread::get_id() == m_mainThreadId && RunOneMainThreadJob()) {
+            continue;
+        }
+
+        std::this_thread::yield();
+    }
+
+    // The last finisher decrements under this lock; once we own it, nobody
+    // touches the counter again and the caller may destroy it
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grainSize, const RangeFunction& function) {
+    if (count == 0) return;
+    if (grainSize == 0) grainSize = 1;
+
+    JobCounter counter;
+    for (size_t begin = 0; begin < count; begin += grainSize) {
+        size_t end = std::min(count, begin + grainSize);
+        Schedule([&function, begin, end]() { function(begin, end); }, &counter);
+    }
+
+    Wait(counter);
+}
+
+int JobSystem::GetCurrentThreadIndex() {
+    return t_threadIndex;
+}
+
+void JobSystem::Push(Job job) {
+    int self = GetCurrentThreadIndex();
+    if (self >= (int)m_queues.size()) self = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_queues[self]->mutex);
+        m_queues[self]->jobs.push_back(std::move(job));
+    }
+    m_pendingJobs.fetch_add(1);
+
+    // Only pay for the wake-up when someone is actually asleep
+    if (m_sleepingWorkers.load() > 0) {
+        { std::lock_guard<std::mutex> lock(m_wakeMutex); }
+        m_wakeCondition.notify_one();
+    }
+}
+
+bool JobSystem::Pop(int threadIndex, Job& job) {
+    WorkQueue& queue = *m_queues[threadIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+
+    // Newest first: its data is most likely still in cache
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    m_pendingJobs.fetch_sub(1);
+    return true;
+}
+
+bool JobSystem::Steal(int threadIndex, Job& job) {
+    int count = (int)m_queues.size();
+    for (int i = 1; i < count; ++i) {
+        WorkQueue& queue = *m_queues[(threadIndex + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+
+        // Oldest first: usually the biggest chunk of remaining work
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        m_pendingJobs.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::RunOneMainThreadJob() {
+    Job job;
+    {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        if (m_mainThreadJobs.empty()) return false;
+        job = std::move(m_mainThreadJobs.front());
+        m_mainThreadJobs.pop_front();
+    }
+
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Execute(Job& job) {
+    job.function();
+
+    if (!job.signal) return;
+
+    std::vector<JobCounter::PendingJob> ready;
+    {
+        std::lock_guard<std::mutex> lock(job.signal->m_mutex);
+        if (job.signal->m_value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.swap(job.signal->m_dependents);
+        }
+    }
+
+    for (auto& pending : ready) {
+        Push({std::move(pending.function), pending.signal});
+    }
+}
+
+void JobSystem::WorkerLoop(int threadIndex) {
+    t_threadIndex = threadIndex;
+
+    while (!m_quit.load()) {
+        Job job;
+        if (Pop(threadIndex, job) || Steal(threadIndex, job)) {
+            Execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_sleepingWorkers.fetch_add(1);
+        m_wakeCondition.wait(lock, [this]() {
+            return m_pendingJobs.load() > 0 || m_quit.load();
+        });
+        m_sleepingWorkers.fetch_sub(1);
+    }
+}
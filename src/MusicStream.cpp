@@ -0,0 +1,314 @@
+#include "MusicStream.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+static uint16_t ReadU16(const uint8_t* bytes) {
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+static uint32_t ReadU32(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+MusicStream::MusicStream(int sampleRate)
+    : m_sampleRate(sampleRate > 0 ? sampleRate : 48000)
+    , m_file(nullptr)
+    , m_format(0)
+    , m_channels(0)
+    , m_fileRate(0)
+    , m_bitsPerSample(0)
+    , m_blockAlign(0)
+    , m_dataOffset(0)
+    , m_dataBytes(0)
+    , m_outputChannels(1)
+    , m_dataRead(0)
+    , m_loops(0)
+    , m_chunkInput(kChunkFrames)
+    , m_decodeOnRead(false)
+    , m_step(1.0)
+    , m_position(0.0)
+    , m_quit(false)
+    , m_readFrame(0)
+    , m_writeFrame(0)
+    , m_endOfData(false)
+    , m_framesDecoded(0)
+    , m_bytesRead(0)
+    , m_underruns(0)
+    , m_underrunFrames(0)
+{
+    m_lastFrame[0] = m_lastFrame[1] = 0.0f;
+}
+
+MusicStream::~MusicStream() {
+    if (m_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit.store(true, std::memory_order_release);
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+    if (m_file) {
+        std::fclose(m_file);
+    }
+}
+
+bool MusicStream::Open(const std::string& path) {
+    if (!ReadHeader(path)) {
+        if (m_file) {
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+        return false;
+    }
+
+    m_outputChannels = std::min(m_channels, 2);
+    m_step = (double)m_fileRate / m_sampleRate;
+    // Upsampling makes more frames than it reads, so read fewer
+    m_chunkInput = m_step >= 1.0 ? kChunkFrames : std::max(1, (int)(kChunkFrames * m_step));
+
+    m_raw.resize((size_t)m_chunkInput * m_blockAlign);
+    m_decoded.resize((size_t)m_chunkInput * m_outputChannels);
+    if (m_step != 1.0) {
+        m_resampled.resize((size_t)(kChunkFrames + 2) * m_outputChannels);
+    }
+    m_ring.resize((size_t)kRingFrames * m_outputChannels);
+    return true;
+}
+
+bool MusicStream::ReadHeader(const std::string& path) {
+    m_file = std::fopen(path.c_str(), "rb");
+    if (!m_file) {
+        std::cerr << "Failed to open music " << path << std::endl;
+        return false;
+    }
+
+    uint8_t riff[12];
+    if (std::fread(riff, 1, sizeof(riff), m_file) != sizeof(riff) || std::memcmp(riff, "RIFF", 4) != 0 ||
+        std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        std::cerr << "Music " << path << " is not a WAV file" << std::endl;
+        return false;
+    }
+
+    // fmt must come before data; anything else is skipped
+    bool haveFormat = false;
+    uint8_t header[8];
+    while (std::fread(header, 1, sizeof(header), m_file) == sizeof(header)) {
+        uint32_t size = ReadU32(header + 4);
+        if (std::memcmp(header, "fmt ", 4) == 0) {
+            uint8_t format[40] = {};
+            uint32_t length = std::min(size, (uint32_t)sizeof(format));
+            if (size < 16 || std::fread(format, 1, length, m_file) != length) break;
+            m_format = ReadU16(format);
+            m_channels = ReadU16(format + 2);
+            m_fileRate = (int)ReadU32(format + 4);
+            m_blockAlign = ReadU16(format + 12);
+            m_bitsPerSample = ReadU16(format + 14);
+            // WAVE_FORMAT_EXTENSIBLE keeps the real format in its sub-format GUID
+            if (m_format == 0xFFFE && length >= 26) {
+                m_format = ReadU16(format + 24);
+            }
+            haveFormat = true;
+            if (std::fseek(m_file, (long)(size - length + (size & 1)), SEEK_CUR) != 0) break;
+        } else if (std::memcmp(header, "data", 4) == 0) {
+            if (!haveFormat) break;
+            m_dataOffset = std::ftell(m_file);
+            m_dataBytes = size;
+            break;
+        } else if (std::fseek(m_file, (long)(size + (size & 1)), SEEK_CUR) != 0) {
+            break;
+        }
+    }
+
+    if (m_dataOffset == 0) {
+        std::cerr << "Music " << path << " has no audio data" << std::endl;
+        return false;
+    }
+    bool pcm = m_format == 1 && (m_bitsPerSample == 8 || m_bitsPerSample == 16 || m_bitsPerSample == 24 ||
+                                 m_bitsPerSample == 32);
+    bool floating = m_format == 3 && m_bitsPerSample == 32;
+    if ((!pcm && !floating) || m_channels < 1 || m_fileRate <= 0 ||
+        m_blockAlign != m_channels * m_bitsPerSample / 8) {
+        std::cerr << "Music " << path << " has an unsupported format (" << m_format << ", " << m_bitsPerSample
+                  << " bits, " << m_channels << " channels)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+double MusicStream::GetDuration() const {
+    return m_fileRate > 0 ? (double)(m_dataBytes / m_blockAlign) / m_fileRate : 0.0;
+}
+
+void MusicStream::Start(int loops, bool readerThread) {
+    if (!m_file || m_thread.joinable()) return;
+
+    m_loops = loops;
+    if (!readerThread) {
+        m_decodeOnRead = true;
+        return;
+    }
+    // A quarter of the ring up front, so the first mixes don't run dry
+    while (m_writeFrame.load(std::memory_order_relaxed) < (size_t)kRingFrames / 4) {
+        if (!DecodeChunk()) {
+            m_endOfData.store(true, std::memory_order_release);
+            return;
+        }
+    }
+    m_thread = std::thread(&MusicStream::ReadLoop, this);
+}
+
+void MusicStream::ReadLoop() {
+    while (!m_quit.load(std::memory_order_acquire)) {
+        if (GetFreeFrames() >= (size_t)kChunkFrames + 2) {
+            if (!DecodeChunk()) {
+                m_endOfData.store(true, std::memory_order_release);
+                return;
+            }
+            continue;
+        }
+
+        // The audio thread can't signal without risking a lock, so poll;
+        // the ring holds many times this interval
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait_for(lock, std::chrono::milliseconds(5), [this] { return m_quit.load(std::memory_order_acquire); });
+    }
+}
+
+bool MusicStream::Rewind() {
+    if (std::fseek(m_file, m_dataOffset, SEEK_SET) != 0) return false;
+    m_dataRead = 0;
+    return true;
+}
+
+bool MusicStream::DecodeChunk() {
+    int frames = 0;
+    // Twice at most: once to hit the end, once more after looping back
+    for (int attempt = 0; attempt < 2 && frames == 0; ++attempt) {
+        if (m_dataBytes - m_dataRead < (uint32_t)m_blockAlign) {
+            if (m_loops == 0 || !Rewind()) return false;
+            if (m_loops > 0) m_loops--;
+        }
+
+        uint32_t wanted = std::min((uint32_t)m_chunkInput, (m_dataBytes - m_dataRead) / m_blockAlign) * m_blockAlign;
+        size_t got = std::fread(m_raw.data(), 1, wanted, m_file);
+        m_bytesRead.fetch_add(got, std::memory_order_relaxed);
+        // A short read means the file ends before its header says
+        m_dataRead = got < wanted ? m_dataBytes : m_dataRead + wanted;
+        frames = (int)(got / m_blockAlign);
+    }
+    if (frames == 0) return false;
+
+    ConvertChunk(frames);
+    if (m_step == 1.0) {
+        WriteRing(m_decoded.data(), frames);
+        return true;
+    }
+
+    // Linear interpolation, carrying the position and last frame over so
+    // chunks (and loops) join without a seam
+    int channels = m_outputChannels;
+    int count = 0;
+    double position = m_position;
+    while (position < frames - 1) {
+        int index = (int)std::floor(position);
+        float fraction = (float)(position - index);
+        const float* a = index < 0 ? m_lastFrame : &m_decoded[(size_t)index * channels];
+        const float* b = &m_decoded[(size_t)(index + 1) * channels];
+        for (int c = 0; c < channels; ++c) {
+            m_resampled[(size_t)count * channels + c] = a[c] + (b[c] - a[c]) * fraction;
+        }
+        count++;
+        position += m_step;
+    }
+    m_position = position - frames;
+    std::memcpy(m_lastFrame, &m_decoded[(size_t)(frames - 1) * channels], sizeof(float) * channels);
+    WriteRing(m_resampled.data(), count);
+    return true;
+}
+
+void MusicStream::ConvertChunk(int frames) {
+    int bytesPerSample = m_bitsPerSample / 8;
+    for (int i = 0; i < frames; ++i) {
+        const uint8_t* frame = &m_raw[(size_t)i * m_blockAlign];
+        for (int c = 0; c < m_outputChannels; ++c) {
+            const uint8_t* sample = frame + c * bytesPerSample;
+            float value;
+            if (m_format == 3) {
+                std::memcpy(&value, sample, sizeof(float));
+            } else if (bytesPerSample == 1) {
+                value = (sample[0] - 128) / 128.0f;
+            } else if (bytesPerSample == 2) {
+                value = (int16_t)ReadU16(sample) / 32768.0f;
+            } else if (bytesPerSample == 3) {
+                int32_t bits = (int32_t)((uint32_t)sample[0] << 8 | (uint32_t)sample[1] << 16 | (uint32_t)sample[2] << 24);
+                value = (bits >> 8) / 8388608.0f;
+            } else {
+                value = (int32_t)ReadU32(sample) / 2147483648.0f;
+            }
+            m_decoded[(size_t)i * m_outputChannels + c] = value;
+        }
+    }
+}
+
+size_t MusicStream::GetFreeFrames() const {
+    return kRingFrames - (m_writeFrame.load(std::memory_order_relaxed) - m_readFrame.load(std::memory_order_acquire));
+}
+
+void MusicStream::WriteRing(const float* samples, int frames) {
+    size_t write = m_writeFrame.load(std::memory_order_relaxed);
+    int start = (int)(write & (kRingFrames - 1));
+    int first = std::min(frames, kRingFrames - start);
+    std::memcpy(&m_ring[(size_t)start * m_outputChannels], samples, sizeof(float) * first * m_outputChannels);
+    std::memcpy(m_ring.data(), samples + (size_t)first * m_outputChannels,
+                sizeof(float) * (frames - first) * m_outputChannels);
+    m_framesDecoded.fetch_add(frames, std::memory_order_relaxed);
+    m_writeFrame.store(write + frames, std::memory_order_release);
+}
+
+int MusicStream::Read(float* output, int frames) {
+    size_t read = m_readFrame.load(std::memory_order_relaxed);
+    size_t available = m_writeFrame.load(std::memory_order_acquire) - read;
+    while (m_decodeOnRead && available < (size_t)frames && !m_endOfData.load(std::memory_order_relaxed)) {
+        if (!DecodeChunk()) {
+            m_endOfData.store(true, std::memory_order_release);
+        }
+        available = m_writeFrame.load(std::memory_order_relaxed) - read;
+    }
+    int count = (int)std::min((size_t)frames, available);
+
+    int start = (int)(read & (kRingFrames - 1));
+    int first = std::min(count, kRingFrames - start);
+    std::memcpy(output, &m_ring[(size_t)start * m_outputChannels], sizeof(float) * first * m_outputChannels);
+    std::memcpy(output + (size_t)first * m_outputChannels, m_ring.data(),
+                sizeof(float) * (count - first) * m_outputChannels);
+    m_readFrame.store(read + count, std::memory_order_release);
+
+    // Running dry before the end is an underrun: the reader fell behind
+    if (count < frames && !m_endOfData.load(std::memory_order_acquire)) {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+        m_underrunFrames.fetch_add(frames - count, std::memory_order_relaxed);
+    }
+    return count;
+}
+
+bool MusicStream::IsFinished() const {
+    // End first: once it's set, the last write is visible too
+    return m_endOfData.load(std::memory_order_acquire) &&
+           m_readFrame.load(std::memory_order_relaxed) == m_writeFrame.load(std::memory_order_acquire);
+}
+
+MusicStream::Stats MusicStream::GetStats() const {
+    Stats stats = Stats();
+    stats.bufferedFrames = m_writeFrame.load(std::memory_order_acquire) - m_readFrame.load(std::memory_order_acquire);
+    stats.framesDecoded = m_framesDecoded.load(std::memory_order_relaxed);
+    stats.bytesRead = m_bytesRead.load(std::memory_order_relaxed);
+    stats.underruns = m_underruns.load(std::memory_order_relaxed);
+    stats.underrunFrames = m_underrunFrames.load(std::memory_order_relaxed);
+    stats.residentBytes = m_raw.capacity() +
+                          sizeof(float) * (m_decoded.capacity() + m_resampled.capacity() + m_ring.capacity());
+    return stats;
+}
@@ -1,8 +1,13 @@
 #include "Physics.h"
+#include <algorithm>
 #include <cmath>
 
+Physics::AABB Physics::Body::GetBounds() const {
+    return AABB(position, size.x, size.y);
+}
+
 void Physics::UpdateBody(Body& body, float deltaTime) {
-    if (body.isStatic) return;
+    if (body.isStatic || body.isSleeping) return;
     
     // Update velocity with acceleration
     body.velocity.x += body.acceleration.x * deltaTime;
@@ -18,16 +23,67 @@ void Physics::UpdateBody(Body& body, float deltaTime) {
 }
 
 void Physics::ApplyGravity(Body& body, const Vector2& gravity) {
-    if (!body.isStatic) {
+    if (!body.isStatic && !body.isSleeping) {
         body.acceleration.x += gravity.x;
         body.acceleration.y += gravity.y;
     }
 }
 
+void Physics::ApplyImpulse(Body& body, const Vector2& impulse) {
+    if (body.isStatic || body.mass <= 0.0f) return;
+    
+    WakeBody(body);
+    body.velocity.x += impulse.x / body.mass;
+    body.velocity.y += impulse.y / body.mass;
+}
+
+void Physics::WakeBody(Body& body) {
+    body.isSleeping = false;
+    body.sleepTime = 0.0f;
+}
+
 bool Physics::CheckCollision(const AABB& a, const AABB& b) {
     return a.Intersects(b);
 }
 
+bool Physics::SweepAABB(const AABB& box, const Vector2& displacement, const AABB& target,
+                        float& timeOfImpact, Vector2& normal) {
+    // Per axis, the fraction of the move during which the two intervals
+    // overlap; the boxes touch while both axes do
+    float enter[2], exit[2];
+    float boxMin[2] = { box.min.x, box.min.y };
+    float boxMax[2] = { box.max.x, box.max.y };
+    float targetMin[2] = { target.min.x, target.min.y };
+    float targetMax[2] = { target.max.x, target.max.y };
+    float move[2] = { displacement.x, displacement.y };
+    
+    for (int axis = 0; axis < 2; ++axis) {
+        if (move[axis] == 0.0f) {
+            if (boxMax[axis] <= targetMin[axis] || boxMin[axis] >= targetMax[axis]) return false;
+            enter[axis] = -INFINITY;
+            exit[axis] = INFINITY;
+        } else if (move[axis] > 0.0f) {
+            enter[axis] = (targetMin[axis] - boxMax[axis]) / move[axis];
+            exit[axis] = (targetMax[axis] - boxMin[axis]) / move[axis];
+        } else {
+            enter[axis] = (targetMax[axis] - boxMin[axis]) / move[axis];
+            exit[axis] = (targetMin[axis] - boxMax[axis]) / move[axis];
+        }
+    }
+    
+    float first = std::max(enter[0], enter[1]);
+    float last = std::min(exit[0], exit[1]);
+    if (first > last || first < 0.0f || first >= 1.0f || last <= 0.0f) return false;
+    
+    timeOfImpact = first;
+    if (enter[0] > enter[1]) {
+        normal = Vector2(move[0] > 0.0f ? -1.0f : 1.0f, 0.0f);
+    } else {
+        normal = Vector2(0.0f, move[1] > 0.0f ? -1.0f : 1.0f);
+    }
+    return true;
+}
+
 void Physics::ResolveCollision(Body& a, Body& b, const AABB& aabb1, const AABB& aabb2) {
     // Calculate overlap
     float overlapX = std::min(aabb1.max.x, aabb2.max.x) - std::max(aabb1.min.x, aabb2.min.x);
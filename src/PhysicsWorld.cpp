@@ -0,0 +1,358 @@
+#include "PhysicsWorld.h"
+#include "JobSystem.h"
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define PHYSICS_WORLD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PHYSICS_WORLD_SSE
+#endif
+
+#if defined(PHYSICS_WORLD_AVX) || defined(PHYSICS_WORLD_SSE)
+// Per-lane integration factor for each 4-bit slice of the static mask:
+// 1 for dynamic bodies, 0 for static ones
+alignas(16) static const float kDynamicLanes[16][4] = {
+    {1, 1, 1, 1}, {0, 1, 1, 1}, {1, 0, 1, 1}, {0, 0, 1, 1},
+    {1, 1, 0, 1}, {0, 1, 0, 1}, {1, 0, 0, 1}, {0, 0, 0, 1},
+    {1, 1, 1, 0}, {0, 1, 1, 0}, {1, 0, 1, 0}, {0, 0, 1, 0},
+    {1, 1, 0, 0}, {0, 1, 0, 0}, {1, 0, 0, 0}, {0, 0, 0, 0},
+};
+#endif
+
+namespace {
+
+struct IntegrateArrays {
+    float* x;
+    float* y;
+    float* vx;
+    float* vy;
+    float* ax;
+    float* ay;
+    const uint32_t* staticMask;
+};
+
+inline bool IsStaticBit(const uint32_t* mask, size_t i) {
+    return (mask[i >> 5] >> (i & 31)) & 1u;
+}
+
+template <bool WithAcceleration>
+inline void IntegrateOne(const IntegrateArrays& a, size_t i, float deltaTime, const Vector2& gravity) {
+    float accX = gravity.x;
+    float accY = gravity.y;
+    if (WithAcceleration) {
+        accX += a.ax[i];
+        accY += a.ay[i];
+        a.ax[i] = 0;
+        a.ay[i] = 0;
+    }
+
+    if (IsStaticBit(a.staticMask, i)) return;
+
+    a.vx[i] += accX * deltaTime;
+    a.vy[i] += accY * deltaTime;
+    a.x[i] += a.vx[i] * deltaTime;
+    a.y[i] += a.vy[i] * deltaTime;
+}
+
+template <bool WithAcceleration>
+void Integrate(const IntegrateArrays& a, size_t begin, size_t end, float deltaTime, const Vector2& gravity) {
+    size_t i = begin;
+
+#if defined(PHYSICS_WORLD_AVX)
+    // Scalar head until the index lines up with a byte of the static mask
+    for (; i < end && (i & 7) != 0; ++i) {
+        IntegrateOne<WithAcceleration>(a, i, deltaTime, gravity);
+    }
+
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 gx = _mm256_set1_ps(gravity.x);
+    const __m256 gy = _mm256_set1_ps(gravity.y);
+    const __m256 zero = _mm256_setzero_ps();
+
+    for (; i + 8 <= end; i += 8) {
+        uint32_t bits = (a.staticMask[i >> 5] >> (i & 31)) & 0xFF;
+        __m256 lanes = _mm256_insertf128_ps(
+            _mm256_castps128_ps256(_mm_load_ps(kDynamicLanes[bits & 15])),
+            _mm_load_ps(kDynamicLanes[bits >> 4]), 1);
+        __m256 step = _mm256_mul_ps(lanes, dt);
+
+        __m256 accX = gx;
+        __m256 accY = gy;
+        if (WithAcceleration) {
+            accX = _mm256_add_ps(accX, _mm256_loadu_ps(a.ax + i));
+            accY = _mm256_add_ps(accY, _mm256_loadu_ps(a.ay + i));
+            _mm256_storeu_ps(a.ax + i, zero);
+            _mm256_storeu_ps(a.ay + i, zero);
+        }
+
+        __m256 velX = _mm256_add_ps(_mm256_loadu_ps(a.vx + i), _mm256_mul_ps(accX, step));
+        __m256 velY = _mm256_add_ps(_mm256_loadu_ps(a.vy + i), _mm256_mul_ps(accY, step));
+        _mm256_storeu_ps(a.vx + i, velX);
+        _mm256_storeu_ps(a.vy + i, velY);
+        _mm256_storeu_ps(a.x + i, _mm256_add_ps(_mm256_loadu_ps(a.x + i), _mm256_mul_ps(velX, step)));
+        _mm256_storeu_ps(a.y + i, _mm256_add_ps(_mm256_loadu_ps(a.y + i), _mm256_mul_ps(velY, step)));
+    }
+#elif defined(PHYSICS_WORLD_SSE)
+    for (; i < end && (i & 3) != 0; ++i) {
+        IntegrateOne<WithAcceleration>(a, i, deltaTime, gravity);
+    }
+
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 gx = _mm_set1_ps(gravity.x);
+    const __m128 gy = _mm_set1_ps(gravity.y);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (; i + 4 <= end; i += 4) {
+        uint32_t bits = (a.staticMask[i >> 5] >> (i & 31)) & 0xF;
+        __m128 step = _mm_mul_ps(_mm_load_ps(kDynamicLanes[bits]), dt);
+
+        __m128 accX = gx;
+        __m128 accY = gy;
+        if (WithAcceleration) {
+            accX = _mm_add_ps(accX, _mm_loadu_ps(a.ax + i));
+            accY = _mm_add_ps(accY, _mm_loadu_ps(a.ay + i));
+            _mm_storeu_ps(a.ax + i, zero);
+            _mm_storeu_ps(a.ay + i, zero);
+        }
+
+        __m128 velX = _mm_add_ps(_mm_loadu_ps(a.vx + i), _mm_mul_ps(accX, step));
+        __m128 velY = _mm_add_ps(_mm_loadu_ps(a.vy + i), _mm_mul_ps(accY, step));
+        _mm_storeu_ps(a.vx + i, velX);
+        _mm_storeu_ps(a.vy + i, velY);
+        _mm_storeu_ps(a.x + i, _mm_add_ps(_mm_loadu_ps(a.x + i), _mm_mul_ps(velX, step)));
+        _mm_storeu_ps(a.y + i, _mm_add_ps(_mm_loadu_ps(a.y + i), _mm_mul_ps(velY, step)));
+    }
+#endif
+
+    // Scalar tail (or the whole range without SIMD)
+    for (; i < end; ++i) {
+        IntegrateOne<WithAcceleration>(a, i, deltaTime, gravity);
+    }
+}
+
+} // namespace
+
+PhysicsWorld::PhysicsWorld() : m_hasAcceleration(false) {
+}
+
+PhysicsWorld::BodyId PhysicsWorld::AddBody(const Physics::Body& body) {
+    size_t index = m_x.size();
+
+    m_x.push_back(body.position.x);
+    m_y.push_back(body.position.y);
+    m_vx.push_back(body.velocity.x);
+    m_vy.push_back(body.velocity.y);
+    m_ax.push_back(body.acceleration.x);
+    m_ay.push_back(body.acceleration.y);
+    m_mass.push_back(body.mass);
+    m_restitution.push_back(body.restitution);
+    if (body.acceleration.x != 0 || body.acceleration.y != 0) {
+        m_hasAcceleration = true;
+    }
+
+    if ((index >> 5) >= m_staticMask.size()) {
+        m_staticMask.push_back(0);
+    }
+    SetStaticBit(index, body.isStatic);
+
+    BodyId id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+        m_idToIndex[id] = (uint32_t)index;
+    } else {
+        id = (BodyId)m_idToIndex.size();
+        m_idToIndex.push_back((uint32_t)index);
+    }
+    m_indexToId.push_back(id);
+
+    return id;
+}
+
+void PhysicsWorld::RemoveBody(BodyId id) {
+    if (!IsValid(id)) return;
+
+    size_t index = m_idToIndex[id];
+    size_t last = m_x.size() - 1;
+
+    // Swap the last body into the hole
+    if (index != last) {
+        m_x[index] = m_x[last];
+        m_y[index] = m_y[last];
+        m_vx[index] = m_vx[last];
+        m_vy[index] = m_vy[last];
+        m_ax[index] = m_ax[last];
+        m_ay[index] = m_ay[last];
+        m_mass[index] = m_mass[last];
+        m_restitution[index] = m_restitution[last];
+        SetStaticBit(index, GetStaticBit(last));
+
+        BodyId movedId = m_indexToId[last];
+        m_indexToId[index] = movedId;
+        m_idToIndex[movedId] = (uint32_t)index;
+    }
+
+    m_x.pop_back();
+    m_y.pop_back();
+    m_vx.pop_back();
+    m_vy.pop_back();
+    m_ax.pop_back();
+    m_ay.pop_back();
+    m_mass.pop_back();
+    m_restitution.pop_back();
+    SetStaticBit(last, false);
+    m_staticMask.resize((m_x.size() + 31) >> 5);
+    m_indexToId.pop_back();
+
+    m_idToIndex[id] = InvalidBody;
+    m_freeIds.push_back(id);
+}
+
+bool PhysicsWorld::IsValid(BodyId id) const {
+    return id < m_idToIndex.size() && m_idToIndex[id] != InvalidBody;
+}
+
+void PhysicsWorld::Reserve(size_t count) {
+    m_x.reserve(count);
+    m_y.reserve(count);
+    m_vx.reserve(count);
+    m_vy.reserve(count);
+    m_ax.reserve(count);
+    m_ay.reserve(count);
+    m_mass.reserve(count);
+    m_restitution.reserve(count);
+    m_staticMask.reserve((count + 31) >> 5);
+    m_idToIndex.reserve(count);
+    m_indexToId.reserve(count);
+}
+
+void PhysicsWorld::Clear() {
+    m_x.clear();
+    m_y.clear();
+    m_vx.clear();
+    m_vy.clear();
+    m_ax.clear();
+    m_ay.clear();
+    m_mass.clear();
+    m_restitution.clear();
+    m_staticMask.clear();
+    m_idToIndex.clear();
+    m_indexToId.clear();
+    m_freeIds.clear();
+    m_hasAcceleration = false;
+}
+
+Physics::Body PhysicsWorld::GetBody(BodyId id) const {
+    size_t index = m_idToIndex[id];
+
+    Physics::Body body;
+    body.position = Vector2(m_x[index], m_y[index]);
+    body.velocity = Vector2(m_vx[index], m_vy[index]);
+    body.acceleration = Vector2(m_ax[index], m_ay[index]);
+    body.mass = m_mass[index];
+    body.restitution = m_restitution[index];
+    body.isStatic = GetStaticBit(index);
+    return body;
+}
+
+void PhysicsWorld::SetBody(BodyId id, const Physics::Body& body) {
+    size_t index = m_idToIndex[id];
+
+    m_x[index] = body.position.x;
+    m_y[index] = body.position.y;
+    m_vx[index] = body.velocity.x;
+    m_vy[index] = body.velocity.y;
+    m_ax[index] = body.acceleration.x;
+    m_ay[index] = body.acceleration.y;
+    m_mass[index] = body.mass;
+    m_restitution[index] = body.restitution;
+    SetStaticBit(index, body.isStatic);
+    if (body.acceleration.x != 0 || body.acceleration.y != 0) {
+        m_hasAcceleration = true;
+    }
+}
+
+Vector2 PhysicsWorld::GetPosition(BodyId id) const {
+    size_t index = m_idToIndex[id];
+    return Vector2(m_x[index], m_y[index]);
+}
+
+void PhysicsWorld::SetPosition(BodyId id, const Vector2& position) {
+    size_t index = m_idToIndex[id];
+    m_x[index] = position.x;
+    m_y[index] = position.y;
+}
+
+Vector2 PhysicsWorld::GetVelocity(BodyId id) const {
+    size_t index = m_idToIndex[id];
+    return Vector2(m_vx[index], m_vy[index]);
+}
+
+void PhysicsWorld::SetVelocity(BodyId id, const Vector2& velocity) {
+    size_t index = m_idToIndex[id];
+    m_vx[index] = velocity.x;
+    m_vy[index] = velocity.y;
+}
+
+void PhysicsWorld::ApplyAcceleration(BodyId id, const Vector2& acceleration) {
+    size_t index = m_idToIndex[id];
+    if (GetStaticBit(index)) return;
+
+    m_ax[index] += acceleration.x;
+    m_ay[index] += acceleration.y;
+    m_hasAcceleration = true;
+}
+
+bool PhysicsWorld::IsStatic(BodyId id) const {
+    return GetStaticBit(m_idToIndex[id]);
+}
+
+void PhysicsWorld::SetStatic(BodyId id, bool isStatic) {
+    SetStaticBit(m_idToIndex[id], isStatic);
+}
+
+void PhysicsWorld::Step(float deltaTime, const Vector2& gravity, JobSystem* jobs) {
+    // Blocks start on a static mask word so every block takes the SIMD path from its first body
+    const size_t blockSize = 16384;
+    size_t count = m_x.size();
+
+    if (jobs && jobs->GetThreadCount() > 1 && count > blockSize) {
+        size_t blocks = (count + blockSize - 1) / blockSize;
+        jobs->ParallelFor(blocks, 1, [&](size_t begin, size_t end) {
+            IntegrateRange(begin * blockSize, std::min(count, end * blockSize), deltaTime, gravity);
+        });
+    } else {
+        IntegrateRange(0, count, deltaTime, gravity);
+    }
+
+    m_hasAcceleration = false;
+}
+
+void PhysicsWorld::IntegrateRange(size_t begin, size_t end, float deltaTime, const Vector2& gravity) {
+    IntegrateArrays arrays = {
+        m_x.data(), m_y.data(), m_vx.data(), m_vy.data(),
+        m_ax.data(), m_ay.data(), m_staticMask.data()
+    };
+
+    // Gravity-only frames never touch the acceleration arrays
+    if (m_hasAcceleration) {
+        Integrate<true>(arrays, begin, end, deltaTime, gravity);
+    } else {
+        Integrate<false>(arrays, begin, end, deltaTime, gravity);
+    }
+}
+
+void PhysicsWorld::SetStaticBit(size_t index, bool isStatic) {
+    uint32_t bit = 1u << (index & 31);
+    if (isStatic) {
+        m_staticMask[index >> 5] |= bit;
+    } else {
+        m_staticMask[index >> 5] &= ~bit;
+    }
+}
+
+bool PhysicsWorld::GetStaticBit(size_t index) const {
+    return (m_staticMask[index >> 5] >> (index & 31)) & 1u;
+}
@@ -1,5 +1,13 @@
 #include "Renderer.h"
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <functional>
 #include <iostream>
+#ifdef HAVE_SDL3_IMAGE
+#include <SDL3_image/SDL_image.h>
+#endif
 
 // Texture Implementation
 Texture::Texture() : m_texture(nullptr), m_width(0), m_height(0) {
@@ -10,36 +18,128 @@ Texture::~Texture() {
 }
 
 bool Texture::LoadFromFile(SDL_Renderer* renderer, const std::string& path) {
+    SDL_Surface* surface = LoadSurface(path);
+    if (!surface) {
+        return false;
+    }
+    
+    bool loaded = LoadFromSurface(renderer, surface);
+    SDL_DestroySurface(surface);
+    return loaded;
+}
+
+bool Texture::LoadFromSurface(SDL_Renderer* renderer, SDL_Surface* surface) {
     Free();
     
-    // For now, create a simple colored texture instead of loading from file
-    // This is because SDL3_image is not available
-    m_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 32, 32);
+    m_texture = SDL_CreateTextureFromSurface(renderer, surface);
     if (!m_texture) {
         std::cerr << "Unable to create texture! SDL Error: " << SDL_GetError() << std::endl;
         return false;
     }
     
-    // Set as render target and fill with color
-    SDL_SetRenderTarget(renderer, m_texture);
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255); // White
-    SDL_RenderClear(renderer);
-    SDL_SetRenderTarget(renderer, nullptr);
+    m_width = surface->w;
+    m_height = surface->h;
+    return true;
+}
+
+void Texture::SetAtlasRegion(std::shared_ptr<AtlasRegion> region) {
+    Free();
     
-    m_width = 32;
-    m_height = 32;
+    m_region = region;
+    m_width = region->rect.w;
+    m_height = region->rect.h;
+}
+
+SDL_Surface* Texture::LoadSurface(const std::string& path) {
+    SDL_Surface* surface = nullptr;
     
-    std::cout << "Created placeholder texture for: " << path << std::endl;
-    return true;
+#ifdef HAVE_SDL3_IMAGE
+    surface = IMG_Load(path.c_str());
+#else
+    // Without SDL3_image only BMP files can be decoded
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == ".bmp") {
+        surface = SDL_LoadBMP(path.c_str());
+    }
+#endif
+    
+    return surface ? surface : CreatePlaceholderSurface(path);
+}
+
+SDL_Surface* Texture::LoadSurfaceFromMemory(const void* data, size_t size, const std::string& nameHint) {
+    SDL_Surface* surface = nullptr;
+    
+    SDL_IOStream* stream = SDL_IOFromConstMem(data, size);
+    if (stream) {
+#ifdef HAVE_SDL3_IMAGE
+        surface = IMG_Load_IO(stream, true);
+#else
+        std::string extension = std::filesystem::path(nameHint).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (extension == ".bmp") {
+            surface = SDL_LoadBMP_IO(stream, true);
+        } else {
+            SDL_CloseIO(stream);
+        }
+#endif
+    }
+    
+    return surface ? surface : CreatePlaceholderSurface(nameHint);
+}
+
+SDL_Surface* Texture::CreatePlaceholderSurface(const std::string& name) {
+    // White placeholder so missing art stays visible
+    SDL_Surface* surface = SDL_CreateSurface(32, 32, SDL_PIXELFORMAT_RGBA8888);
+    if (!surface) {
+        std::cerr << "Unable to create surface! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    SDL_FillSurfaceRect(surface, nullptr, SDL_MapSurfaceRGBA(surface, 255, 255, 255, 255));
+    
+    std::cout << "Created placeholder texture for: " << name << std::endl;
+    return surface;
 }
 
 void Texture::Free() {
     if (m_texture) {
         SDL_DestroyTexture(m_texture);
         m_texture = nullptr;
-        m_width = 0;
-        m_height = 0;
     }
+    m_region.reset();
+    m_width = 0;
+    m_height = 0;
+}
+
+SDL_Texture* Texture::GetSDLTexture() const {
+    return m_region ? m_region->page->texture : m_texture;
+}
+
+SDL_FRect Texture::GetUVs(const Rect* sourceRect) const {
+    float textureWidth = m_region ? (float)m_region->page->packer.GetWidth() : (float)m_width;
+    float textureHeight = m_region ? (float)m_region->page->packer.GetHeight() : (float)m_height;
+    if (textureWidth <= 0 || textureHeight <= 0) {
+        return { 0, 0, 0, 0 };
+    }
+    
+    SDL_Rect clip;
+    if (sourceRect) {
+        clip = { (int)sourceRect->x, (int)sourceRect->y, (int)sourceRect->width, (int)sourceRect->height };
+    }
+    
+    SDL_FRect src = GetSourceRect(sourceRect ? &clip : nullptr);
+    return { src.x / textureWidth, src.y / textureHeight, src.w / textureWidth, src.h / textureHeight };
+}
+
+SDL_FRect Texture::GetSourceRect(const SDL_Rect* clip) const {
+    // Clip rects are relative to this texture, not to its atlas page
+    float offsetX = m_region ? (float)m_region->rect.x : 0.0f;
+    float offsetY = m_region ? (float)m_region->rect.y : 0.0f;
+    
+    if (clip) {
+        return { offsetX + clip->x, offsetY + clip->y, (float)clip->w, (float)clip->h };
+    }
+    return { offsetX, offsetY, (float)m_width, (float)m_height };
 }
 
 void Texture::Render(SDL_Renderer* renderer, int x, int y, SDL_Rect* clip) {
@@ -50,31 +150,154 @@ void Texture::Render(SDL_Renderer* renderer, int x, int y, SDL_Rect* clip) {
         renderQuad.h = (float)clip->h;
     }
     
-    SDL_FRect* srcRect = nullptr;
-    SDL_FRect src;
-    if (clip) {
-        src = { (float)clip->x, (float)clip->y, (float)clip->w, (float)clip->h };
-        srcRect = &src;
-    }
-    
-    SDL_RenderTexture(renderer, m_texture, srcRect, &renderQuad);
+    SDL_FRect src = GetSourceRect(clip);
+    SDL_RenderTexture(renderer, GetSDLTexture(), &src, &renderQuad);
 }
 
 void Texture::Render(SDL_Renderer* renderer, const Rect& destRect, SDL_Rect* clip) {
     SDL_FRect renderQuad = { destRect.x, destRect.y, destRect.width, destRect.height };
     
-    SDL_FRect* srcRect = nullptr;
-    SDL_FRect src;
-    if (clip) {
-        src = { (float)clip->x, (float)clip->y, (float)clip->w, (float)clip->h };
-        srcRect = &src;
+    SDL_FRect src = GetSourceRect(clip);
+    SDL_RenderTexture(renderer, GetSDLTexture(), &src, &renderQuad);
+}
+
+// SpriteBatch Implementation
+SpriteBatch::SpriteBatch() : m_sortMode(SortMode::Depth) {
+    m_lastFlushStats.quads = 0;
+    m_lastFlushStats.drawCalls = 0;
+}
+
+void SpriteBatch::AddQuad(SDL_Texture* texture, const SDL_FRect& dest, const SDL_FRect& uvs, const Color& color, float depth) {
+    Quad quad;
+    quad.texture = texture;
+    quad.depth = depth;
+    quad.dest = dest;
+    quad.uvs = uvs;
+    quad.color = { color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f };
+    m_quads.push_back(quad);
+}
+
+void SpriteBatch::Flush(SDL_Renderer* renderer) {
+    m_lastFlushStats.quads = (int)m_quads.size();
+    m_lastFlushStats.drawCalls = 0;
+    if (m_quads.empty()) return;
+    
+    // Reordering by texture within a depth would change which of two
+    // overlapping sprites ends up on top, so Depth only merges runs that
+    // were already adjacent
+    std::less<SDL_Texture*> textureLess;
+    if (m_sortMode == SortMode::Depth) {
+        std::stable_sort(m_quads.begin(), m_quads.end(), [](const Quad& a, const Quad& b) {
+            return a.depth < b.depth;
+        });
+    } else {
+        std::stable_sort(m_quads.begin(), m_quads.end(), [&](const Quad& a, const Quad& b) {
+            if (a.texture != b.texture) return textureLess(a.texture, b.texture);
+            return a.depth < b.depth;
+        });
     }
     
-    SDL_RenderTexture(renderer, m_texture, srcRect, &renderQuad);
+    size_t quadCount = m_quads.size();
+    m_vertices.resize(quadCount * 4);
+    
+    // Same index pattern for every quad; runs index relative to their first vertex
+    if (m_indices.size() < quadCount * 6) {
+        size_t first = m_indices.size() / 6;
+        m_indices.resize(quadCount * 6);
+        for (size_t q = first; q < quadCount; ++q) {
+            int base = (int)q * 4;
+            int* index = &m_indices[q * 6];
+            index[0] = base;     index[1] = base + 1; index[2] = base + 2;
+            index[3] = base + 2; index[4] = base + 3; index[5] = base;
+        }
+    }
+    
+    for (size_t q = 0; q < quadCount; ++q) {
+        const Quad& quad = m_quads[q];
+        SDL_Vertex* v = &m_vertices[q * 4];
+        
+        float x0 = quad.dest.x, y0 = quad.dest.y;
+        float x1 = quad.dest.x + quad.dest.w, y1 = quad.dest.y + quad.dest.h;
+        float u0 = quad.uvs.x, v0 = quad.uvs.y;
+        float u1 = quad.uvs.x + quad.uvs.w, v1 = quad.uvs.y + quad.uvs.h;
+        
+        v[0] = { { x0, y0 }, quad.color, { u0, v0 } };
+        v[1] = { { x1, y0 }, quad.color, { u1, v0 } };
+        v[2] = { { x1, y1 }, quad.color, { u1, v1 } };
+        v[3] = { { x0, y1 }, quad.color, { u0, v1 } };
+    }
+    
+    size_t runStart = 0;
+    while (runStart < quadCount) {
+        SDL_Texture* texture = m_quads[runStart].texture;
+        size_t runEnd = runStart + 1;
+        while (runEnd < quadCount && m_quads[runEnd].texture == texture) {
+            runEnd++;
+        }
+        
+        int runQuads = (int)(runEnd - runStart);
+        SDL_RenderGeometry(renderer, texture, &m_vertices[runStart * 4], runQuads * 4,
+                           m_indices.data(), runQuads * 6);
+        m_lastFlushStats.drawCalls++;
+        runStart = runEnd;
+    }
+    
+    m_quads.clear();
+}
+
+void SpriteBatch::Clear() {
+    m_quads.clear();
+}
+
+// Camera Implementation
+Camera::Camera() : m_position(0, 0), m_zoom(1.0f), m_viewportWidth(0), m_viewportHeight(0) {
+}
+
+void Camera::SetCenter(const Vector2& center) {
+    m_position = Vector2(center.x - m_viewportWidth * 0.5f / m_zoom, center.y - m_viewportHeight * 0.5f / m_zoom);
+}
+
+Vector2 Camera::GetCenter() const {
+    return Vector2(m_position.x + m_viewportWidth * 0.5f / m_zoom, m_position.y + m_viewportHeight * 0.5f / m_zoom);
+}
+
+void Camera::SetZoom(float zoom) {
+    // Zoom about the centre of the view
+    Vector2 center = GetCenter();
+    m_zoom = std::max(zoom, 0.001f);
+    SetCenter(center);
+}
+
+void Camera::SetViewportSize(float width, float height) {
+    m_viewportWidth = width;
+    m_viewportHeight = height;
+}
+
+Rect Camera::GetViewRect() const {
+    return Rect(m_position.x, m_position.y, m_viewportWidth / m_zoom, m_viewportHeight / m_zoom);
+}
+
+bool Camera::IsVisible(const Rect& bounds) const {
+    Rect view = GetViewRect();
+    return bounds.x <= view.x + view.width && bounds.x + bounds.width >= view.x &&
+           bounds.y <= view.y + view.height && bounds.y + bounds.height >= view.y;
+}
+
+Vector2 Camera::WorldToScreen(const Vector2& point) const {
+    return (point - m_position) * m_zoom;
+}
+
+Vector2 Camera::ScreenToWorld(const Vector2& point) const {
+    return point * (1.0f / m_zoom) + m_position;
+}
+
+Rect Camera::WorldToScreen(const Rect& rect) const {
+    Vector2 topLeft = WorldToScreen(Vector2(rect.x, rect.y));
+    return Rect(topLeft.x, topLeft.y, rect.width * m_zoom, rect.height * m_zoom);
 }
 
 // Renderer Implementation
-Renderer::Renderer() : m_renderer(nullptr) {
+Renderer::Renderer() : m_renderer(nullptr), m_cameraEnabled(true), m_batching(false), m_drawDepth(0.0f) {
 }
 
 Renderer::~Renderer() {
@@ -91,19 +314,66 @@ bool Renderer::Initialize(SDL_Window* window) {
     }
     
     SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_BLEND);
+    
+    int width = 0, height = 0;
+    SDL_GetCurrentRenderOutputSize(m_renderer, &width, &height);
+    m_camera.SetViewportSize((float)width, (float)height);
     return true;
 }
 
 void Renderer::Clear(const Color& color) {
+    // Anything still queued would be cleared anyway
+    m_spriteBatch.Clear();
+    
+    // Follow window resizes
+    int width = 0, height = 0;
+    if (SDL_GetCurrentRenderOutputSize(m_renderer, &width, &height)) {
+        m_camera.SetViewportSize((float)width, (float)height);
+    }
+    
     SDL_SetRenderDrawColor(m_renderer, color.r, color.g, color.b, color.a);
     SDL_RenderClear(m_renderer);
 }
 
 void Renderer::Present() {
+    FlushBatch();
     SDL_RenderPresent(m_renderer);
 }
 
-void Renderer::DrawRect(const Rect& rect, const Color& color, bool filled) {
+void Renderer::SetBatchingEnabled(bool enabled) {
+    if (m_batching && !enabled) {
+        FlushBatch();
+    }
+    m_batching = enabled;
+}
+
+void Renderer::FlushBatch() {
+    m_spriteBatch.Flush(m_renderer);
+}
+
+void Renderer::DrawRect(const Rect& worldRect, const Color& color, bool filled) {
+    Rect rect = UsesCamera() ? m_camera.WorldToScreen(worldRect) : worldRect;
+    
+    if (m_batching) {
+        const SDL_FRect noUvs = { 0, 0, 0, 0 };
+        if (filled) {
+            SDL_FRect quad = { rect.x, rect.y, rect.width, rect.height };
+            m_spriteBatch.AddQuad(nullptr, quad, noUvs, color, m_drawDepth);
+        } else {
+            // One-pixel edges, matching SDL_RenderRect
+            SDL_FRect edges[4] = {
+                { rect.x, rect.y, rect.width, 1.0f },
+                { rect.x, rect.y + rect.height - 1.0f, rect.width, 1.0f },
+                { rect.x, rect.y + 1.0f, 1.0f, rect.height - 2.0f },
+                { rect.x + rect.width - 1.0f, rect.y + 1.0f, 1.0f, rect.height - 2.0f }
+            };
+            for (const SDL_FRect& edge : edges) {
+                m_spriteBatch.AddQuad(nullptr, edge, noUvs, color, m_drawDepth);
+            }
+        }
+        return;
+    }
+    
     SDL_SetRenderDrawColor(m_renderer, color.r, color.g, color.b, color.a);
     
     SDL_FRect sdlRect = { rect.x, rect.y, rect.width, rect.height };
@@ -118,6 +388,27 @@ void Renderer::DrawRect(const Rect& rect, const Color& color, bool filled) {
 void Renderer::DrawTexture(Texture* texture, const Vector2& position, const Rect* sourceRect) {
     if (!texture) return;
     
+    if (UsesCamera()) {
+        Rect destRect(position.x, position.y, (float)texture->GetWidth(), (float)texture->GetHeight());
+        if (sourceRect) {
+            destRect.width = (float)(int)sourceRect->width;
+            destRect.height = (float)(int)sourceRect->height;
+        }
+        DrawTexture(texture, destRect, sourceRect);
+        return;
+    }
+    
+    if (m_batching) {
+        SDL_FRect dest = { (float)(int)position.x, (float)(int)position.y,
+                           (float)texture->GetWidth(), (float)texture->GetHeight() };
+        if (sourceRect) {
+            dest.w = (float)(int)sourceRect->width;
+            dest.h = (float)(int)sourceRect->height;
+        }
+        BatchTexture(texture, dest, sourceRect);
+        return;
+    }
+    
     SDL_Rect* srcRect = nullptr;
     SDL_Rect src;
     if (sourceRect) {
@@ -128,9 +419,17 @@ void Renderer::DrawTexture(Texture* texture, const Vector2& position, const Rect
     texture->Render(m_renderer, (int)position.x, (int)position.y, srcRect);
 }
 
-void Renderer::DrawTexture(Texture* texture, const Rect& destRect, const Rect* sourceRect) {
+void Renderer::DrawTexture(Texture* texture, const Rect& worldRect, const Rect* sourceRect) {
     if (!texture) return;
     
+    Rect destRect = UsesCamera() ? m_camera.WorldToScreen(worldRect) : worldRect;
+    
+    if (m_batching) {
+        SDL_FRect dest = { destRect.x, destRect.y, destRect.width, destRect.height };
+        BatchTexture(texture, dest, sourceRect);
+        return;
+    }
+    
     SDL_Rect* srcRect = nullptr;
     SDL_Rect src;
     if (sourceRect) {
@@ -140,3 +439,9 @@ void Renderer::DrawTexture(Texture* texture, const Rect& destRect, const Rect* s
     
     texture->Render(m_renderer, destRect, srcRect);
 }
+
+void Renderer::BatchTexture(Texture* texture, const SDL_FRect& dest, const Rect* sourceRect) {
+    if (texture->GetWidth() <= 0 || texture->GetHeight() <= 0) return;
+    
+    m_spriteBatch.AddQuad(texture->GetSDLTexture(), dest, texture->GetUVs(sourceRect), Color(), m_drawDepth);
+}
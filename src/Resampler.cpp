@@ -0,0 +1,126 @@
+#include "Resampler.h"
+#include <algorithm>
+#include <cmath>
+
+static const double kPi = 3.14159265358979323846;
+// Kaiser window shape: ~80 dB stopband
+static const double kBeta = 8.0;
+// Cutoff as a fraction of the lower Nyquist; the rest is transition band
+static const double kPassband = 0.92;
+
+static int GreatestCommonDivisor(int a, int b) {
+    while (b != 0) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Zeroth-order modified Bessel function of the first kind
+static double BesselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+Resampler::Resampler(int inputRate, int outputRate) {
+    inputRate = std::max(inputRate, 1);
+    outputRate = std::max(outputRate, 1);
+    int divisor = GreatestCommonDivisor(inputRate, outputRate);
+    m_up = outputRate / divisor;
+    m_down = inputRate / divisor;
+    if (IsPassthrough()) {
+        m_taps = 0;
+        m_phases = 0;
+        return;
+    }
+
+    // In cycles per input frame
+    double scale = std::min(1.0, (double)m_up / m_down);
+    double cutoff = 0.5 * scale * kPassband;
+    m_taps = std::min(1024, (int)std::ceil(kTaps / scale / 2.0) * 2);
+    m_phases = std::min(m_up, kMaxPhases);
+
+    int half = m_taps / 2;
+    double window = BesselI0(kBeta);
+    m_filter.resize((size_t)(m_phases + 1) * m_taps);
+    for (int row = 0; row <= m_phases; ++row) {
+        double fraction = (double)row / m_phases;
+        float* coefficients = &m_filter[(size_t)row * m_taps];
+        double sum = 0.0;
+        for (int k = 0; k < m_taps; ++k) {
+            // Distance from the output frame to input frame k
+            double distance = k - half + 1 - fraction;
+            double x = distance / half;
+            double value = 0.0;
+            if (std::fabs(x) < 1.0) {
+                double arg = 2.0 * cutoff * distance;
+                double sinc = std::fabs(arg) < 1e-9 ? 1.0 : std::sin(kPi * arg) / (kPi * arg);
+                value = 2.0 * cutoff * sinc * BesselI0(kBeta * std::sqrt(1.0 - x * x)) / window;
+            }
+            coefficients[k] = (float)value;
+            sum += value;
+        }
+        // Unity gain at DC for every phase
+        for (int k = 0; k < m_taps; ++k) {
+            coefficients[k] = (float)(coefficients[k] / sum);
+        }
+    }
+}
+
+int Resampler::GetOutputFrames(int inputFrames) const {
+    return (int)(((int64_t)inputFrames * m_up + m_down - 1) / m_down);
+}
+
+void Resampler::Process(const float* input, int frames, int channels, std::vector<float>& output) const {
+    if (IsPassthrough()) {
+        output.assign(input, input + (size_t)frames * channels);
+        return;
+    }
+
+    int outputFrames = GetOutputFrames(frames);
+    output.assign((size_t)outputFrames * channels, 0.0f);
+    std::vector<float> blended(m_taps);
+    int half = m_taps / 2;
+
+    for (int n = 0; n < outputFrames; ++n) {
+        // Input position of this frame, in 1/m_up steps
+        int64_t time = (int64_t)n * m_down;
+        int index = (int)(time / m_up);
+        int phase = (int)(time % m_up);
+
+        const float* kernel;
+        if (m_phases == m_up) {
+            kernel = &m_filter[(size_t)phase * m_taps];
+        } else {
+            double position = (double)phase * m_phases / m_up;
+            int row = (int)position;
+            float fraction = (float)(position - row);
+            const float* a = &m_filter[(size_t)row * m_taps];
+            const float* b = a + m_taps;
+            for (int k = 0; k < m_taps; ++k) {
+                blended[k] = a[k] + (b[k] - a[k]) * fraction;
+            }
+            kernel = blended.data();
+        }
+
+        int first = index - half + 1;
+        int begin = std::max(0, -first);
+        int end = std::min(m_taps, frames - first);
+        float* out = &output[(size_t)n * channels];
+        for (int c = 0; c < channels; ++c) {
+            const float* source = input + (size_t)(first + begin) * channels + c;
+            float sum = 0.0f;
+            for (int k = begin; k < end; ++k) {
+                sum += source[(size_t)(k - begin) * channels] * kernel[k];
+            }
+            out[c] = sum;
+        }
+    }
+}
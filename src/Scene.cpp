@@ -1,50 +1,580 @@
 #include "Scene.h"
 #include "Engine.h"
+#include "JobSystem.h"
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+// Batch of the parallel update running on this thread, if any
+static thread_local const Scene* t_batchScene = nullptr;
+static thread_local size_t t_batchIndex = 0;
 
 // Scene Implementation
-Scene::Scene() : m_engine(nullptr) {
+Scene::Scene()
+    : m_updating(false)
+    , m_structureDirty(false)
+    , m_freeHead(0)
+    , m_containerGrowths(0)
+    , m_spawned(0)
+    , m_destroyed(0)
+    , m_parallelUpdate(false)
+    , m_parallelPhase(false)
+    , m_parallelBatchSize(512)
+    , m_jobSystem(nullptr)
+    , m_cullGrid(256.0f)
+    , m_cullingEnabled(true)
+    , m_cullingDirty(false)
+    , m_cullingMargin(64.0f)
+    , m_engine(nullptr)
+    , m_interpolationAlpha(1.0f)
+{
+    m_renderStats = { 0, 0, 0 };
 }
 
 Scene::~Scene() {
     Cleanup();
+    // Pooled objects have to go before their pools
+    DestroyAllObjects();
 }
 
 void Scene::Update(float deltaTime) {
-    for (auto& obj : m_gameObjects) {
-        if (obj && obj->active) {
-            obj->Update(deltaTime);
+    m_transforms.BeginFrame();
+    
+    // Spawns during the loop are buffered, so the size stays fixed
+    m_updating = true;
+    
+    JobSystem* jobs = m_parallelUpdate ? GetJobSystem() : nullptr;
+    if (jobs) {
+        UpdateParallel(jobs, deltaTime);
+        
+        for (size_t i = 0; i < m_gameObjects.size(); ++i) {
+            GameObject* obj = m_gameObjects[i];
+            if (!obj->threadSafe) {
+                UpdateObject(obj, deltaTime);
+            }
+        }
+    } else {
+        for (size_t i = 0; i < m_gameObjects.size(); ++i) {
+            UpdateObject(m_gameObjects[i], deltaTime);
         }
     }
+    m_updating = false;
+    
+    ApplyPendingChanges();
+    UpdateTransforms();
+    if (m_cullingEnabled) {
+        UpdateCulling();
+    }
     
-    // Remove inactive objects
-    m_gameObjects.erase(
-        std::remove_if(m_gameObjects.begin(), m_gameObjects.end(),
-            [](const std::shared_ptr<GameObject>& obj) { return !obj || !obj->active; }),
-        m_gameObjects.end()
-    );
+    if (m_world) {
+        m_world->RunSystems(deltaTime);
+    }
+}
+
+void Scene::UpdateObject(GameObject* obj, float deltaTime) {
+    if (obj->active) {
+        obj->previousPosition = obj->position;
+        obj->previousRotation = obj->rotation;
+        obj->Update(deltaTime);
+    }
+    
+    // Deactivated objects leave at the sync point
+    if (!obj->active) {
+        QueueRemoval(obj);
+    }
+}
+
+void Scene::UpdateParallel(JobSystem* jobs, float deltaTime) {
+    // Which thread runs a batch varies from run to run, so side effects are
+    // kept per batch and merged in object order
+    size_t batchCount = (m_gameObjects.size() + m_parallelBatchSize - 1) / m_parallelBatchSize;
+    if (m_batchCommands.size() < batchCount) {
+        m_batchCommands.resize(batchCount);
+    }
+    
+    m_parallelPhase = true;
+    jobs->ParallelFor(m_gameObjects.size(), m_parallelBatchSize, [this, deltaTime](size_t begin, size_t end) {
+        // A thread waiting inside an object's Update may run another batch
+        const Scene* outerScene = t_batchScene;
+        size_t outerIndex = t_batchIndex;
+        t_batchScene = this;
+        t_batchIndex = begin / m_parallelBatchSize;
+        
+        for (size_t i = begin; i < end; ++i) {
+            GameObject* obj = m_gameObjects[i];
+            if (!obj->threadSafe) continue;
+            
+            if (obj->active) {
+                obj->previousPosition = obj->position;
+                obj->previousRotation = obj->rotation;
+                obj->Update(deltaTime);
+            }
+            if (!obj->active) {
+                BatchCommand command;
+                command.type = BatchCommand::Type::Deactivate;
+                command.object = obj;
+                RecordCommand(std::move(command));
+            }
+        }
+        
+        t_batchScene = outerScene;
+        t_batchIndex = outerIndex;
+    });
+    m_parallelPhase = false;
+    
+    MergeBatchCommands();
+}
+
+void Scene::RecordCommand(BatchCommand command) {
+    // Calls from outside a batch (another thread poking the scene) land in
+    // the first one
+    size_t index = t_batchScene == this ? t_batchIndex : 0;
+    m_batchCommands[index].commands.push_back(std::move(command));
+}
+
+void Scene::MergeBatchCommands() {
+    // Batch order, then recording order within each batch: the order a
+    // serial update over the same objects would have applied them in
+    for (BatchCommands& batch : m_batchCommands) {
+        for (BatchCommand& command : batch.commands) {
+            switch (command.type) {
+            case BatchCommand::Type::Deactivate:
+                QueueRemoval(command.object);
+                break;
+            case BatchCommand::Type::Destroy:
+                Destroy(command.handle);
+                break;
+            case BatchCommand::Type::Add:
+                AddGameObject(std::move(command.added));
+                break;
+            case BatchCommand::Type::Deferred:
+                command.deferred();
+                break;
+            }
+        }
+        batch.commands.clear();
+    }
+}
+
+void Scene::SetParallelUpdate(bool enabled, size_t batchSize) {
+    m_parallelUpdate = enabled;
+    m_parallelBatchSize = batchSize > 0 ? batchSize : 1;
+}
+
+JobSystem* Scene::GetJobSystem() const {
+    if (m_jobSystem) return m_jobSystem;
+    return m_engine ? m_engine->GetJobSystem() : nullptr;
+}
+
+void Scene::Defer(std::function<void()> command) {
+    if (m_parallelPhase) {
+        BatchCommand deferred;
+        deferred.type = BatchCommand::Type::Deferred;
+        deferred.object = nullptr;
+        deferred.deferred = std::move(command);
+        RecordCommand(std::move(deferred));
+    } else {
+        command();
+    }
+}
+
+void Scene::UpdateTransforms() {
+    // Pick up local changes made through the plain fields; unchanged nodes
+    // stay clean and cost nothing in Update
+    for (size_t i = 0; i < m_transforms.GetNodeCount(); ++i) {
+        GameObject* obj = static_cast<GameObject*>(m_transforms.GetOwnerAt(i));
+        if (obj) {
+            m_transforms.SetLocalAt(i, obj->position, obj->rotation, obj->scale);
+        }
+    }
+    m_transforms.Update();
+}
+
+bool Scene::SetParent(GameObject* child, GameObject* parent, bool keepWorldTransform) {
+    if (child->m_scene != this || (parent && parent->m_scene != this)) {
+        std::cerr << "SetParent: both objects must belong to the same scene" << std::endl;
+        return false;
+    }
+    
+    if (m_parallelPhase) {
+        Defer([this, child, parent, keepWorldTransform]() {
+            if (child->m_scene == this && (!parent || parent->m_scene == this)) {
+                SetParent(child, parent, keepWorldTransform);
+            }
+        });
+        return true;
+    }
+    
+    if (!parent && child->m_transformId == kInvalidTransform) return true;
+    
+    TransformId parentId = parent ? GetOrCreateTransform(parent) : kInvalidTransform;
+    GetOrCreateTransform(child);
+    return ReparentTransform(child, parentId, keepWorldTransform);
+}
+
+bool Scene::ReparentTransform(GameObject* child, TransformId parent, bool keepWorldTransform) {
+    UpdateTransforms();
+    if (!m_transforms.SetParent(child->m_transformId, parent, keepWorldTransform)) {
+        return false;
+    }
+    
+    m_transforms.GetLocal(child->m_transformId, child->position, child->rotation, child->scale);
+    if (keepWorldTransform) {
+        child->ResetInterpolation();
+    }
+    m_transforms.Update();
+    return true;
+}
+
+TransformId Scene::GetOrCreateTransform(GameObject* obj) {
+    if (obj->m_transformId == kInvalidTransform) {
+        obj->m_transformId = m_transforms.Create(obj);
+        m_transforms.SetLocal(obj->m_transformId, obj->position, obj->rotation, obj->scale);
+    }
+    return obj->m_transformId;
+}
+
+void Scene::ReleaseTransform(GameObject* obj) {
+    // World matrices were brought up to date before the removals started,
+    // so the children detach without an update each
+    m_transforms.GetChildren(obj->m_transformId, m_childScratch);
+    m_transforms.DetachChildren(obj->m_transformId);
+    for (TransformId child : m_childScratch) {
+        GameObject* childObj = static_cast<GameObject*>(m_transforms.GetOwner(child));
+        m_transforms.GetLocal(child, childObj->position, childObj->rotation, childObj->scale);
+        childObj->ResetInterpolation();
+    }
+    
+    m_transforms.Destroy(obj->m_transformId);
+    obj->m_transformId = kInvalidTransform;
 }
 
 void Scene::Render(Renderer* renderer) {
-    for (auto& obj : m_gameObjects) {
-        if (obj && obj->active) {
+    m_interpolationAlpha = m_engine ? m_engine->GetInterpolationAlpha() : 1.0f;
+    
+    // Objects were added or removed since the last Update
+    if (m_cullingEnabled && m_cullingDirty) {
+        UpdateCulling();
+    }
+    
+    // Nothing has bounds: plain pass, no sorting
+    if (!m_cullingEnabled || !renderer || m_cullGrid.GetProxyCount() == 0) {
+        m_renderStats = { 0, 0, 0 };
+        for (GameObject* obj : m_gameObjects) {
+            if (obj->active) {
+                obj->Render(renderer);
+                m_renderStats.drawn++;
+            }
+        }
+        return;
+    }
+    
+    Rect view = renderer->GetCamera().GetViewRect();
+    Physics::AABB query;
+    query.min = Vector2(view.x - m_cullingMargin, view.y - m_cullingMargin);
+    query.max = Vector2(view.x + view.width + m_cullingMargin, view.y + view.height + m_cullingMargin);
+    
+    m_visibleProxies.clear();
+    m_renderStats.cellsVisited = m_cullGrid.Query(query, m_visibleProxies);
+    
+    m_visibleObjects.clear();
+    for (int proxy : m_visibleProxies) {
+        m_visibleObjects.push_back(m_cullProxyObjects[proxy]);
+    }
+    
+    // Back to scene order so overlapping objects layer as before;
+    // m_alwaysVisible is already in that order
+    auto sceneOrder = [](GameObject* a, GameObject* b) { return a->m_sceneIndex < b->m_sceneIndex; };
+    std::sort(m_visibleObjects.begin(), m_visibleObjects.end(), sceneOrder);
+    size_t boundedCount = m_visibleObjects.size();
+    m_visibleObjects.insert(m_visibleObjects.end(), m_alwaysVisible.begin(), m_alwaysVisible.end());
+    std::inplace_merge(m_visibleObjects.begin(), m_visibleObjects.begin() + boundedCount,
+                       m_visibleObjects.end(), sceneOrder);
+    
+    m_renderStats.drawn = 0;
+    for (GameObject* obj : m_visibleObjects) {
+        if (obj->active) {
             obj->Render(renderer);
+            m_renderStats.drawn++;
         }
     }
+    m_renderStats.culled = m_cullGrid.GetProxyCount() - (int)m_visibleProxies.size();
 }
 
-void Scene::AddGameObject(std::shared_ptr<GameObject> obj) {
-    if (obj) {
-        obj->m_scene = this;
-        m_gameObjects.push_back(obj);
+void Scene::SetCullingEnabled(bool enabled) {
+    if (m_cullingEnabled == enabled) return;
+    
+    m_cullingEnabled = enabled;
+    if (enabled) {
+        m_cullingDirty = true;
+    } else {
+        for (GameObject* obj : m_gameObjects) {
+            obj->m_cullProxy = -1;
+        }
+        m_cullGrid.Clear();
+        m_cullProxyObjects.clear();
+        m_alwaysVisible.clear();
+    }
+}
+
+void Scene::UpdateCulling() {
+    m_alwaysVisible.clear();
+    
+    for (GameObject* obj : m_gameObjects) {
+        if (!obj->active || obj->size.x <= 0.0f || obj->size.y <= 0.0f) {
+            RemoveCullProxy(obj);
+            if (obj->active) {
+                m_alwaysVisible.push_back(obj);
+            }
+            continue;
+        }
+        
+        Rect bounds = obj->GetBounds();
+        Physics::AABB aabb;
+        aabb.min = Vector2(bounds.x, bounds.y);
+        aabb.max = Vector2(bounds.x + bounds.width, bounds.y + bounds.height);
+        
+        if (obj->m_cullProxy < 0) {
+            obj->m_cullProxy = m_cullGrid.AddProxy(aabb);
+            if ((size_t)obj->m_cullProxy >= m_cullProxyObjects.size()) {
+                m_cullProxyObjects.resize(obj->m_cullProxy + 1, nullptr);
+            }
+            m_cullProxyObjects[obj->m_cullProxy] = obj;
+        } else {
+            // Only re-inserted when the bounds cross a cell boundary
+            m_cullGrid.MoveProxy(obj->m_cullProxy, aabb);
+        }
+    }
+    m_cullingDirty = false;
+}
+
+void Scene::RemoveCullProxy(GameObject* obj) {
+    if (obj->m_cullProxy < 0) return;
+    
+    m_cullGrid.RemoveProxy(obj->m_cullProxy);
+    m_cullProxyObjects[obj->m_cullProxy] = nullptr;
+    obj->m_cullProxy = -1;
+}
+
+void Scene::Destroy(GameObjectHandle handle) {
+    if (m_parallelPhase) {
+        BatchCommand command;
+        command.type = BatchCommand::Type::Destroy;
+        command.object = nullptr;
+        command.handle = handle;
+        RecordCommand(std::move(command));
+        return;
+    }
+    
+    GameObject* obj = Get(handle);
+    if (!obj) return;
+    
+    obj->active = false;
+    obj->m_scene = nullptr;
+    QueueRemoval(obj);
+    
+    if (!m_updating) {
+        ApplyPendingChanges();
     }
 }
 
+GameObject* Scene::Get(GameObjectHandle handle) const {
+    if (handle.IsNull() || handle.GetIndex() >= m_slots.size()) return nullptr;
+    
+    const ObjectSlot& slot = m_slots[handle.GetIndex()];
+    return slot.generation == handle.GetGeneration() ? slot.object : nullptr;
+}
+
+GameObjectHandle Scene::AddGameObject(std::shared_ptr<GameObject> obj) {
+    if (!obj) return GameObjectHandle();
+    
+    if (m_parallelPhase) {
+        BatchCommand command;
+        command.type = BatchCommand::Type::Add;
+        command.object = nullptr;
+        command.added = std::move(obj);
+        RecordCommand(std::move(command));
+        return GameObjectHandle();
+    }
+    
+    // Already here
+    if (Get(obj->m_handle) == obj.get()) return obj->m_handle;
+    
+    GameObject* raw = obj.get();
+    return Register(raw, nullptr, nullptr, std::move(obj));
+}
+
 void Scene::RemoveGameObject(std::shared_ptr<GameObject> obj) {
     if (obj) {
-        obj->active = false;
-        obj->m_scene = nullptr;
+        Destroy(obj->m_handle);
+    }
+}
+
+void Scene::ApplyPendingChanges() {
+    if (!m_pendingAdds.empty() || m_structureDirty) {
+        m_cullingDirty = m_cullingEnabled;
+    }
+    
+    for (GameObject* obj : m_pendingAdds) {
+        obj->m_sceneIndex = m_gameObjects.size();
+        PushTracked(m_gameObjects, obj);
+    }
+    m_pendingAdds.clear();
+    
+    // Nothing removed: no pass over the object list at all
+    if (!m_structureDirty) return;
+    
+    SyncTransformsForRemoval(m_pendingRemovals);
+    for (GameObject* obj : m_pendingRemovals) {
+        // Swap-and-pop: order isn't preserved
+        size_t index = obj->m_sceneIndex;
+        if (index != m_gameObjects.size() - 1) {
+            m_gameObjects[index] = m_gameObjects.back();
+            m_gameObjects[index]->m_sceneIndex = index;
+        }
+        m_gameObjects.pop_back();
+        
+        ReleaseSlot(obj->m_handle.GetIndex());
+    }
+    m_pendingRemovals.clear();
+    m_structureDirty = false;
+}
+
+Scene::AllocationStats Scene::GetAllocationStats() const {
+    AllocationStats stats;
+    stats.poolSlabAllocations = 0;
+    for (const auto& pool : m_pools) {
+        stats.poolSlabAllocations += pool.second->GetSlabAllocations();
+    }
+    stats.containerGrowths = m_containerGrowths;
+    stats.spawned = m_spawned;
+    stats.destroyed = m_destroyed;
+    stats.liveObjects = m_gameObjects.size() + m_pendingAdds.size();
+    return stats;
+}
+
+GameObjectHandle Scene::Register(GameObject* obj, ObjectPoolBase* pool, PoolDestroyFunction destroy,
+                                 std::shared_ptr<GameObject> shared) {
+    uint32_t index;
+    size_t freeCount = m_freeSlots.size() - m_freeHead;
+    bool full = m_slots.size() >= GameObjectHandle::kIndexMask;
+    if (freeCount > kMinFreeSlots || (full && freeCount > 0)) {
+        index = m_freeSlots[m_freeHead++];
+        // Shift out the taken half; the capacity stays, so churn doesn't allocate
+        if (m_freeHead * 2 >= m_freeSlots.size()) {
+            m_freeSlots.erase(m_freeSlots.begin(), m_freeSlots.begin() + m_freeHead);
+            m_freeHead = 0;
+        }
+    } else if (!full) {
+        index = (uint32_t)m_slots.size();
+        PushTracked(m_slots, ObjectSlot{ nullptr, 0, nullptr, nullptr, nullptr });
+    } else {
+        std::cerr << "Scene is full, cannot add more than " << GameObjectHandle::kIndexMask << " objects" << std::endl;
+        if (pool) {
+            destroy(pool, obj);
+        }
+        return GameObjectHandle();
+    }
+    
+    ObjectSlot& slot = m_slots[index];
+    slot.object = obj;
+    slot.pool = pool;
+    slot.destroy = destroy;
+    slot.shared = std::move(shared);
+    
+    obj->m_handle = GameObjectHandle(index, slot.generation);
+    obj->m_scene = this;
+    obj->ResetInterpolation();
+    PushTracked(m_pendingAdds, obj);
+    m_spawned++;
+    
+    if (!m_updating) {
+        ApplyPendingChanges();
+    }
+    return obj->m_handle;
+}
+
+void Scene::ReleaseSlot(uint32_t index) {
+    ObjectSlot& slot = m_slots[index];
+    GameObject* obj = slot.object;
+    
+    if (obj->m_transformId != kInvalidTransform) {
+        ReleaseTransform(obj);
+    }
+    RemoveCullProxy(obj);
+    
+    obj->m_handle = GameObjectHandle();
+    obj->m_sceneIndex = SIZE_MAX;
+    obj->m_pendingRemoval = false;
+    
+    slot.object = nullptr;
+    slot.generation = (slot.generation + 1) & GameObjectHandle::kGenerationMask;
+    if (slot.pool) {
+        slot.destroy(slot.pool, obj);
+    }
+    slot.pool = nullptr;
+    slot.destroy = nullptr;
+    slot.shared.reset();
+    
+    // Back at generation 0, handles from the slot's first use would match
+    // again; a retired slot costs its few bytes and is never reused
+    if (slot.generation != 0) {
+        PushTracked(m_freeSlots, index);
+    }
+    m_destroyed++;
+}
+
+void Scene::SyncTransformsForRemoval(const std::vector<GameObject*>& removed) {
+    // Children of removed objects keep their world transform, which needs
+    // current world matrices; one sync covers every removal in the batch
+    for (GameObject* obj : removed) {
+        if (obj->m_transformId != kInvalidTransform && m_transforms.HasChildren(obj->m_transformId)) {
+            UpdateTransforms();
+            return;
+        }
+    }
+}
+
+void Scene::QueueRemoval(GameObject* obj) {
+    if (obj->m_pendingRemoval) return;
+    
+    obj->m_pendingRemoval = true;
+    PushTracked(m_pendingRemovals, obj);
+    m_structureDirty = true;
+}
+
+void Scene::DestroyAllObjects() {
+    ApplyPendingChanges();
+    
+    SyncTransformsForRemoval(m_gameObjects);
+    for (uint32_t i = 0; i < (uint32_t)m_slots.size(); ++i) {
+        if (m_slots[i].object) {
+            ReleaseSlot(i);
+        }
+    }
+    m_gameObjects.clear();
+}
+
+World& Scene::GetWorld() {
+    if (!m_world) {
+        m_world = std::make_unique<World>();
+        m_world->SetJobSystem(m_engine ? m_engine->GetJobSystem() : nullptr);
     }
+    return *m_world;
+}
+
+Entity Scene::MigrateToWorld(GameObjectHandle handle) {
+    GameObject* obj = Get(handle);
+    if (!obj) return Entity();
+    
+    Entity entity = GetWorld().CreateEntity(obj->GetTransform());
+    Destroy(handle);
+    return entity;
+}
+
+Entity Scene::MigrateToWorld(std::shared_ptr<GameObject> obj) {
+    return obj ? MigrateToWorld(obj->m_handle) : Entity();
 }
 
 // GameObject Implementation
@@ -53,10 +583,127 @@ GameObject::GameObject()
     , velocity(0, 0)
     , rotation(0)
     , scale(1, 1)
+    , size(0, 0)
     , active(true)
+    , threadSafe(false)
+    , previousPosition(0, 0)
+    , previousRotation(0)
     , m_scene(nullptr)
+    , m_transformId(kInvalidTransform)
+    , m_cullProxy(-1)
+    , m_sceneIndex(SIZE_MAX)
+    , m_pendingRemoval(false)
 {
 }
 
 GameObject::~GameObject() {
 }
+
+Vector2 GameObject::GetRenderPosition() const {
+    float alpha = m_scene ? m_scene->GetInterpolationAlpha() : 1.0f;
+    if (m_scene && m_transformId != kInvalidTransform) {
+        TransformHierarchy& transforms = m_scene->GetTransformHierarchy();
+        Vector2 previous = transforms.GetPreviousWorldMatrix(m_transformId).GetPosition();
+        Vector2 current = transforms.GetWorldMatrix(m_transformId).GetPosition();
+        return previous + (current - previous) * alpha;
+    }
+    return previousPosition + (position - previousPosition) * alpha;
+}
+
+float GameObject::GetRenderRotation() const {
+    float alpha = m_scene ? m_scene->GetInterpolationAlpha() : 1.0f;
+    if (m_scene && m_transformId != kInvalidTransform) {
+        TransformHierarchy& transforms = m_scene->GetTransformHierarchy();
+        float previous = transforms.GetPreviousWorldMatrix(m_transformId).GetRotation();
+        float current = transforms.GetWorldMatrix(m_transformId).GetRotation();
+        // World rotations wrap at +-180, blend the short way round
+        float delta = std::remainder(current - previous, 360.0f);
+        return previous + delta * alpha;
+    }
+    return previousRotation + (rotation - previousRotation) * alpha;
+}
+
+void GameObject::ResetInterpolation() {
+    previousPosition = position;
+    previousRotation = rotation;
+    if (m_scene && m_transformId != kInvalidTransform) {
+        m_scene->GetTransformHierarchy().ResetInterpolation(m_transformId);
+    }
+}
+
+bool GameObject::SetParent(GameObject* parent, bool keepWorldTransform) {
+    if (!m_scene) {
+        std::cerr << "SetParent: object is not in a scene" << std::endl;
+        return false;
+    }
+    return m_scene->SetParent(this, parent, keepWorldTransform);
+}
+
+GameObject* GameObject::GetParent() const {
+    if (!m_scene || m_transformId == kInvalidTransform) return nullptr;
+    
+    TransformHierarchy& transforms = m_scene->GetTransformHierarchy();
+    return static_cast<GameObject*>(transforms.GetOwner(transforms.GetParent(m_transformId)));
+}
+
+Matrix2D GameObject::GetWorldMatrix() const {
+    if (m_scene && m_transformId != kInvalidTransform) {
+        return m_scene->GetTransformHierarchy().GetWorldMatrix(m_transformId);
+    }
+    return Matrix2D::FromTransform(position, rotation, scale);
+}
+
+Vector2 GameObject::GetWorldPosition() const {
+    return GetWorldMatrix().GetPosition();
+}
+
+float GameObject::GetWorldRotation() const {
+    if (m_scene && m_transformId != kInvalidTransform) {
+        return GetWorldMatrix().GetRotation();
+    }
+    return rotation;
+}
+
+Rect GameObject::GetBounds() const {
+    // Common case: unrotated, unparented
+    if (rotation == 0.0f && (!m_scene || m_transformId == kInvalidTransform)) {
+        float width = size.x * scale.x;
+        float height = size.y * scale.y;
+        return Rect(std::min(position.x, position.x + width), std::min(position.y, position.y + height),
+                    std::fabs(width), std::fabs(height));
+    }
+    
+    Matrix2D world = GetWorldMatrix();
+    Vector2 corners[4] = {
+        world.TransformPoint(Vector2(0, 0)),
+        world.TransformPoint(Vector2(size.x, 0)),
+        world.TransformPoint(Vector2(0, size.y)),
+        world.TransformPoint(size)
+    };
+    
+    Vector2 min = corners[0];
+    Vector2 max = corners[0];
+    for (int i = 1; i < 4; ++i) {
+        min.x = std::min(min.x, corners[i].x);
+        min.y = std::min(min.y, corners[i].y);
+        max.x = std::max(max.x, corners[i].x);
+        max.y = std::max(max.y, corners[i].y);
+    }
+    return Rect(min.x, min.y, max.x - min.x, max.y - min.y);
+}
+
+TransformComponent GameObject::GetTransform() const {
+    TransformComponent transform;
+    transform.position = position;
+    transform.velocity = velocity;
+    transform.rotation = rotation;
+    transform.scale = scale;
+    return transform;
+}
+
+void GameObject::SetTransform(const TransformComponent& transform) {
+    position = transform.position;
+    velocity = transform.velocity;
+    rotation = transform.rotation;
+    scale = transform.scale;
+}
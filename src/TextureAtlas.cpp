@@ -0,0 +1,394 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <iostream>
+
+// Draws source (or sourceRect of it) onto target without blending, restoring the previous render target
+static void CopyToTarget(SDL_Renderer* renderer, SDL_Texture* source, const SDL_FRect* sourceRect,
+                         SDL_Texture* target, const SDL_FRect& destRect) {
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_BlendMode previousBlend = SDL_BLENDMODE_BLEND;
+    SDL_GetTextureBlendMode(source, &previousBlend);
+
+    SDL_SetTextureBlendMode(source, SDL_BLENDMODE_NONE);
+    SDL_SetRenderTarget(renderer, target);
+    SDL_RenderTexture(renderer, source, sourceRect, &destRect);
+    SDL_SetRenderTarget(renderer, previousTarget);
+    SDL_SetTextureBlendMode(source, previousBlend);
+}
+
+// SkylinePacker Implementation
+SkylinePacker::SkylinePacker(int width, int height) : m_width(width), m_height(height) {
+    m_skyline.push_back({ 0, 0, width });
+}
+
+bool SkylinePacker::Insert(int width, int height, int& outX, int& outY) {
+    size_t bestIndex = m_skyline.size();
+    int bestTop = m_height + 1;
+    int bestX = 0;
+    int bestY = 0;
+
+    // Bottom-left: lowest resulting top edge, then leftmost
+    for (size_t i = 0; i < m_skyline.size(); ++i) {
+        int y;
+        if (Fits(i, width, height, y) && y + height < bestTop) {
+            bestIndex = i;
+            bestTop = y + height;
+            bestX = m_skyline[i].x;
+            bestY = y;
+        }
+    }
+
+    if (bestIndex == m_skyline.size()) return false;
+
+    Node node = { bestX, bestY + height, width };
+    m_skyline.insert(m_skyline.begin() + bestIndex, node);
+
+    // Trim the segments now covered by the new node
+    for (size_t i = bestIndex + 1; i < m_skyline.size();) {
+        const Node& previous = m_skyline[i - 1];
+        Node& current = m_skyline[i];
+        int overlap = previous.x + previous.width - current.x;
+        if (overlap <= 0) break;
+
+        current.x += overlap;
+        current.width -= overlap;
+        if (current.width > 0) break;
+        m_skyline.erase(m_skyline.begin() + i);
+    }
+
+    // Merge neighbours at the same height
+    for (size_t i = 0; i + 1 < m_skyline.size();) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+
+    outX = bestX;
+    outY = bestY;
+    return true;
+}
+
+void SkylinePacker::Grow(int newWidth, int newHeight) {
+    if (newWidth > m_width) {
+        // The new strip on the right is empty all the way down
+        if (m_skyline.back().y == 0) {
+            m_skyline.back().width += newWidth - m_width;
+        } else {
+            m_skyline.push_back({ m_width, 0, newWidth - m_width });
+        }
+        m_width = newWidth;
+    }
+    if (newHeight > m_height) {
+        m_height = newHeight;
+    }
+}
+
+bool SkylinePacker::Fits(size_t index, int width, int height, int& outY) const {
+    int x = m_skyline[index].x;
+    if (x + width > m_width) return false;
+
+    int y = m_skyline[index].y;
+    int remaining = width;
+    for (size_t i = index; remaining > 0 && i < m_skyline.size(); ++i) {
+        y = std::max(y, m_skyline[i].y);
+        if (y + height > m_height) return false;
+        remaining -= m_skyline[i].width;
+    }
+
+    outY = y;
+    return true;
+}
+
+// AtlasPage Implementation
+AtlasPage::AtlasPage(SDL_Texture* texture, int width, int height)
+    : texture(texture)
+    , packer(width, height)
+    , usedPixels(0)
+    , textureCount(0)
+{
+}
+
+AtlasPage::~AtlasPage() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+    }
+}
+
+// AtlasRegion Implementation
+AtlasRegion::~AtlasRegion() {
+    if (!page) return;
+
+    // The packer keeps the space until the page is released or repacked
+    page->regions.erase(std::find(page->regions.begin(), page->regions.end(), this));
+    page->usedPixels -= (long long)rect.w * rect.h;
+    page->textureCount--;
+}
+
+// TextureAtlas Implementation
+TextureAtlas::TextureAtlas(int initialPageSize, int maxPageSize, int padding)
+    : m_initialPageSize(initialPageSize)
+    , m_maxPageSize(std::max(initialPageSize, maxPageSize))
+    , m_padding(padding)
+{
+}
+
+std::shared_ptr<AtlasRegion> TextureAtlas::Add(SDL_Renderer* renderer, SDL_Surface* surface) {
+    if (!renderer || !surface) return nullptr;
+
+    int width = surface->w + m_padding;
+    int height = surface->h + m_padding;
+    if (width > m_maxPageSize || height > m_maxPageSize) return nullptr;
+
+    std::shared_ptr<AtlasPage> page;
+    int x = 0, y = 0;
+
+    // Holes in any existing page first; a page nothing uses any more starts over
+    for (auto& candidate : m_pages) {
+        if (candidate->regions.empty()) {
+            candidate->packer = SkylinePacker(candidate->packer.GetWidth(), candidate->packer.GetHeight());
+        }
+        if (candidate->packer.Insert(width, height, x, y)) {
+            page = candidate;
+            break;
+        }
+    }
+
+    // Then grow the newest page
+    if (!page && !m_pages.empty()) {
+        AtlasPage& last = *m_pages.back();
+        while (GrowPage(renderer, last)) {
+            if (last.packer.Insert(width, height, x, y)) {
+                page = m_pages.back();
+                break;
+            }
+        }
+    }
+
+    if (!page) {
+        int size = InitialPageSize(width, height);
+        page = CreatePage(renderer, size, size);
+        if (!page || !page->packer.Insert(width, height, x, y)) {
+            return nullptr;
+        }
+        m_pages.push_back(page);
+    }
+
+    SDL_Texture* upload = SDL_CreateTextureFromSurface(renderer, surface);
+    if (!upload) {
+        std::cerr << "Unable to upload atlas sprite! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    SDL_FRect dest = { (float)x, (float)y, (float)surface->w, (float)surface->h };
+    CopyToTarget(renderer, upload, nullptr, page->texture, dest);
+    SDL_DestroyTexture(upload);
+
+    auto region = std::make_shared<AtlasRegion>();
+    region->page = page;
+    region->rect = { x, y, surface->w, surface->h };
+    page->regions.push_back(region.get());
+    page->usedPixels += (long long)surface->w * surface->h;
+    page->textureCount++;
+    return region;
+}
+
+void TextureAtlas::Clear() {
+    m_pages.clear();
+}
+
+long long TextureAtlas::ReleaseEmptyPages() {
+    long long freed = 0;
+    for (auto it = m_pages.begin(); it != m_pages.end();) {
+        if ((*it)->regions.empty()) {
+            freed += (long long)(*it)->packer.GetWidth() * (*it)->packer.GetHeight();
+            it = m_pages.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return freed;
+}
+
+long long TextureAtlas::Repack(SDL_Renderer* renderer) {
+    long long freed = ReleaseEmptyPages();
+    if (!renderer || m_pages.empty()) return freed;
+
+    // Tallest first keeps the skyline flat
+    std::vector<AtlasRegion*> regions;
+    for (const auto& page : m_pages) {
+        regions.insert(regions.end(), page->regions.begin(), page->regions.end());
+    }
+    std::stable_sort(regions.begin(), regions.end(), [](const AtlasRegion* a, const AtlasRegion* b) {
+        return a->rect.h != b->rect.h ? a->rect.h > b->rect.h : a->rect.w > b->rect.w;
+    });
+
+    // Planned on the packers alone, so the pages are only rebuilt if it pays off
+    struct Placement {
+        size_t page;
+        int x, y;
+    };
+    std::vector<SkylinePacker> plan;
+    std::vector<Placement> placements(regions.size());
+    for (size_t i = 0; i < regions.size(); ++i) {
+        int width = regions[i]->rect.w + m_padding;
+        int height = regions[i]->rect.h + m_padding;
+        Placement& placement = placements[i];
+        bool placed = false;
+        for (size_t p = 0; p < plan.size() && !placed; ++p) {
+            placed = plan[p].Insert(width, height, placement.x, placement.y);
+            placement.page = p;
+        }
+        if (!placed && !plan.empty()) {
+            int pageWidth = plan.back().GetWidth();
+            int pageHeight = plan.back().GetHeight();
+            while (!placed && NextPageSize(pageWidth, pageHeight)) {
+                plan.back().Grow(pageWidth, pageHeight);
+                placed = plan.back().Insert(width, height, placement.x, placement.y);
+            }
+            placement.page = plan.size() - 1;
+        }
+        if (!placed) {
+            int size = InitialPageSize(width, height);
+            plan.emplace_back(size, size);
+            plan.back().Insert(width, height, placement.x, placement.y);
+            placement.page = plan.size() - 1;
+        }
+    }
+
+    long long plannedPixels = 0;
+    for (const SkylinePacker& packer : plan) {
+        plannedPixels += (long long)packer.GetWidth() * packer.GetHeight();
+    }
+    long long currentPixels = GetTotalPixels();
+    if (plannedPixels >= currentPixels) return freed;
+
+    std::vector<std::shared_ptr<AtlasPage>> pages;
+    for (const SkylinePacker& packer : plan) {
+        std::shared_ptr<AtlasPage> page = CreatePage(renderer, packer.GetWidth(), packer.GetHeight());
+        if (!page) return freed;
+        page->packer = packer;
+        pages.push_back(page);
+    }
+
+    for (size_t i = 0; i < regions.size(); ++i) {
+        AtlasRegion& region = *regions[i];
+        AtlasPage& page = *pages[placements[i].page];
+        SDL_FRect source = { (float)region.rect.x, (float)region.rect.y, (float)region.rect.w, (float)region.rect.h };
+        SDL_FRect dest = { (float)placements[i].x, (float)placements[i].y, (float)region.rect.w, (float)region.rect.h };
+        CopyToTarget(renderer, region.page->texture, &source, page.texture, dest);
+
+        region.page->regions.clear();
+        region.page = pages[placements[i].page];
+        region.rect.x = placements[i].x;
+        region.rect.y = placements[i].y;
+        page.regions.push_back(&region);
+        page.usedPixels += (long long)region.rect.w * region.rect.h;
+        page.textureCount++;
+    }
+
+    // The old pages go with the last reference, here
+    m_pages.swap(pages);
+    return freed + currentPixels - plannedPixels;
+}
+
+TextureAtlas::Stats TextureAtlas::GetStats() const {
+    Stats stats;
+    stats.pageCount = (int)m_pages.size();
+    stats.textureCount = 0;
+    stats.usedPixels = 0;
+    stats.totalPixels = 0;
+
+    for (const auto& page : m_pages) {
+        PageStats pageStats;
+        pageStats.width = page->packer.GetWidth();
+        pageStats.height = page->packer.GetHeight();
+        pageStats.textureCount = page->textureCount;
+        pageStats.usedPixels = page->usedPixels;
+
+        long long area = (long long)pageStats.width * pageStats.height;
+        pageStats.occupancy = area > 0 ? (float)((double)page->usedPixels / area) : 0.0f;
+
+        stats.textureCount += page->textureCount;
+        stats.usedPixels += page->usedPixels;
+        stats.totalPixels += area;
+        stats.pages.push_back(pageStats);
+    }
+
+    stats.occupancy = stats.totalPixels > 0 ? (float)((double)stats.usedPixels / stats.totalPixels) : 0.0f;
+    return stats;
+}
+
+long long TextureAtlas::GetUsedPixels() const {
+    long long used = 0;
+    for (const auto& page : m_pages) {
+        used += page->usedPixels;
+    }
+    return used;
+}
+
+long long TextureAtlas::GetTotalPixels() const {
+    long long total = 0;
+    for (const auto& page : m_pages) {
+        total += (long long)page->packer.GetWidth() * page->packer.GetHeight();
+    }
+    return total;
+}
+
+std::shared_ptr<AtlasPage> TextureAtlas::CreatePage(SDL_Renderer* renderer, int width, int height) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!texture) {
+        std::cerr << "Unable to create atlas page! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, texture);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    SDL_SetRenderTarget(renderer, previousTarget);
+
+    return std::make_shared<AtlasPage>(texture, width, height);
+}
+
+bool TextureAtlas::GrowPage(SDL_Renderer* renderer, AtlasPage& page) {
+    int width = page.packer.GetWidth();
+    int height = page.packer.GetHeight();
+    if (!NextPageSize(width, height)) return false;
+
+    std::shared_ptr<AtlasPage> grown = CreatePage(renderer, width, height);
+    if (!grown) return false;
+
+    SDL_FRect dest = { 0.0f, 0.0f, (float)page.packer.GetWidth(), (float)page.packer.GetHeight() };
+    CopyToTarget(renderer, page.texture, nullptr, grown->texture, dest);
+
+    // Swap the texture into the existing page so textures referencing it follow along
+    SDL_DestroyTexture(page.texture);
+    page.texture = grown->texture;
+    grown->texture = nullptr;
+    page.packer.Grow(width, height);
+    return true;
+}
+
+bool TextureAtlas::NextPageSize(int& width, int& height) const {
+    if (width >= m_maxPageSize && height >= m_maxPageSize) return false;
+
+    // Alternate: widen square pages, then make them square again
+    if (width <= height && width < m_maxPageSize) {
+        width = std::min(width * 2, m_maxPageSize);
+    } else {
+        height = std::min(height * 2, m_maxPageSize);
+    }
+    return true;
+}
+
+int TextureAtlas::InitialPageSize(int width, int height) const {
+    int size = m_initialPageSize;
+    while (size < width || size < height) {
+        size *= 2;
+    }
+    return std::min(size, m_maxPageSize);
+}
@@ -0,0 +1,412 @@
+#include "TransformHierarchy.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+static const float kDegreesToRadians = 3.14159265358979f / 180.0f;
+
+// Matrix2D Implementation
+Matrix2D Matrix2D::FromTransform(const Vector2& position, float rotation, const Vector2& scale) {
+    float radians = rotation * kDegreesToRadians;
+    float cosine = std::cos(radians);
+    float sine = std::sin(radians);
+
+    Matrix2D m;
+    m.a = cosine * scale.x;
+    m.b = sine * scale.x;
+    m.c = -sine * scale.y;
+    m.d = cosine * scale.y;
+    m.tx = position.x;
+    m.ty = position.y;
+    return m;
+}
+
+Matrix2D Matrix2D::operator*(const Matrix2D& other) const {
+    Matrix2D m;
+    m.a = a * other.a + c * other.b;
+    m.b = b * other.a + d * other.b;
+    m.c = a * other.c + c * other.d;
+    m.d = b * other.c + d * other.d;
+    m.tx = a * other.tx + c * other.ty + tx;
+    m.ty = b * other.tx + d * other.ty + ty;
+    return m;
+}
+
+Vector2 Matrix2D::TransformPoint(const Vector2& point) const {
+    return Vector2(a * point.x + c * point.y + tx, b * point.x + d * point.y + ty);
+}
+
+Matrix2D Matrix2D::Inverse() const {
+    float determinant = a * d - b * c;
+    if (determinant == 0.0f) {
+        return Matrix2D();
+    }
+
+    float inverse = 1.0f / determinant;
+    Matrix2D m;
+    m.a = d * inverse;
+    m.b = -b * inverse;
+    m.c = -c * inverse;
+    m.d = a * inverse;
+    m.tx = -(m.a * tx + m.c * ty);
+    m.ty = -(m.b * tx + m.d * ty);
+    return m;
+}
+
+float Matrix2D::GetRotation() const {
+    return std::atan2(b, a) / kDegreesToRadians;
+}
+
+Vector2 Matrix2D::GetScale() const {
+    float scaleX = std::sqrt(a * a + b * b);
+    // The determinant carries the sign of a mirrored Y axis
+    float scaleY = scaleX > 0.0f ? (a * d - b * c) / scaleX : std::sqrt(c * c + d * d);
+    return Vector2(scaleX, scaleY);
+}
+
+// TransformHierarchy Implementation
+TransformHierarchy::TransformHierarchy()
+    : m_orderDirty(false)
+    , m_firstDirty(SIZE_MAX)
+    , m_pass(0)
+    , m_frame(1)
+    , m_lastUpdateCount(0)
+{
+}
+
+TransformId TransformHierarchy::Create(void* owner) {
+    TransformId id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        id = (TransformId)m_records.size();
+        m_records.push_back(Record());
+    }
+
+    // A new root can go at the end without breaking the depth order
+    Node node;
+    node.id = id;
+    node.parent = kNoParent;
+    node.dirty = true;
+    node.resetInterpolation = true;
+    node.position = Vector2(0, 0);
+    node.rotation = 0.0f;
+    node.scale = Vector2(1, 1);
+
+    m_records[id] = { (uint32_t)m_nodes.size(), kInvalidTransform, kInvalidTransform, kInvalidTransform,
+                      kInvalidTransform, owner, true };
+    m_nodes.push_back(node);
+    m_world.push_back(Matrix2D());
+    m_previousWorld.push_back(Matrix2D());
+    m_changedPass.push_back(0);
+    m_changedFrame.push_back(0);
+    MarkDirty(m_nodes.size() - 1);
+    return id;
+}
+
+void TransformHierarchy::Destroy(TransformId id) {
+    if (!IsValid(id)) return;
+
+    if (HasChildren(id)) {
+        Update();
+        DetachChildren(id);
+    }
+    UnlinkChild(id);
+
+    // The node stays in the dense arrays until the next rebuild
+    Record& record = m_records[id];
+    record.alive = false;
+    record.owner = nullptr;
+    m_nodes[record.dense].dirty = false;
+    m_freeIds.push_back(id);
+    m_orderDirty = true;
+}
+
+bool TransformHierarchy::IsValid(TransformId id) const {
+    return id < m_records.size() && m_records[id].alive;
+}
+
+void TransformHierarchy::Clear() {
+    m_nodes.clear();
+    m_world.clear();
+    m_previousWorld.clear();
+    m_changedPass.clear();
+    m_changedFrame.clear();
+    m_records.clear();
+    m_freeIds.clear();
+    m_orderDirty = false;
+    m_firstDirty = SIZE_MAX;
+}
+
+bool TransformHierarchy::SetParent(TransformId id, TransformId parent, bool keepWorldTransform) {
+    if (!IsValid(id) || (parent != kInvalidTransform && !IsValid(parent))) return false;
+    if (m_records[id].parent == parent) return true;
+
+    for (TransformId ancestor = parent; ancestor != kInvalidTransform; ancestor = m_records[ancestor].parent) {
+        if (ancestor == id) {
+            std::cerr << "Cannot parent a transform to its own descendant" << std::endl;
+            return false;
+        }
+    }
+
+    if (keepWorldTransform) {
+        Update();
+        Matrix2D local = m_world[m_records[id].dense];
+        if (parent != kInvalidTransform) {
+            local = m_world[m_records[parent].dense].Inverse() * local;
+        }
+
+        Node& node = m_nodes[m_records[id].dense];
+        node.position = local.GetPosition();
+        node.rotation = local.GetRotation();
+        node.scale = local.GetScale();
+    }
+
+    UnlinkChild(id);
+    LinkChild(id, parent);
+    m_orderDirty = true;
+    MarkDirty(m_records[id].dense);
+    return true;
+}
+
+TransformId TransformHierarchy::GetParent(TransformId id) const {
+    return IsValid(id) ? m_records[id].parent : kInvalidTransform;
+}
+
+void TransformHierarchy::GetChildren(TransformId id, std::vector<TransformId>& outChildren) const {
+    outChildren.clear();
+    if (!IsValid(id)) return;
+
+    for (TransformId child = m_records[id].firstChild; child != kInvalidTransform;
+         child = m_records[child].nextSibling) {
+        outChildren.push_back(child);
+    }
+}
+
+bool TransformHierarchy::HasChildren(TransformId id) const {
+    return IsValid(id) && m_records[id].firstChild != kInvalidTransform;
+}
+
+void TransformHierarchy::DetachChildren(TransformId id) {
+    if (!IsValid(id)) return;
+
+    // Each child's world matrix is untouched by detaching its siblings
+    while (m_records[id].firstChild != kInvalidTransform) {
+        TransformId child = m_records[id].firstChild;
+        uint32_t dense = m_records[child].dense;
+        const Matrix2D& world = m_world[dense];
+
+        Node& node = m_nodes[dense];
+        node.position = world.GetPosition();
+        node.rotation = world.GetRotation();
+        node.scale = world.GetScale();
+
+        UnlinkChild(child);
+        MarkDirty(dense);
+    }
+    m_orderDirty = true;
+}
+
+void TransformHierarchy::LinkChild(TransformId id, TransformId parent) {
+    Record& record = m_records[id];
+    record.parent = parent;
+    if (parent == kInvalidTransform) return;
+
+    Record& parentRecord = m_records[parent];
+    record.previousSibling = kInvalidTransform;
+    record.nextSibling = parentRecord.firstChild;
+    if (parentRecord.firstChild != kInvalidTransform) {
+        m_records[parentRecord.firstChild].previousSibling = id;
+    }
+    parentRecord.firstChild = id;
+}
+
+void TransformHierarchy::UnlinkChild(TransformId id) {
+    Record& record = m_records[id];
+    if (record.parent == kInvalidTransform) return;
+
+    if (record.previousSibling != kInvalidTransform) {
+        m_records[record.previousSibling].nextSibling = record.nextSibling;
+    } else {
+        m_records[record.parent].firstChild = record.nextSibling;
+    }
+    if (record.nextSibling != kInvalidTransform) {
+        m_records[record.nextSibling].previousSibling = record.previousSibling;
+    }
+    record.parent = kInvalidTransform;
+    record.previousSibling = kInvalidTransform;
+    record.nextSibling = kInvalidTransform;
+}
+
+void* TransformHierarchy::GetOwner(TransformId id) const {
+    return IsValid(id) ? m_records[id].owner : nullptr;
+}
+
+void TransformHierarchy::SetLocal(TransformId id, const Vector2& position, float rotation, const Vector2& scale) {
+    if (IsValid(id)) {
+        SetLocalAt(m_records[id].dense, position, rotation, scale);
+    }
+}
+
+void TransformHierarchy::GetLocal(TransformId id, Vector2& position, float& rotation, Vector2& scale) const {
+    if (!IsValid(id)) return;
+
+    const Node& node = m_nodes[m_records[id].dense];
+    position = node.position;
+    rotation = node.rotation;
+    scale = node.scale;
+}
+
+const Matrix2D& TransformHierarchy::GetWorldMatrix(TransformId id) const {
+    static const Matrix2D identity;
+    return IsValid(id) ? m_world[m_records[id].dense] : identity;
+}
+
+const Matrix2D& TransformHierarchy::GetPreviousWorldMatrix(TransformId id) const {
+    static const Matrix2D identity;
+    if (!IsValid(id)) return identity;
+
+    // Unchanged this frame: no movement to interpolate
+    uint32_t dense = m_records[id].dense;
+    return m_changedFrame[dense] == m_frame ? m_previousWorld[dense] : m_world[dense];
+}
+
+void TransformHierarchy::ResetInterpolation(TransformId id) {
+    if (!IsValid(id)) return;
+
+    uint32_t dense = m_records[id].dense;
+    m_nodes[dense].resetInterpolation = true;
+    MarkDirty(dense);
+}
+
+size_t TransformHierarchy::Update() {
+    if (m_orderDirty) {
+        RebuildOrder();
+    }
+
+    m_lastUpdateCount = 0;
+    if (m_firstDirty == SIZE_MAX) return 0;
+
+    // Parents precede children, so a changed parent has always been
+    // recomputed by the time its children are visited
+    uint32_t pass = ++m_pass;
+    for (size_t i = m_firstDirty; i < m_nodes.size(); ++i) {
+        Node& node = m_nodes[i];
+        bool parentChanged = node.parent != kNoParent && m_changedPass[node.parent] == pass;
+        if (!node.dirty && !parentChanged) continue;
+
+        Matrix2D world = Matrix2D::FromTransform(node.position, node.rotation, node.scale);
+        if (node.parent != kNoParent) {
+            world = m_world[node.parent] * world;
+        }
+
+        if (m_changedFrame[i] != m_frame) {
+            m_previousWorld[i] = m_world[i];
+            m_changedFrame[i] = m_frame;
+        }
+        m_world[i] = world;
+        if (node.resetInterpolation) {
+            m_previousWorld[i] = world;
+            node.resetInterpolation = false;
+        }
+
+        m_changedPass[i] = pass;
+        node.dirty = false;
+        m_lastUpdateCount++;
+    }
+
+    m_firstDirty = SIZE_MAX;
+    return m_lastUpdateCount;
+}
+
+void* TransformHierarchy::GetOwnerAt(size_t index) const {
+    const Record& record = m_records[m_nodes[index].id];
+    return record.alive && record.dense == index ? record.owner : nullptr;
+}
+
+void TransformHierarchy::SetLocalAt(size_t index, const Vector2& position, float rotation, const Vector2& scale) {
+    Node& node = m_nodes[index];
+    if (node.position.x == position.x && node.position.y == position.y && node.rotation == rotation &&
+        node.scale.x == scale.x && node.scale.y == scale.y) {
+        return;
+    }
+
+    node.position = position;
+    node.rotation = rotation;
+    node.scale = scale;
+    MarkDirty(index);
+}
+
+void TransformHierarchy::MarkDirty(size_t index) {
+    m_nodes[index].dirty = true;
+    m_firstDirty = std::min(m_firstDirty, index);
+}
+
+void TransformHierarchy::RebuildOrder() {
+    // Depth of every live node, memoized along each walk to the root
+    std::vector<uint32_t> depths(m_records.size(), UINT32_MAX);
+    std::vector<TransformId> chain;
+    for (TransformId id = 0; id < (TransformId)m_records.size(); ++id) {
+        if (!m_records[id].alive || depths[id] != UINT32_MAX) continue;
+
+        chain.clear();
+        TransformId current = id;
+        while (current != kInvalidTransform && depths[current] == UINT32_MAX) {
+            chain.push_back(current);
+            current = m_records[current].parent;
+        }
+
+        uint32_t depth = current == kInvalidTransform ? 0 : depths[current] + 1;
+        for (size_t i = chain.size(); i > 0; --i) {
+            depths[chain[i - 1]] = depth++;
+        }
+    }
+
+    // Stable, so siblings keep their relative order between rebuilds
+    std::vector<uint32_t> order;
+    order.reserve(m_nodes.size());
+    for (uint32_t i = 0; i < (uint32_t)m_nodes.size(); ++i) {
+        const Record& record = m_records[m_nodes[i].id];
+        if (record.alive && record.dense == i) {
+            order.push_back(i);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t left, uint32_t right) {
+        return depths[m_nodes[left].id] < depths[m_nodes[right].id];
+    });
+
+    std::vector<Node> nodes(order.size());
+    std::vector<Matrix2D> world(order.size());
+    std::vector<Matrix2D> previousWorld(order.size());
+    std::vector<uint32_t> changedPass(order.size());
+    std::vector<uint32_t> changedFrame(order.size());
+    m_firstDirty = SIZE_MAX;
+
+    for (uint32_t i = 0; i < (uint32_t)order.size(); ++i) {
+        uint32_t from = order[i];
+        nodes[i] = m_nodes[from];
+        world[i] = m_world[from];
+        previousWorld[i] = m_previousWorld[from];
+        changedPass[i] = m_changedPass[from];
+        changedFrame[i] = m_changedFrame[from];
+        m_records[nodes[i].id].dense = i;
+        if (nodes[i].dirty && m_firstDirty == SIZE_MAX) {
+            m_firstDirty = i;
+        }
+    }
+
+    // Parent links as dense indices, now that every node has moved
+    for (Node& node : nodes) {
+        TransformId parent = m_records[node.id].parent;
+        node.parent = parent == kInvalidTransform ? kNoParent : m_records[parent].dense;
+    }
+
+    m_nodes.swap(nodes);
+    m_world.swap(world);
+    m_previousWorld.swap(previousWorld);
+    m_changedPass.swap(changedPass);
+    m_changedFrame.swap(changedFrame);
+    m_orderDirty = false;
+}
@@ -0,0 +1,83 @@
+#include "WavWriter.h"
+#include <cstring>
+#include <iostream>
+
+static void PutU16(uint8_t* bytes, uint32_t value) {
+    bytes[0] = (uint8_t)(value & 0xFF);
+    bytes[1] = (uint8_t)((value >> 8) & 0xFF);
+}
+
+static void PutU32(uint8_t* bytes, uint32_t value) {
+    PutU16(bytes, value & 0xFFFF);
+    PutU16(bytes + 2, value >> 16);
+}
+
+// RIFF header with a single fmt and data chunk
+static void BuildHeader(uint8_t* header, int channels, int sampleRate, uint32_t frames) {
+    uint32_t blockAlign = (uint32_t)channels * 2;
+    uint32_t dataBytes = frames * blockAlign;
+    std::memcpy(header, "RIFF", 4);
+    PutU32(header + 4, 36 + dataBytes);
+    std::memcpy(header + 8, "WAVEfmt ", 8);
+    PutU32(header + 16, 16);
+    PutU16(header + 20, 1);
+    PutU16(header + 22, (uint32_t)channels);
+    PutU32(header + 24, (uint32_t)sampleRate);
+    PutU32(header + 28, (uint32_t)sampleRate * blockAlign);
+    PutU16(header + 32, blockAlign);
+    PutU16(header + 34, 16);
+    std::memcpy(header + 36, "data", 4);
+    PutU32(header + 40, dataBytes);
+}
+
+WavWriter::WavWriter() : m_file(nullptr), m_channels(0), m_sampleRate(0), m_frames(0) {
+}
+
+WavWriter::~WavWriter() {
+    Close();
+}
+
+bool WavWriter::Open(const std::string& path, int channels, int sampleRate) {
+    Close();
+    if (channels < 1 || sampleRate <= 0) return false;
+
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        std::cerr << "Failed to create " << path << std::endl;
+        return false;
+    }
+
+    // Sizes are left at zero until Close
+    uint8_t header[44];
+    BuildHeader(header, channels, sampleRate, 0);
+    m_channels = channels;
+    m_sampleRate = sampleRate;
+    m_frames = 0;
+    if (std::fwrite(header, 1, sizeof(header), m_file) != sizeof(header)) {
+        std::cerr << "Failed to write " << path << std::endl;
+        std::fclose(m_file);
+        m_file = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool WavWriter::Write(const int16_t* samples, int frames) {
+    if (!m_file) return false;
+    // Samples go out as they are: little-endian hosts only, like AssetPack
+    size_t count = (size_t)frames * m_channels;
+    if (std::fwrite(samples, sizeof(int16_t), count, m_file) != count) return false;
+    m_frames += (uint32_t)frames;
+    return true;
+}
+
+bool WavWriter::Close() {
+    if (!m_file) return true;
+
+    uint8_t header[44];
+    BuildHeader(header, m_channels, m_sampleRate, m_frames);
+    bool ok = std::fseek(m_file, 0, SEEK_SET) == 0 && std::fwrite(header, 1, sizeof(header), m_file) == sizeof(header);
+    ok = std::fclose(m_file) == 0 && ok;
+    m_file = nullptr;
+    return ok;
+}
@@ -0,0 +1,96 @@
+// Runs the same scene of thread-safe objects that spawn, destroy and
+// deactivate during Update serially and with the parallel update on a few
+// job system sizes, and checks every run ends with the same objects, in the
+// same draw order, holding the same handles. Exits non-zero on a mismatch.
+
+#include "Scene.h"
+#include "JobSystem.h"
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+struct ObjectRecord {
+    uint64_t id;
+    uint32_t handle;
+
+    bool operator==(const ObjectRecord& other) const { return id == other.id && handle == other.handle; }
+};
+
+static std::vector<ObjectRecord>* g_drawn = nullptr;
+
+class Critter : public GameObject {
+public:
+    explicit Critter(uint64_t id) : m_id(id), m_age(0) {
+        threadSafe = true;
+    }
+
+    void Update(float deltaTime) override {
+        position.x += deltaTime;
+        m_age++;
+
+        uint64_t roll = (m_id * 2654435761u + m_age * 40503u) % 97;
+        if (roll < 3) {
+            m_scene->Destroy(GetHandle());
+        } else if (roll < 5) {
+            active = false;
+        } else if (roll < 10) {
+            m_scene->Spawn<Critter>(m_id * 8 + m_age % 8);
+        }
+    }
+
+    void Render(Renderer*) override {
+        g_drawn->push_back({ m_id, GetHandle().value });
+    }
+
+private:
+    uint64_t m_id;
+    uint64_t m_age;
+};
+
+static std::vector<ObjectRecord> RunScene(JobSystem* jobs) {
+    Scene scene;
+    if (jobs) {
+        scene.SetJobSystem(jobs);
+        scene.SetParallelUpdate(true, 16);
+    }
+    scene.SetCullingEnabled(false);
+
+    for (uint64_t id = 1; id <= 2000; ++id) {
+        scene.Spawn<Critter>(id);
+    }
+    for (int frame = 0; frame < 30; ++frame) {
+        scene.Update(1.0f / 60.0f);
+    }
+
+    std::vector<ObjectRecord> drawn;
+    g_drawn = &drawn;
+    scene.Render(nullptr);
+    g_drawn = nullptr;
+    return drawn;
+}
+
+int main() {
+    std::vector<ObjectRecord> serial = RunScene(nullptr);
+
+    int failures = 0;
+    for (int workers : { 1, 3, 7 }) {
+        JobSystem jobs(workers);
+        for (int run = 0; run < 4; ++run) {
+            std::vector<ObjectRecord> parallel = RunScene(&jobs);
+            if (parallel != serial) {
+                std::cerr << "FAILED: parallel update with " << workers << " workers (run " << run << ") ended with "
+                          << parallel.size() << " objects differing from the serial update's " << serial.size()
+                          << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    std::cout << serial.size() << " objects after 30 frames" << std::endl;
+    if (failures > 0) {
+        std::cerr << failures << " run(s) differed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
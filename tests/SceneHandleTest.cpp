@@ -0,0 +1,70 @@
+// Churns one object at a time through a Scene, far past the 4096 reuses its
+// 12-bit generation can tell apart, and checks that no stale handle ever
+// resolves to a live object. Exits non-zero on the first failure.
+
+#include "Scene.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+class Probe : public GameObject {
+};
+
+static int g_failures = 0;
+
+static void Check(bool condition, const char* what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        g_failures++;
+    }
+}
+
+int main() {
+    Scene scene;
+    const uint32_t generations = GameObjectHandle::kGenerationMask + 1;
+
+    // Bullet churn: spawn one, destroy it, repeat. Every stale handle of the
+    // first slot must stay dead however many times the slot comes around.
+    GameObjectHandle first = scene.Spawn<Probe>();
+    uint32_t hotSlot = first.GetIndex();
+    scene.Destroy(first);
+
+    // With 1024 freed slots queued ahead of it, the first slot comes round
+    // every 1025 cycles; this is enough for well over 4096 reuses
+    const uint64_t cycles = 6000000;
+    std::vector<GameObjectHandle> hotHandles;
+    uint32_t maxIndex = 0;
+    for (uint64_t cycle = 0; cycle < cycles && g_failures == 0; ++cycle) {
+        GameObjectHandle handle = scene.Spawn<Probe>();
+        Check(!handle.IsNull(), "spawn returned a null handle");
+        Check(scene.Get(handle) != nullptr, "fresh handle doesn't resolve");
+        Check(scene.Get(first) == nullptr, "first handle resolves to a later object");
+        if (handle.GetIndex() == hotSlot) {
+            for (const GameObjectHandle& stale : hotHandles) {
+                Check(stale != handle, "slot handed out a handle it issued before");
+            }
+            hotHandles.push_back(handle);
+        }
+        maxIndex = std::max(maxIndex, handle.GetIndex());
+        scene.Destroy(handle);
+        Check(scene.Get(handle) == nullptr, "destroyed handle still resolves");
+    }
+
+    // Generations 1 to 4095, then the slot retires
+    Check(hotHandles.size() == generations - 1, "slot wasn't retired when its generation wrapped");
+    for (const GameObjectHandle& stale : hotHandles) {
+        Check(scene.Get(stale) == nullptr, "stale handle of the hot slot resolves");
+    }
+
+    // Freed slots wait their turn: a single object churning doesn't pin one slot
+    Check(maxIndex > 1000, "freed slots were reused before the queue filled");
+
+    std::cout << cycles << " spawn/destroy cycles over " << maxIndex + 1 << " slots, slot " << hotSlot << " reused "
+              << hotHandles.size() << " times" << std::endl;
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
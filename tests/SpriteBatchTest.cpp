@@ -0,0 +1,131 @@
+// Draws overlapping sprites from two textures plus solid rects, once
+// directly and once through the sprite batch, and checks that both frames
+// match. Pixels on a quad's edge are skipped, since SDL_RenderGeometry may
+// rasterize edges differently from SDL_RenderTexture. Exits non-zero on a
+// mismatch.
+
+#include "Renderer.h"
+#include <SDL3/SDL.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+static const int kSize = 128;
+
+struct Draw {
+    Texture* texture; // null for a filled rect
+    Rect rect;
+    Color color;
+};
+
+static bool MakeSolidTexture(Renderer& renderer, Texture& texture, Uint8 r, Uint8 g, Uint8 b) {
+    SDL_Surface* surface = SDL_CreateSurface(32, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) return false;
+    SDL_FillSurfaceRect(surface, nullptr, SDL_MapSurfaceRGBA(surface, r, g, b, 255));
+    bool loaded = texture.LoadFromSurface(renderer.GetSDLRenderer(), surface);
+    SDL_DestroySurface(surface);
+    return loaded;
+}
+
+static SDL_Surface* RenderFrame(Renderer& renderer, const std::vector<Draw>& draws, bool batched) {
+    renderer.Clear(Color(0, 0, 0, 255));
+    renderer.SetBatchingEnabled(batched);
+    for (const Draw& draw : draws) {
+        if (draw.texture) {
+            renderer.DrawTexture(draw.texture, draw.rect);
+        } else {
+            renderer.DrawRect(draw.rect, draw.color);
+        }
+    }
+    renderer.SetBatchingEnabled(false);
+    return SDL_RenderReadPixels(renderer.GetSDLRenderer(), nullptr);
+}
+
+static bool OnQuadEdge(const std::vector<Draw>& draws, int x, int y) {
+    for (const Draw& draw : draws) {
+        float left = draw.rect.x, top = draw.rect.y;
+        float right = left + draw.rect.width, bottom = top + draw.rect.height;
+        bool insideX = x >= left - 1 && x <= right;
+        bool insideY = y >= top - 1 && y <= bottom;
+        if (insideX && (std::fabs(y - top) <= 1 || std::fabs(y - bottom) <= 1)) return true;
+        if (insideY && (std::fabs(x - left) <= 1 || std::fabs(x - right) <= 1)) return true;
+    }
+    return false;
+}
+
+int main() {
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        std::cerr << "SDL_Init failed: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    SDL_Window* window = SDL_CreateWindow("SpriteBatchTest", kSize, kSize, 0);
+    if (!window) {
+        std::cerr << "SDL_CreateWindow failed: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    {
+        Renderer renderer;
+        Texture green, blue;
+        if (!renderer.Initialize(window) || !MakeSolidTexture(renderer, green, 0, 255, 0) ||
+            !MakeSolidTexture(renderer, blue, 0, 0, 255)) {
+            SDL_DestroyWindow(window);
+            SDL_Quit();
+            return 1;
+        }
+
+        // Textures interleave and overlap, and rects land both above and
+        // below sprites, all at the default depth
+        std::vector<Draw> draws = {
+            { &green, Rect(10, 10, 40, 40), Color() },
+            { &blue, Rect(30, 30, 40, 40), Color() },
+            { &green, Rect(50, 50, 40, 40), Color() },
+            { nullptr, Rect(40, 40, 30, 30), Color(255, 0, 0, 255) },
+            { &blue, Rect(60, 60, 40, 40), Color() },
+            { nullptr, Rect(90, 5, 30, 100), Color(255, 255, 0, 255) },
+            { &green, Rect(80, 20, 30, 30), Color() },
+        };
+
+        SDL_Surface* direct = RenderFrame(renderer, draws, false);
+        SDL_Surface* batched = RenderFrame(renderer, draws, true);
+        if (!direct || !batched) {
+            std::cerr << "SDL_RenderReadPixels failed: " << SDL_GetError() << std::endl;
+            failures++;
+        } else {
+            int compared = 0;
+            for (int y = 0; y < kSize; ++y) {
+                for (int x = 0; x < kSize; ++x) {
+                    if (OnQuadEdge(draws, x, y)) continue;
+                    Uint8 r0, g0, b0, a0, r1, g1, b1, a1;
+                    SDL_ReadSurfacePixel(direct, x, y, &r0, &g0, &b0, &a0);
+                    SDL_ReadSurfacePixel(batched, x, y, &r1, &g1, &b1, &a1);
+                    compared++;
+                    if (r0 != r1 || g0 != g1 || b0 != b1) {
+                        if (failures < 8) {
+                            std::cerr << "FAILED: pixel " << x << "," << y << " is (" << (int)r1 << "," << (int)g1
+                                      << "," << (int)b1 << ") batched, (" << (int)r0 << "," << (int)g0 << ","
+                                      << (int)b0 << ") direct" << std::endl;
+                        }
+                        failures++;
+                    }
+                }
+            }
+            std::cout << compared << " pixels compared, " << renderer.GetSpriteBatch().GetLastFlushStats().drawCalls
+                      << " draw calls for " << draws.size() << " draws" << std::endl;
+        }
+        SDL_DestroySurface(direct);
+        SDL_DestroySurface(batched);
+    }
+
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+
+    if (failures > 0) {
+        std::cerr << failures << " pixel(s) differ" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,163 @@
+// Builds an asset pack from a project's assets/ directory.
+// Images are stored pre-decoded as RGBA32 and WAV files as float PCM at
+// the device rate unless --raw is given, so the runtime can upload or mix
+// them straight from the mapped file.
+// Usage: AssetPacker <projectDir> [output.pak] [--raw] [--audio-rate <hz>]
+
+#include "AssetPack.h"
+#include "Resampler.h"
+#include <SDL3/SDL.h>
+#ifdef HAVE_SDL3_IMAGE
+#include <SDL3_image/SDL_image.h>
+#endif
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool IsImageFile(const fs::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+#ifdef HAVE_SDL3_IMAGE
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" ||
+           extension == ".bmp" || extension == ".tga" || extension == ".gif";
+#else
+    return extension == ".bmp";
+#endif
+}
+
+static bool AddDecodedImage(AssetPackWriter& writer, const std::string& name, const fs::path& path) {
+#ifdef HAVE_SDL3_IMAGE
+    SDL_Surface* surface = IMG_Load(path.string().c_str());
+#else
+    SDL_Surface* surface = SDL_LoadBMP(path.string().c_str());
+#endif
+    if (!surface) {
+        return false;
+    }
+
+    SDL_Surface* rgba = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+    SDL_DestroySurface(surface);
+    if (!rgba) {
+        return false;
+    }
+
+    // Drop any row padding
+    std::vector<uint8_t> pixels((size_t)rgba->w * rgba->h * 4);
+    for (int y = 0; y < rgba->h; ++y) {
+        const uint8_t* row = (const uint8_t*)rgba->pixels + (size_t)y * rgba->pitch;
+        std::copy(row, row + (size_t)rgba->w * 4, pixels.begin() + (size_t)y * rgba->w * 4);
+    }
+    writer.AddImage(name, rgba->w, rgba->h, pixels.data());
+    SDL_DestroySurface(rgba);
+    return true;
+}
+
+static bool IsSoundFile(const fs::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return extension == ".wav";
+}
+
+// Same conversion Sound does at load time, done once here instead
+static bool AddConvertedSound(AssetPackWriter& writer, const std::string& name, const fs::path& path,
+                              int sampleRate) {
+    SDL_AudioSpec spec;
+    Uint8* wav = nullptr;
+    Uint32 wavLength = 0;
+    if (!SDL_LoadWAV(path.string().c_str(), &spec, &wav, &wavLength)) {
+        return false;
+    }
+
+    SDL_AudioSpec target;
+    target.format = SDL_AUDIO_F32;
+    target.channels = spec.channels > 1 ? 2 : 1;
+    target.freq = spec.freq;
+    Uint8* converted = nullptr;
+    int convertedLength = 0;
+    bool ok = SDL_ConvertAudioSamples(&spec, wav, (int)wavLength, &target, &converted, &convertedLength);
+    SDL_free(wav);
+    if (!ok) {
+        return false;
+    }
+
+    std::vector<float> samples;
+    Resampler resampler(spec.freq, sampleRate);
+    resampler.Process((const float*)converted, convertedLength / (int)(sizeof(float) * target.channels),
+                      target.channels, samples);
+    SDL_free(converted);
+    writer.AddAudio(name, sampleRate, target.channels, samples.data(), (int)(samples.size() / target.channels));
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> arguments;
+    bool raw = false;
+    int audioRate = 48000;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--raw") {
+            raw = true;
+        } else if (argument == "--audio-rate" && i + 1 < argc) {
+            audioRate = std::max(1, std::atoi(argv[++i]));
+        } else {
+            arguments.push_back(argument);
+        }
+    }
+
+    if (arguments.empty()) {
+        std::cerr << "Usage: AssetPacker <projectDir> [output.pak] [--raw] [--audio-rate <hz>]" << std::endl;
+        return 1;
+    }
+
+    fs::path projectPath = arguments[0];
+    fs::path assetsPath = projectPath / "assets";
+    fs::path outputPath = arguments.size() > 1 ? fs::path(arguments[1]) : projectPath / "assets.pak";
+
+    if (!fs::is_directory(assetsPath)) {
+        std::cerr << "No assets directory in " << projectPath << std::endl;
+        return 1;
+    }
+
+    // Sorted so the same tree always produces the same pack
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::recursive_directory_iterator(assetsPath)) {
+        if (entry.is_regular_file()) {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    AssetPackWriter writer;
+    int decoded = 0;
+    int converted = 0;
+    for (const auto& file : files) {
+        // Same names the game passes to LoadTexture/LoadSound: "assets/..."
+        std::string name = fs::relative(file, projectPath).generic_string();
+
+        if (!raw && IsImageFile(file) && AddDecodedImage(writer, name, file)) {
+            decoded++;
+            continue;
+        }
+        if (!raw && IsSoundFile(file) && AddConvertedSound(writer, name, file, audioRate)) {
+            converted++;
+            continue;
+        }
+        if (!writer.AddFile(name, file.string())) {
+            return 1;
+        }
+    }
+
+    if (!writer.Write(outputPath.string())) {
+        return 1;
+    }
+
+    std::cout << "Packed " << writer.GetEntryCount() << " assets (" << decoded << " pre-decoded images, " << converted
+              << " sounds at " << audioRate << " Hz) into " << outputPath.string() << " (" << fs::file_size(outputPath) << " bytes)" << std::endl;
+    return 0;
+}